@@ -0,0 +1,385 @@
+#ifndef AJUSTE_H
+#define AJUSTE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "medicion.h"
+
+// Ajuste automático de los bucles paralelos: para cada kernel y tamaño de entrada
+// busca el número de hilos, la planificación (static/dynamic/guided), el tamaño
+// de bloque y la afinidad que dan la menor mediana, y lo guarda en una caché en
+// disco. En ejecuciones posteriores la configuración se lee de la caché y se
+// aplica sin volver a medir. Las claves incluyen los hilos disponibles y el
+// número de lugares (OMP_PLACES), así que una caché de otra máquina o de otro
+// OMP_NUM_THREADS no se aplica
+
+// Mejora relativa mínima para cambiar de configuración durante la búsqueda: las
+// diferencias menores suelen ser ruido de medición
+const double MEJORA_MINIMA_AJUSTE = 0.03;
+
+// Afinidad de los hilos del equipo: la cláusula proc_bind de la región. Solo
+// tiene efecto si el runtime tiene lugares definidos (OMP_PLACES); Entorno deja
+// la política de OMP_PROC_BIND
+enum class Afinidad { Entorno, Cerca, Dispersa };
+
+inline const char* nombreAfinidad(Afinidad afinidad) {
+    switch (afinidad) {
+        case Afinidad::Entorno: return "entorno";
+        case Afinidad::Cerca: return "close";
+        case Afinidad::Dispersa: return "spread";
+    }
+    return "entorno";
+}
+
+// Planificación "entorno": no se llama a omp_set_schedule, así que los bucles
+// con schedule(runtime) siguen OMP_SCHEDULE o, sin él, el valor por defecto del
+// runtime (dynamic,1 en libgomp). Ningún omp_sched_t vale 0
+const omp_sched_t PLANIFICACION_ENTORNO = static_cast<omp_sched_t>(0);
+
+inline const char* nombrePlanificacion(omp_sched_t planificacion) {
+    if (planificacion == PLANIFICACION_ENTORNO) return "entorno";
+    switch (planificacion & ~omp_sched_monotonic) {
+        case omp_sched_static: return "static";
+        case omp_sched_dynamic: return "dynamic";
+        case omp_sched_guided: return "guided";
+        case omp_sched_auto: return "auto";
+        default: return "static";
+    }
+}
+
+// Configuración de un bucle ajustable. La configuración por defecto no cambia
+// nada: todos los hilos, la planificación del entorno (bloque ignorado) y la
+// afinidad del entorno. La planificación se aplica a los bucles con schedule(runtime)
+struct ConfiguracionParalela {
+    int hilos = 0;
+    omp_sched_t planificacion = PLANIFICACION_ENTORNO;
+    int bloque = 0;
+    Afinidad afinidad = Afinidad::Entorno;
+
+    bool porDefecto() const {
+        return hilos == 0 && planificacion == PLANIFICACION_ENTORNO && afinidad == Afinidad::Entorno;
+    }
+
+    std::string describir() const {
+        std::ostringstream texto;
+        texto << "hilos=" << (hilos > 0 ? std::to_string(hilos) : std::string("todos")) << " "
+              << nombrePlanificacion(planificacion);
+        if (planificacion != PLANIFICACION_ENTORNO) texto << "," << bloque;
+        texto << " proc_bind=" << nombreAfinidad(afinidad);
+        return texto.str();
+    }
+};
+
+// Dimensiones que se pueden ajustar en un kernel: los que abren su propia región
+// con schedule(static) (los de la biblioteca) solo admiten el número de hilos
+struct EspacioAjuste {
+    bool planificacion;
+    bool afinidad;
+
+    static EspacioAjuste soloHilos() { return EspacioAjuste{false, false}; }
+    static EspacioAjuste completo() { return EspacioAjuste{true, true}; }
+};
+
+// Aplica una configuración mientras vive el objeto y restaura después el número
+// de hilos y la planificación anteriores. El número de hilos ajustado actúa como
+// tope: con --barrido el arnés puede pedir menos
+class AplicacionAjuste {
+private:
+    int hilosPrevios;
+    omp_sched_t planificacionPrevia;
+    int bloquePrevio;
+
+public:
+    explicit AplicacionAjuste(const ConfiguracionParalela& configuracion) : hilosPrevios(omp_get_max_threads()) {
+        omp_get_schedule(&planificacionPrevia, &bloquePrevio);
+        if (configuracion.hilos > 0) omp_set_num_threads(std::min(configuracion.hilos, hilosPrevios));
+        if (configuracion.planificacion != PLANIFICACION_ENTORNO) {
+            omp_set_schedule(configuracion.planificacion, configuracion.bloque);
+        }
+    }
+    AplicacionAjuste(const AplicacionAjuste&) = delete;
+    AplicacionAjuste& operator=(const AplicacionAjuste&) = delete;
+
+    ~AplicacionAjuste() {
+        omp_set_num_threads(hilosPrevios);
+        omp_set_schedule(planificacionPrevia, bloquePrevio);
+    }
+};
+
+// Abre una región paralela con la afinidad de la configuración (y sus hilos y
+// planificación); cuerpo la ejecuta cada hilo del equipo y reparte su bucle con
+// un "#pragma omp for schedule(runtime)" huérfano
+template <typename Cuerpo>
+void paraleloAjustado(const ConfiguracionParalela& configuracion, const Cuerpo& cuerpo) {
+    AplicacionAjuste aplicacion(configuracion);
+    switch (configuracion.afinidad) {
+        case Afinidad::Cerca:
+            // Justificación: Hilos en lugares contiguos al del hilo principal: comparten
+            // caché cuando los datos caben en ella
+            #pragma omp parallel proc_bind(close)
+            cuerpo();
+            break;
+        case Afinidad::Dispersa:
+            // Justificación: Hilos repartidos por todos los lugares: suma el ancho de
+            // banda de todos los controladores de memoria
+            #pragma omp parallel proc_bind(spread)
+            cuerpo();
+            break;
+        default:
+            #pragma omp parallel
+            cuerpo();
+            break;
+    }
+}
+
+// Caché de configuraciones en un archivo de texto, una entrada por línea:
+//   <clave> <hilos> <planificacion> <bloque> <afinidad> <mediana_ms>
+// Las líneas que empiezan por '#' son comentarios
+class CacheAjuste {
+public:
+    struct Entrada {
+        std::string clave;
+        ConfiguracionParalela configuracion;
+        double mediana;
+    };
+
+    explicit CacheAjuste(const std::string& r) : ruta(r) {}
+
+    // Lee el archivo; si no existe la caché queda vacía. Las líneas mal formadas
+    // se descartan con un aviso
+    void cargar() {
+        entradas.clear();
+        std::ifstream archivo(ruta);
+        std::string linea;
+        while (std::getline(archivo, linea)) {
+            if (linea.empty() || linea[0] == '#') continue;
+            std::istringstream campos(linea);
+            Entrada entrada;
+            std::string planificacion, afinidad;
+            campos >> entrada.clave >> entrada.configuracion.hilos >> planificacion >> entrada.configuracion.bloque >>
+                afinidad >> entrada.mediana;
+            if (!campos || !planificacionDesdeNombre(planificacion, entrada.configuracion.planificacion) ||
+                !afinidadDesdeNombre(afinidad, entrada.configuracion.afinidad)) {
+                std::cerr << "Entrada de " << ruta << " no válida, se ignora: " << linea << std::endl;
+                continue;
+            }
+            entradas.push_back(entrada);
+        }
+    }
+
+    const Entrada* buscar(const std::string& clave) const {
+        for (const Entrada& entrada : entradas) {
+            if (entrada.clave == clave) return &entrada;
+        }
+        return nullptr;
+    }
+
+    // Añade o sustituye la entrada y reescribe el archivo completo (primero en
+    // un temporal que después se renombra). Devuelve false si no se pudo escribir
+    bool guardar(const Entrada& nueva) {
+        bool sustituida = false;
+        for (Entrada& entrada : entradas) {
+            if (entrada.clave == nueva.clave) {
+                entrada = nueva;
+                sustituida = true;
+            }
+        }
+        if (!sustituida) entradas.push_back(nueva);
+
+        const std::string temporal = ruta + ".tmp";
+        {
+            std::ofstream archivo(temporal);
+            archivo << "# clave hilos planificacion bloque afinidad mediana_ms\n";
+            for (const Entrada& entrada : entradas) {
+                const ConfiguracionParalela& c = entrada.configuracion;
+                archivo << entrada.clave << " " << c.hilos << " " << nombrePlanificacion(c.planificacion) << " "
+                        << c.bloque << " " << nombreAfinidad(c.afinidad) << " " << entrada.mediana << "\n";
+            }
+            if (!archivo) {
+                std::cerr << "No se pudo escribir " << temporal << std::endl;
+                return false;
+            }
+        }
+        if (std::rename(temporal.c_str(), ruta.c_str()) != 0) {
+            std::cerr << "No se pudo sustituir " << ruta << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::string ruta;
+    std::vector<Entrada> entradas;
+
+    static bool planificacionDesdeNombre(const std::string& nombre, omp_sched_t& planificacion) {
+        const omp_sched_t todas[] = {PLANIFICACION_ENTORNO, omp_sched_static, omp_sched_dynamic, omp_sched_guided,
+                                     omp_sched_auto};
+        for (omp_sched_t p : todas) {
+            if (nombre == nombrePlanificacion(p)) {
+                planificacion = p;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool afinidadDesdeNombre(const std::string& nombre, Afinidad& afinidad) {
+        const Afinidad todas[] = {Afinidad::Entorno, Afinidad::Cerca, Afinidad::Dispersa};
+        for (Afinidad a : todas) {
+            if (nombre == nombreAfinidad(a)) {
+                afinidad = a;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Ajustador de los kernels de un programa. configurar() devuelve la configuración
+// guardada para el kernel y el tamaño; con --ajustar la busca midiendo y la
+// guarda (sustituyendo la anterior). Sin entrada y sin --ajustar devuelve la
+// configuración por defecto, que respeta el entorno (OMP_SCHEDULE, OMP_PROC_BIND)
+// y es también la referencia del informe de mejora.
+// La búsqueda es por coordenadas para acotar las mediciones: primero el número
+// de hilos con la planificación del entorno, después la planificación y el bloque
+// con esos hilos, y por último la afinidad (solo si hay más de un lugar)
+class AjustadorParalelo {
+public:
+    using Kernel = std::function<void(const ConfiguracionParalela&)>;
+
+    AjustadorParalelo(const std::string& nombrePrograma, const OpcionesMedicion& o)
+        : programa(nombrePrograma), opciones(o), cache(o.archivoAjuste), hilosMaximos(omp_get_max_threads()) {
+        cache.cargar();
+    }
+
+    // iteraciones: iteraciones del bucle ajustable, para elegir los bloques candidatos
+    ConfiguracionParalela configurar(const std::string& kernel, size_t iteraciones, EspacioAjuste espacio,
+                                     const Kernel& ejecutar) {
+        const std::string clave = construirClave(kernel, iteraciones);
+        const CacheAjuste::Entrada* guardada = cache.buscar(clave);
+        if (guardada && !opciones.ajustar) {
+            std::cout << "Configuración ajustada de '" << kernel << "' (" << opciones.archivoAjuste
+                      << "): " << guardada->configuracion.describir() << std::endl;
+            return guardada->configuracion;
+        }
+        if (!opciones.ajustar) return ConfiguracionParalela();
+
+        std::cout << "Ajustando '" << kernel << "' (" << iteraciones << " iteraciones, tiempos en ms):" << std::endl;
+        ConfiguracionParalela mejor;
+        double mejorTiempo = medir(ejecutar, mejor);
+        const double tiempoPorDefecto = mejorTiempo;
+        auto probar = [&](const ConfiguracionParalela& candidata) {
+            double tiempo = medir(ejecutar, candidata);
+            if (tiempo < mejorTiempo * (1.0 - MEJORA_MINIMA_AJUSTE)) {
+                mejorTiempo = tiempo;
+                mejor = candidata;
+            }
+        };
+
+        // 1. Número de hilos: potencias de dos y el máximo
+        const ConfiguracionParalela porDefecto = mejor;
+        for (int h = 1; h < hilosMaximos; h *= 2) {
+            ConfiguracionParalela candidata = porDefecto;
+            candidata.hilos = h;
+            probar(candidata);
+        }
+
+        // 2. Planificación y bloque con los hilos elegidos
+        if (espacio.planificacion) {
+            const ConfiguracionParalela base = mejor;
+            const size_t hilos = static_cast<size_t>(base.hilos > 0 ? base.hilos : hilosMaximos);
+            const omp_sched_t planificaciones[] = {omp_sched_static, omp_sched_dynamic, omp_sched_guided};
+            for (omp_sched_t planificacion : planificaciones) {
+                for (int bloque : bloquesCandidatos(iteraciones, hilos, planificacion)) {
+                    ConfiguracionParalela candidata = base;
+                    candidata.planificacion = planificacion;
+                    candidata.bloque = bloque;
+                    if (candidata.planificacion == base.planificacion && candidata.bloque == base.bloque) continue;
+                    probar(candidata);
+                }
+            }
+        }
+
+        // 3. Afinidad: sin lugares definidos proc_bind no cambia nada
+        if (espacio.afinidad) {
+            if (omp_get_num_places() > 1) {
+                const ConfiguracionParalela base = mejor;
+                for (Afinidad afinidad : {Afinidad::Cerca, Afinidad::Dispersa}) {
+                    ConfiguracionParalela candidata = base;
+                    candidata.afinidad = afinidad;
+                    probar(candidata);
+                }
+            } else {
+                std::cout << "  (afinidad sin ajustar: el runtime no tiene lugares; use OMP_PLACES=cores)" << std::endl;
+            }
+        }
+
+        std::ostringstream linea;
+        linea << "  Elegida: " << mejor.describir() << " (" << std::fixed << std::setprecision(3) << mejorTiempo
+              << " ms, " << std::setprecision(2) << cocienteTiempos(tiempoPorDefecto, mejorTiempo)
+              << "x respecto a la configuración por defecto)";
+        std::cout << linea.str() << std::endl;
+        cache.guardar(CacheAjuste::Entrada{clave, mejor, mejorTiempo});
+        return mejor;
+    }
+
+private:
+    std::string programa;
+    OpcionesMedicion opciones;
+    CacheAjuste cache;
+    int hilosMaximos;
+
+    // Clave de la caché: programa, kernel, tamaño redondeado a la potencia de dos
+    // más próxima, hilos disponibles y lugares
+    std::string construirClave(const std::string& kernel, size_t iteraciones) const {
+        std::string nombre = kernel;
+        std::replace(nombre.begin(), nombre.end(), ' ', '_');
+        const int exponente = iteraciones > 0 ? static_cast<int>(std::lround(std::log2(static_cast<double>(iteraciones)))) : 0;
+        return programa + "/" + nombre + "/n=2^" + std::to_string(exponente) + "/hilos=" +
+               std::to_string(hilosMaximos) + "/lugares=" + std::to_string(omp_get_num_places());
+    }
+
+    // Bloques candidatos: fracciones del reparto por hilo (1/4 .. 1/256) y, salvo
+    // con dynamic (bloque 1 por defecto), el valor por defecto del runtime
+    static std::vector<int> bloquesCandidatos(size_t iteraciones, size_t hilos, omp_sched_t planificacion) {
+        std::vector<int> bloques;
+        if (planificacion != omp_sched_dynamic) bloques.push_back(0);
+        for (size_t divisor : {4, 16, 64, 256}) {
+            size_t bloque = std::max<size_t>(iteraciones / (hilos * divisor), 1);
+            int valor = static_cast<int>(std::min<size_t>(bloque, 1 << 30));
+            if (std::find(bloques.begin(), bloques.end(), valor) == bloques.end()) bloques.push_back(valor);
+        }
+        return bloques;
+    }
+
+    // Mediana de las repeticiones (tras el calentamiento) con la configuración dada
+    double medir(const Kernel& ejecutar, const ConfiguracionParalela& configuracion) const {
+        for (int i = 0; i < opciones.calentamiento; ++i) ejecutar(configuracion);
+        std::vector<double> tiempos;
+        for (int i = 0; i < opciones.repeticiones; ++i) {
+            auto inicio = std::chrono::steady_clock::now();
+            ejecutar(configuracion);
+            auto fin = std::chrono::steady_clock::now();
+            tiempos.push_back(std::chrono::duration<double, std::milli>(fin - inicio).count());
+        }
+        const double mediana = calcularEstadisticas(tiempos).mediana;
+        // Formatea en un flujo local para no alterar la precisión de std::cout
+        std::ostringstream linea;
+        linea << "  " << std::left << std::setw(44) << configuracion.describir() << std::right << std::fixed
+              << std::setprecision(3) << std::setw(12) << mediana;
+        std::cout << linea.str() << std::endl;
+        return mediana;
+    }
+};
+
+#endif
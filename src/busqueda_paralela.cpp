@@ -1,35 +1,91 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
-#include <random>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
 #include <omp.h>
+#include "medicion.h"
+#include "nucleos/busqueda.h"
+#include "nucleos/generacion.h"
+
+// Backend de índice seleccionable para las consultas repetidas
+enum class TipoIndice { Eytzinger, Hash };
 
 class BuscadorParalelo {
 private:
-    std::vector<int> array;
+    VectorNuma<int> array;   // Sin inicializar: la primera escritura es la del generador
     size_t tamano;
     int objetivo;
+    bool objetivoFijado;   // Si es verdadero, el objetivo lo indica el usuario
 
-    // Inicializa el array con valores aleatorios y establece el objetivo
-    void inicializarArray() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(1, 100000000);
+    // Índices para consultas repetidas (se construyen bajo demanda)
+    TipoIndice tipoIndice = TipoIndice::Eytzinger;
+    bool usarBloom = false;
+    IndiceEytzinger indiceEytzinger;
+    IndiceHash indiceHash;
+    FiltroBloom filtroBloom;
+    bool eytzingerConstruido = false, hashConstruido = false, bloomConstruido = false;
 
-        for (auto& elemento : array) {
-            elemento = dis(gen);
+    // Resuelve un grupo de hasta GRUPO_INTERCALADO consultas: el filtro de Bloom
+    // (si está activo) descarta primero las ausentes y solo las restantes llegan al índice
+    void buscarGrupo(const int* objetivos, size_t g, int* resultados) const {
+        int candidatos[GRUPO_INTERCALADO];
+        int resultadosCandidatos[GRUPO_INTERCALADO];
+        size_t posiciones[GRUPO_INTERCALADO];
+        size_t numCandidatos = 0;
+        if (usarBloom) {
+            for (size_t q = 0; q < g; ++q) {
+                __builtin_prefetch(filtroBloom.direccion(objetivos[q]));
+            }
+            for (size_t q = 0; q < g; ++q) {
+                resultados[q] = -1;
+                if (filtroBloom.puedeContener(objetivos[q])) {
+                    posiciones[numCandidatos] = q;
+                    candidatos[numCandidatos++] = objetivos[q];
+                }
+            }
+        } else {
+            for (size_t q = 0; q < g; ++q) {
+                posiciones[q] = q;
+                candidatos[q] = objetivos[q];
+            }
+            numCandidatos = g;
+        }
+        if (tipoIndice == TipoIndice::Eytzinger) {
+            indiceEytzinger.buscarGrupo(candidatos, numCandidatos, resultadosCandidatos);
+        } else {
+            indiceHash.buscarGrupo(candidatos, numCandidatos, resultadosCandidatos);
+        }
+        for (size_t c = 0; c < numCandidatos; ++c) {
+            resultados[posiciones[c]] = resultadosCandidatos[c];
+        }
+    }
+
+    // Genera el array en paralelo con valores uniformes en [1, 1e8] y, si no
+    // está fijado, deriva el objetivo de la misma semilla (otro subflujo)
+    void inicializarArray(uint64_t semilla) {
+        generarUniforme(vista(array), 1, 100000000, semilla);
+        if (!objetivoFijado) {
+            FlujoPhilox flujo(semilla, 1);
+            double u;
+            flujo.uniformes(&u, 1);
+            objetivo = 1 + static_cast<int>(u * 100000000);
         }
-        // Asegurarse de que el objetivo esté en el array
-        //size_t indice_objetivo = tamano / 2;
-        //objetivo = array[indice_objetivo];
-        objetivo = dis(gen);
         std::cout << "Elemento a buscar: " << objetivo << std::endl;
     }
 
 public:
-    // Constructor: inicializa el array con un tamaño dado
-    BuscadorParalelo(size_t t) : tamano(t), array(t) {
-        inicializarArray();
+    // Constructor: genera el array de un tamaño dado a partir de la semilla
+    BuscadorParalelo(size_t t, uint64_t semilla) : array(t), tamano(t), objetivo(0), objetivoFijado(false) {
+        inicializarArray(semilla);
+    }
+
+    // Constructor con objetivo fijado por el usuario
+    BuscadorParalelo(size_t t, uint64_t semilla, int o)
+        : array(t), tamano(t), objetivo(o), objetivoFijado(true) {
+        inicializarArray(semilla);
     }
 
     // Método de búsqueda secuencial tradicional
@@ -42,66 +98,213 @@ public:
         return -1; // Retorna -1 si no se encuentra el elemento
     }
 
-    // Método de búsqueda paralela usando OpenMP
+    // Búsqueda paralela del objetivo configurado
     int buscarParalelo() {
-        int indice_encontrado = -1;
-        bool encontrado = false;
-
-        // Crea un equipo de hilos
-        #pragma omp parallel
-        {
-            // Distribuye las iteraciones del bucle entre los hilos
-            // Justificación: Permite que múltiples hilos busquen en diferentes partes del array simultáneamente
-            #pragma omp for
-            for (size_t i = 0; i < tamano; ++i) {
-                // Si ya se encontró el elemento, los demás hilos pueden terminar
-                if (encontrado) continue;
-                if (array[i] == objetivo) {
-                    // Sección crítica para actualizar las variables compartidas
-                    // Justificación: Evita condiciones de carrera al actualizar 'encontrado' e 'indice_encontrado'
-                    #pragma omp critical
-                    {
-                        if (!encontrado) {
-                            encontrado = true;
-                            indice_encontrado = i;
-                        }
-                    }
-                }
-            }
+        return buscarParalelo(objetivo);
+    }
+
+    // Búsqueda paralela con el núcleo de la biblioteca: devuelve la primera
+    // aparición, igual que buscarSecuencial
+    int buscarParalelo(int valor) {
+        size_t indice = buscarPrimero(vista(array), valor);
+        return indice < tamano ? static_cast<int>(indice) : -1;
+    }
+
+    // Número de apariciones del objetivo (recorre siempre todo el array)
+    size_t contarParalelo() {
+        return contar(vista(array), objetivo);
+    }
+
+    // Todos los índices donde aparece el objetivo, en orden creciente
+    std::vector<size_t> buscarTodos() {
+        return ::buscarTodos(vista(array), objetivo);
+    }
+
+    // Selecciona el índice (y el filtro de Bloom si se pide) y lo construye si aún
+    // no existe; el array no cambia, así que cada estructura se construye una vez.
+    // Devuelve false si el array supera el tamaño que admiten los índices
+    bool construirIndice(TipoIndice tipo, bool conBloom) {
+        tipoIndice = tipo;
+        usarBloom = conBloom;
+        if (tipo == TipoIndice::Eytzinger && !eytzingerConstruido) {
+            if (!indiceEytzinger.construir(array)) return false;
+            eytzingerConstruido = true;
         }
+        if (tipo == TipoIndice::Hash && !hashConstruido) {
+            if (!indiceHash.construir(array)) return false;
+            hashConstruido = true;
+        }
+        if (conBloom && !bloomConstruido) {
+            filtroBloom.construir(array);
+            bloomConstruido = true;
+        }
+        return true;
+    }
 
-        return indice_encontrado;
+    // Consulta individual sobre el índice construido: primera aparición o -1
+    int buscarIndexado(int valor) const {
+        if (usarBloom && !filtroBloom.puedeContener(valor)) return -1;
+        return tipoIndice == TipoIndice::Eytzinger ? indiceEytzinger.buscar(valor) : indiceHash.buscar(valor);
     }
 
-    // Método para ejecutar y comparar las versiones secuencial y paralela
-    void ejecutar() {
-        // Ejecución y medición del tiempo para la versión secuencial
+    // Consultas por lotes: los grupos se reparten entre los hilos y dentro de
+    // cada grupo las búsquedas se intercalan con precarga
+    void buscarLote(const int* objetivos, size_t numConsultas, int* resultados) const {
+        const size_t numGrupos = (numConsultas + GRUPO_INTERCALADO - 1) / GRUPO_INTERCALADO;
+        // Justificación: Las consultas son independientes y de coste similar
+        #pragma omp parallel for schedule(static)
+        for (size_t grupo = 0; grupo < numGrupos; ++grupo) {
+            const size_t inicio = grupo * GRUPO_INTERCALADO;
+            buscarGrupo(objetivos + inicio, std::min(GRUPO_INTERCALADO, numConsultas - inicio), resultados + inicio);
+        }
+    }
+
+    // Compara los backends de índice con numConsultas consultas (la mitad tomadas
+    // del array y la otra mitad aleatorias, en su mayoría ausentes). Las consultas
+    // salen de otro subflujo de la semilla de los datos
+    bool compararIndices(size_t numConsultas, uint64_t semilla) {
+        std::vector<double> u(numConsultas);
+        FlujoPhilox flujo(semilla, 2);
+        flujo.uniformes(u.data(), numConsultas);
+        std::vector<int> consultas(numConsultas);
+        for (size_t q = 0; q < numConsultas; ++q) {
+            consultas[q] = (q % 2 == 0) ? array[std::min(static_cast<size_t>(u[q] * tamano), tamano - 1)]
+                                        : 1 + static_cast<int>(u[q] * 100000000);
+        }
+
+        // Referencia: escaneo lineal de unas pocas consultas
+        const size_t muestras = std::min<size_t>(numConsultas, 8);
+        std::vector<int> referencia(muestras);
         auto inicio = std::chrono::high_resolution_clock::now();
-        int resultadoSecuencial = buscarSecuencial();
+        for (size_t q = 0; q < muestras; ++q) {
+            referencia[q] = buscarParalelo(consultas[q]);
+        }
         auto fin = std::chrono::high_resolution_clock::now();
-        auto duracionSecuencial = std::chrono::duration_cast<std::chrono::microseconds>(fin - inicio).count();
+        double usEscaneo = std::chrono::duration<double, std::micro>(fin - inicio).count() / std::max<size_t>(muestras, 1);
+        std::cout << "Tamaño del array: " << tamano << ", consultas: " << numConsultas << std::endl;
+        std::cout << "Escaneo lineal: " << usEscaneo << " microsegundos por consulta" << std::endl;
 
-        // Ejecución y medición del tiempo para la versión paralela
-        inicio = std::chrono::high_resolution_clock::now();
-        int resultadoParalelo = buscarParalelo();
-        fin = std::chrono::high_resolution_clock::now();
-        auto duracionParalelo = std::chrono::duration_cast<std::chrono::microseconds>(fin - inicio).count();
+        struct Configuracion { const char* nombre; TipoIndice tipo; bool bloom; };
+        const Configuracion configuraciones[] = {
+            {"Eytzinger", TipoIndice::Eytzinger, false},
+            {"Eytzinger + Bloom", TipoIndice::Eytzinger, true},
+            {"hash", TipoIndice::Hash, false},
+            {"hash + Bloom", TipoIndice::Hash, true},
+        };
+        std::vector<int> primerResultado;
+        for (const Configuracion& config : configuraciones) {
+            inicio = std::chrono::high_resolution_clock::now();
+            if (!construirIndice(config.tipo, config.bloom)) {
+                std::cerr << "Los índices admiten menos de " << MAX_ELEMENTOS_INDICE << " elementos" << std::endl;
+                return false;
+            }
+            fin = std::chrono::high_resolution_clock::now();
+            double msConstruccion = std::chrono::duration<double, std::milli>(fin - inicio).count();
+
+            std::vector<int> individuales(numConsultas);
+            inicio = std::chrono::high_resolution_clock::now();
+            #pragma omp parallel for schedule(static)
+            for (size_t q = 0; q < numConsultas; ++q) {
+                individuales[q] = buscarIndexado(consultas[q]);
+            }
+            fin = std::chrono::high_resolution_clock::now();
+            double nsIndividual = std::chrono::duration<double, std::nano>(fin - inicio).count() / numConsultas;
+
+            std::vector<int> lote(numConsultas);
+            inicio = std::chrono::high_resolution_clock::now();
+            buscarLote(consultas.data(), numConsultas, lote.data());
+            fin = std::chrono::high_resolution_clock::now();
+            double nsLote = std::chrono::duration<double, std::nano>(fin - inicio).count() / numConsultas;
+
+            // Todas las configuraciones deben dar la primera aparición exacta
+            bool correcto = lote == individuales && std::equal(referencia.begin(), referencia.end(), lote.begin());
+            if (primerResultado.empty()) {
+                primerResultado = lote;
+            } else {
+                correcto = correcto && lote == primerResultado;
+            }
+            size_t encontradas = numConsultas - std::count(lote.begin(), lote.end(), -1);
+
+            std::cout << "Índice " << config.nombre << ": construcción " << msConstruccion << " ms, "
+                      << nsIndividual << " ns/consulta (individual), " << nsLote << " ns/consulta (lote), "
+                      << encontradas << " encontradas, correcto: " << (correcto ? "Sí" : "No") << std::endl;
+            if (config.bloom) {
+                // Falsos positivos: consultas ausentes que el filtro no descarta
+                size_t ausentes = 0, falsosPositivos = 0;
+                for (size_t q = 0; q < numConsultas; ++q) {
+                    if (lote[q] == -1) {
+                        ++ausentes;
+                        falsosPositivos += filtroBloom.puedeContener(consultas[q]);
+                    }
+                }
+                std::cout << "  Falsos positivos del filtro de Bloom: "
+                          << 100.0 * falsosPositivos / std::max<size_t>(ausentes, 1) << "%" << std::endl;
+            }
+        }
+        return true;
+    }
+
+    // Mide las versiones secuencial y paralela, el conteo y la búsqueda de todas
+    // las apariciones con el arnés común, y comprueba que coinciden
+    bool ejecutar(const OpcionesMedicion& opciones) {
+        int resultadoSecuencial = -1, resultadoParalelo = -1;
+        size_t apariciones = 0;
+        std::vector<size_t> indices;
 
-        // Impresión de resultados
         std::cout << "Tamaño del array: " << tamano << std::endl;
+        std::cout << "Kernel de comparación: " << seleccionarKernelBusqueda<int>().nombre << std::endl;
+        ArnesMedicion arnes("busqueda_paralela", opciones);
+        arnes.registrar("secuencial", tamano, [&] { resultadoSecuencial = buscarSecuencial(); });
+        arnes.registrarParalelo("paralelo", tamano, [&] { resultadoParalelo = buscarParalelo(); });
+        arnes.registrarParalelo("conteo", tamano, [&] { apariciones = contarParalelo(); });
+        arnes.registrarParalelo("todas", tamano, [&] { indices = buscarTodos(); });
+        // El escalado débil usa el conteo, que recorre siempre el array completo;
+        // la búsqueda termina en la primera aparición, que cambia con cada array
+        const size_t porHilo = std::max<size_t>(tamano / omp_get_max_threads(), 1);
+        const int valor = objetivo;
+        const uint64_t semilla = opciones.semilla;
+        arnes.registrarEscaladoDebil("conteo", porHilo, [porHilo, valor, semilla](int hilos) {
+            auto buscador = std::make_shared<BuscadorParalelo>(porHilo * hilos, semilla, valor);
+            return [buscador] { buscador->contarParalelo(); };
+        });
+        bool escrito = arnes.ejecutar();
+
+        // Impresión de resultados
         std::cout << "Índice encontrado (secuencial): "  
                   << " ( Array["<< resultadoSecuencial <<"]: " << (resultadoSecuencial != -1 ? std::to_string(array[resultadoSecuencial]) : "no encontrado") << " )" << std::endl;
         std::cout << "Índice encontrado (paralelo):   "  
                   << " ( Array["<< resultadoParalelo <<"]: " << (resultadoParalelo != -1 ? std::to_string(array[resultadoParalelo]) : "no encontrado") << " )" << std::endl;
-        std::cout << "Tiempo de ejecución (secuencial): " << duracionSecuencial << " microsegundos" << std::endl;
-        std::cout << "Tiempo de ejecución (paralelo):   " << duracionParalelo << " microsegundos" << std::endl;
-        std::cout << "Aceleración: " << static_cast<double>(duracionSecuencial) / duracionParalelo << "x" << std::endl;
+        std::cout << "Resultado correcto (primera aparición): " << (resultadoParalelo == resultadoSecuencial ? "Sí" : "No") << std::endl;
+
+        size_t aparicionesSecuencial = std::count(array.begin(), array.end(), objetivo);
+        bool todosCorrectos = indices.size() == aparicionesSecuencial &&
+                              std::is_sorted(indices.begin(), indices.end()) &&
+                              std::all_of(indices.begin(), indices.end(), [&](size_t i) { return array[i] == objetivo; }) &&
+                              (indices.empty() ? resultadoSecuencial == -1 : indices[0] == static_cast<size_t>(resultadoSecuencial));
+        std::cout << "Apariciones (conteo paralelo): " << apariciones << std::endl;
+        std::cout << "Apariciones (búsqueda de todas): " << indices.size() << std::endl;
+        std::cout << "Resultado correcto (conteo y todas): "
+                  << (apariciones == aparicionesSecuencial && todosCorrectos ? "Sí" : "No") << std::endl;
+        return escrito;
     }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     const size_t TAMANO_ARRAY = 100000000; // Tamaño del array para la búsqueda
-    BuscadorParalelo buscador(TAMANO_ARRAY);
-    buscador.ejecutar();
-    return 0;
+    OpcionesMedicion opciones;
+    if (!extraerOpcionesMedicion(argc, argv, opciones)) return 1;
+    // Modo "indices": compara los índices para consultas repetidas
+    //   indices [numero_consultas]
+    if (argc > 1 && std::string(argv[1]) == "indices") {
+        size_t consultas = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+        BuscadorParalelo buscador(TAMANO_ARRAY, opciones.semilla);
+        return buscador.compararIndices(std::max<size_t>(consultas, 1), opciones.semilla) ? 0 : 1;
+    }
+    // Argumento opcional: elemento a buscar (por defecto, uno derivado de la semilla)
+    if (argc > 1) {
+        BuscadorParalelo buscador(TAMANO_ARRAY, opciones.semilla, std::atoi(argv[1]));
+        return buscador.ejecutar(opciones) ? 0 : 1;
+    }
+    BuscadorParalelo buscador(TAMANO_ARRAY, opciones.semilla);
+    return buscador.ejecutar(opciones) ? 0 : 1;
 }
\ No newline at end of file
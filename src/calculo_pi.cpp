@@ -1,7 +1,19 @@
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <memory>
 #include <omp.h>
+#include "medicion.h"
+#include "nucleos/integracion.h"
+
+// Pasos por bloque del cálculo en precisión reducida: dentro de un bloque se
+// opera y acumula en el tipo pedido; las sumas de los bloques, en double
+const int PASOS_POR_BLOQUE = 4096;
 
 class CalculadorPi {
 private:
@@ -24,53 +36,188 @@ public:
         return paso * suma;
     }
 
-    // Calcula Pi de forma paralela usando OpenMP
+    // Calcula Pi de forma paralela con el motor de cuadratura: la regla del punto
+    // medio con los mismos numPasos que calcularSecuencial (la referencia), pero
+    // vectorizada, con suma compensada y combinación de bloques en orden fijo,
+    // así que el resultado es idéntico con cualquier número de hilos
     double calcularParalelo() {
-        double paso = 1.0 / static_cast<double>(numPasos);
+        auto integrando = [](double x) { return 4.0 / (1.0 + x * x); };
+        return integrarCompuesta<ReglaPuntoMedio>(integrando, 0.0, 1.0, numPasos).valor;
+    }
+
+    // Calcula Pi de forma paralela operando en T (float o double) por bloques
+    // de PASOS_POR_BLOQUE. Con float cada registro vectorial lleva el doble de
+    // pasos; la abscisa se calcula desde el inicio del bloque y la suma parcial
+    // del bloque no pasa de 4 * PASOS_POR_BLOQUE, así que el error de redondeo no
+    // crece con numPasos, y la suma total se acumula en double
+    template <typename T>
+    double calcularPorBloques() {
+        const double paso = 1.0 / static_cast<double>(numPasos);
+        const long long numBloques = (numPasos + PASOS_POR_BLOQUE - 1) / PASOS_POR_BLOQUE;
         double suma = 0.0;
 
-        // Usamos #pragma omp parallel para crear un equipo de hilos
-        #pragma omp parallel
-        {
-            // Usamos #pragma omp for reduction(+:suma) para paralelizar el bucle
-            // y realizar una reducción segura de la variable suma
-            // Justificación: Esto permite que cada hilo compute una parte de la suma
-            // y luego combina los resultados de forma segura y eficiente
-            #pragma omp for reduction(+:suma)
-            for (long long i = 0; i < numPasos; i++) {
-                double x = (i + 0.5) * paso;
-                suma += 4.0 / (1.0 + x * x);
+        // Justificación: Los bloques son independientes; cada hilo acumula en
+        // double las sumas en T de los suyos y la reducción combina los parciales
+        #pragma omp parallel for reduction(+:suma) schedule(static)
+        for (long long b = 0; b < numBloques; b++) {
+            const long long inicio = b * PASOS_POR_BLOQUE;
+            const int pasos = static_cast<int>(std::min<long long>(PASOS_POR_BLOQUE, numPasos - inicio));
+            const T base = static_cast<T>((inicio + 0.5) * paso);
+            const T pasoT = static_cast<T>(paso);
+            T parcial = 0;
+            #pragma omp simd reduction(+:parcial)
+            for (int i = 0; i < pasos; i++) {
+                T x = base + static_cast<T>(i) * pasoT;
+                parcial += T(4) / (T(1) + x * x);
             }
+            suma += parcial;
         }
 
         return paso * suma;
     }
 
-    // Ejecuta y mide el tiempo de las versiones secuencial y paralela
-    void ejecutar() {
-        auto inicio = std::chrono::high_resolution_clock::now();
-        double piSecuencial = calcularSecuencial();
-        auto fin = std::chrono::high_resolution_clock::now();
-        auto duracionSecuencial = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
-
-        inicio = std::chrono::high_resolution_clock::now();
-        double piParalelo = calcularParalelo();
-        fin = std::chrono::high_resolution_clock::now();
-        auto duracionParalelo = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
-
+    // Mide las versiones secuencial y paralela con el arnés común; con --barrido
+    // añade el escalado fuerte y el débil (pasos proporcionales a los hilos)
+    bool ejecutar(const OpcionesMedicion& opciones) {
+        double piSecuencial = 0.0, piParalelo = 0.0;
         std::cout << "Número de pasos: " << numPasos << std::endl;
+        ArnesMedicion arnes("calculo_pi", opciones);
+        arnes.registrar("secuencial", numPasos, [&] { piSecuencial = calcularSecuencial(); });
+        arnes.registrarParalelo("paralelo", numPasos, [&] { piParalelo = calcularParalelo(); });
+        const long long porHilo = std::max<long long>(numPasos / omp_get_max_threads(), 1);
+        arnes.registrarEscaladoDebil("paralelo", porHilo, [porHilo](int hilos) {
+            auto calculador = std::make_shared<CalculadorPi>(porHilo * hilos);
+            return [calculador] { calculador->calcularParalelo(); };
+        });
+        // Sin tráfico de memoria; 6 operaciones por paso (x, x*x, 1+x*x, 4/(...) y la suma)
+        arnes.asignarCarga("secuencial", 0.0, 6.0 * numPasos);
+        arnes.asignarCarga("paralelo", 0.0, 6.0 * numPasos);
+        bool escrito = arnes.ejecutar();
+
         std::cout << std::setprecision(15);
         std::cout << "Pi (secuencial): " << piSecuencial << std::endl;
         std::cout << "Pi (paralelo):   " << piParalelo << std::endl;
-        std::cout << "Tiempo de ejecución (secuencial): " << duracionSecuencial << " ms" << std::endl;
-        std::cout << "Tiempo de ejecución (paralelo): " << duracionParalelo << " ms" << std::endl;
-        std::cout << "Aceleración: " << static_cast<double>(duracionSecuencial) / duracionParalelo << "x" << std::endl;
+        return escrito;
+    }
+
+    // Compara las reglas compuestas del motor de cuadratura con numPasos
+    // evaluaciones como máximo y la subdivisión adaptativa con la tolerancia dada.
+    // Comprueba además que cada resultado es idéntico con 1 hilo y con todos
+    void compararReglas(double tolerancia) {
+        const double PI_REFERENCIA = 3.141592653589793238;
+        auto integrando = [](double x) { return 4.0 / (1.0 + x * x); };
+        const int maxHilos = omp_get_max_threads();
+
+        std::cout << std::setprecision(15);
+        std::cout << "Motor de cuadratura, integral de 4/(1+x^2) en [0, 1]" << std::endl;
+
+        auto medir = [&](const char* nombre, auto calcular) {
+            omp_set_num_threads(1);
+            ResultadoCuadratura unHilo = calcular();
+            omp_set_num_threads(maxHilos);
+            auto inicio = std::chrono::high_resolution_clock::now();
+            ResultadoCuadratura resultado = calcular();
+            auto fin = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double, std::milli> duracion = fin - inicio;
+
+            std::cout << std::left << std::setw(20) << nombre << std::right
+                      << " pi = " << resultado.valor
+                      << "  error = " << std::scientific << std::setprecision(3)
+                      << std::abs(resultado.valor - PI_REFERENCIA)
+                      << std::defaultfloat << std::setprecision(15)
+                      << "  evaluaciones = " << resultado.evaluaciones
+                      << "  tiempo = " << duracion.count() << " ms"
+                      << "  idéntico con 1 y " << maxHilos << " hilos: "
+                      << (unHilo.valor == resultado.valor ? "Sí" : "No") << std::endl;
+        };
+
+        medir(ReglaPuntoMedio::nombre, [&] {
+            return integrarCompuesta<ReglaPuntoMedio>(integrando, 0.0, 1.0, numPasos);
+        });
+        // Con Simpson y Gauss-Legendre basta una fracción de las evaluaciones para
+        // llegar al límite de la precisión doble
+        medir(ReglaSimpson::nombre, [&] {
+            return integrarCompuesta<ReglaSimpson>(integrando, 0.0, 1.0, std::max(1LL, numPasos / 1000));
+        });
+        medir(ReglaGaussLegendre5::nombre, [&] {
+            return integrarCompuesta<ReglaGaussLegendre5>(integrando, 0.0, 1.0, std::max(1LL, numPasos / 100000));
+        });
+        medir("adaptativa GL5", [&] {
+            return integrarAdaptativa(integrando, 0.0, 1.0, tolerancia);
+        });
+        medir("adaptativa GL5 robo", [&] {
+            return integrarAdaptativa<TareasRobo>(integrando, 0.0, 1.0, tolerancia);
+        });
+
+        // sqrt(x) tiene derivada no acotada en 0: las reglas compuestas pierden
+        // orden y la subdivisión adaptativa concentra los puntos junto al origen
+        auto raiz = [](double x) { return std::sqrt(x); };
+        const double DOS_TERCIOS = 2.0 / 3.0;
+        ResultadoCuadratura compuesta = integrarCompuesta<ReglaGaussLegendre5>(raiz, 0.0, 1.0, std::max(1LL, numPasos / 100000));
+        ResultadoCuadratura adaptativa = integrarAdaptativa(raiz, 0.0, 1.0, tolerancia);
+        std::cout << "Integral de sqrt(x) en [0, 1]:" << std::scientific << std::setprecision(3) << std::endl;
+        std::cout << "  compuesta GL5:  error = " << std::abs(compuesta.valor - DOS_TERCIOS)
+                  << "  evaluaciones = " << compuesta.evaluaciones << std::endl;
+        std::cout << "  adaptativa GL5: error = " << std::abs(adaptativa.valor - DOS_TERCIOS)
+                  << "  evaluaciones = " << adaptativa.evaluaciones << std::endl;
+        std::cout << std::defaultfloat;
+    }
+
+    // Compara el cálculo por bloques en double y en float con la versión
+    // paralela: tiempo, aceleración y error respecto a Pi
+    bool compararPrecision(const OpcionesMedicion& opciones) {
+        const double PI_REFERENCIA = 3.141592653589793238;
+        double piParalelo = 0.0, piDoble = 0.0, piSimple = 0.0;
+        std::cout << "Número de pasos: " << numPasos << " (bloques de " << PASOS_POR_BLOQUE << ")" << std::endl;
+        ArnesMedicion arnes("calculo_pi_precision", opciones);
+        arnes.registrarParalelo("paralelo", numPasos, [&] { piParalelo = calcularParalelo(); });
+        arnes.registrarParalelo("bloques double", numPasos, [&] { piDoble = calcularPorBloques<double>(); });
+        arnes.registrarParalelo("bloques float", numPasos, [&] { piSimple = calcularPorBloques<float>(); });
+        for (const char* caso : {"paralelo", "bloques double", "bloques float"}) {
+            arnes.asignarCarga(caso, 0.0, 6.0 * numPasos);
+        }
+        bool escrito = arnes.ejecutar();
+
+        auto informar = [&](const char* nombre, double valor) {
+            std::cout << std::left << std::setw(16) << nombre << std::right << std::fixed << std::setprecision(15)
+                      << " pi = " << valor << "  error = " << std::scientific << std::setprecision(3)
+                      << std::abs(valor - PI_REFERENCIA) << std::endl;
+        };
+        informar("paralelo", piParalelo);
+        informar("bloques double", piDoble);
+        informar("bloques float", piSimple);
+        std::cout << std::fixed << std::setprecision(2) << "Aceleración de float respecto a double: "
+                  << cocienteTiempos(arnes.mediana("bloques double"), arnes.mediana("bloques float")) << "x"
+                  << std::endl;
+        std::cout << std::defaultfloat;
+        return escrito;
     }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     const long long NUM_PASOS = 1000000000;
     CalculadorPi calculador(NUM_PASOS);
-    calculador.ejecutar();
-    return 0;
+
+    OpcionesMedicion opciones;
+    if (!extraerOpcionesMedicion(argc, argv, opciones)) return 1;
+    std::string modo = argc > 1 ? argv[1] : "";
+    if (modo == "cuadratura") {
+        double tolerancia = argc > 2 ? std::atof(argv[2]) : 1e-13;
+        if (tolerancia <= 0.0) {
+            std::cerr << "Uso: " << argv[0] << " cuadratura [tolerancia > 0]" << std::endl;
+            return 1;
+        }
+        calculador.compararReglas(tolerancia);
+        return 0;
+    }
+    if (modo == "precision") {
+        return calculador.compararPrecision(opciones) ? 0 : 1;
+    }
+    if (!modo.empty()) {
+        std::cerr << "Uso: " << argv[0] << " [cuadratura [tolerancia] | precision] [--calentamiento N] [--repeticiones N] "
+                  << "[--barrido] [--json archivo] [--csv archivo]" << std::endl;
+        return 1;
+    }
+
+    return calculador.ejecutar(opciones) ? 0 : 1;
 }
\ No newline at end of file
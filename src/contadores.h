@@ -0,0 +1,233 @@
+#ifndef CONTADORES_H
+#define CONTADORES_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define CONTADORES_LINUX 1
+#endif
+
+// Eventos que se leen de cada hilo. El primero (ciclos) es el líder del grupo:
+// si no se puede abrir, no hay contadores. Los demás son opcionales (p. ej. los
+// ciclos parados no existen en muchas CPU Intel) y se marcan como no disponibles
+enum EventoHardware {
+    EVENTO_CICLOS = 0,
+    EVENTO_INSTRUCCIONES,
+    EVENTO_FALLOS_LLC,
+    EVENTO_FALLOS_RAMA,
+    EVENTO_CICLOS_PARADOS,
+    NUM_EVENTOS_HARDWARE
+};
+
+// Métricas de una región: totales de todos los hilos y desequilibrio entre hilos
+struct MetricasHardware {
+    bool disponibles = false;
+    bool evento[NUM_EVENTOS_HARDWARE] = {};
+    double total[NUM_EVENTOS_HARDWARE] = {};
+    // Ciclos del hilo más cargado / media de ciclos de los hilos del equipo.
+    // Con OMP_WAIT_POLICY=passive los hilos que esperan en barreras no
+    // cuentan ciclos, así que 1.0 indica reparto equilibrado
+    double desequilibrio = 0.0;
+
+    double ipc() const {
+        return evento[EVENTO_INSTRUCCIONES] && total[EVENTO_CICLOS] > 0.0
+                   ? total[EVENTO_INSTRUCCIONES] / total[EVENTO_CICLOS] : 0.0;
+    }
+};
+
+// Contadores de hardware por hilo con perf_event_open. Se abre un grupo de
+// eventos en cada hilo del equipo de OpenMP (pid = 0: el hilo que llama), de
+// modo que las regiones paralelas siguientes, que reutilizan esos mismos hilos,
+// quedan medidas. Solo se cuenta el modo usuario, lo que basta con
+// perf_event_paranoid <= 2. En otros sistemas, o si el núcleo no expone la PMU
+// (máquinas virtuales, contenedores), abrir() falla y el llamador sigue solo
+// con tiempos
+class ContadoresHardware {
+public:
+    ContadoresHardware() = default;
+    ContadoresHardware(const ContadoresHardware&) = delete;
+    ContadoresHardware& operator=(const ContadoresHardware&) = delete;
+    ~ContadoresHardware() { cerrar(); }
+
+    // Abre los grupos en los hilos 0..hilos-1 del equipo. Devuelve false (con el
+    // motivo en error()) si el contador de ciclos no está disponible en algún hilo
+    bool abrir(int hilos) {
+        cerrar();
+#ifdef CONTADORES_LINUX
+        grupos.assign(hilos, Grupo());
+        std::vector<int> errores(hilos, 0);
+        // Justificación: Cada hilo abre sus propios contadores; los grupos son
+        // disjuntos y cada uno escribe solo su posición de los vectores
+        #pragma omp parallel num_threads(hilos)
+        {
+            int id = omp_get_thread_num();
+            if (id < hilos) errores[id] = grupos[id].abrir();
+        }
+        for (int e : errores) {
+            if (e != 0) {
+                motivo = std::strerror(e);
+                cerrar();
+                return false;
+            }
+        }
+        return true;
+#else
+        (void)hilos;
+        motivo = "perf_event_open solo existe en Linux";
+        return false;
+#endif
+    }
+
+    void cerrar() {
+#ifdef CONTADORES_LINUX
+        for (Grupo& g : grupos) g.cerrar();
+#endif
+        grupos.clear();
+    }
+
+    bool abiertos() const { return !grupos.empty(); }
+    const std::string& error() const { return motivo; }
+
+    // Activa los contadores de todos los hilos y guarda sus valores iniciales
+    // (algunos eventos no admiten PERF_EVENT_IOC_RESET, así que se trabaja con
+    // diferencias). ioctl sobre el descriptor de otro hilo es válido: no hace
+    // falta entrar en una región paralela
+    void iniciar() {
+#ifdef CONTADORES_LINUX
+        for (Grupo& g : grupos) {
+            g.leer(g.inicial);
+            ioctl(g.descriptores[EVENTO_CICLOS], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Detiene los contadores y devuelve las métricas acumuladas desde iniciar()
+    MetricasHardware detener() {
+        MetricasHardware m;
+#ifdef CONTADORES_LINUX
+        for (Grupo& g : grupos) {
+            ioctl(g.descriptores[EVENTO_CICLOS], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+        if (grupos.empty()) return m;
+
+        m.disponibles = true;
+        for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) m.evento[e] = grupos[0].descriptores[e] >= 0;
+        double maximoCiclos = 0.0, sumaCiclos = 0.0;
+        for (Grupo& g : grupos) {
+            Lectura final;
+            if (!g.leer(final)) {
+                m.disponibles = false;
+                return m;
+            }
+            // Escala por la fracción del intervalo que los contadores estuvieron
+            // en la PMU (multiplexación cuando hay más eventos que contadores)
+            double habilitado = static_cast<double>(final.habilitado - g.inicial.habilitado);
+            double activo = static_cast<double>(final.activo - g.inicial.activo);
+            double escala = activo > 0.0 ? habilitado / activo : 0.0;
+            double ciclos = 0.0;
+            for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) {
+                double valor = static_cast<double>(final.valores[e] - g.inicial.valores[e]) * escala;
+                m.total[e] += valor;
+                if (e == EVENTO_CICLOS) ciclos = valor;
+            }
+            maximoCiclos = std::max(maximoCiclos, ciclos);
+            sumaCiclos += ciclos;
+        }
+        double mediaCiclos = sumaCiclos / static_cast<double>(grupos.size());
+        m.desequilibrio = mediaCiclos > 0.0 ? maximoCiclos / mediaCiclos : 0.0;
+#endif
+        return m;
+    }
+
+private:
+#ifdef CONTADORES_LINUX
+    // Valores brutos de un grupo y tiempos habilitado/activo en la PMU (ns)
+    struct Lectura {
+        uint64_t valores[NUM_EVENTOS_HARDWARE] = {};
+        uint64_t habilitado = 0;
+        uint64_t activo = 0;
+    };
+
+    struct Grupo {
+        int descriptores[NUM_EVENTOS_HARDWARE];
+
+        Grupo() { std::fill(descriptores, descriptores + NUM_EVENTOS_HARDWARE, -1); }
+
+        static int abrirEvento(uint64_t configuracion, int lider) {
+            perf_event_attr atributos;
+            std::memset(&atributos, 0, sizeof(atributos));
+            atributos.size = sizeof(atributos);
+            atributos.type = PERF_TYPE_HARDWARE;
+            atributos.config = configuracion;
+            atributos.disabled = lider < 0 ? 1 : 0;
+            atributos.exclude_kernel = 1;
+            atributos.exclude_hv = 1;
+            atributos.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                                    PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(SYS_perf_event_open, &atributos, 0, -1, lider, 0));
+        }
+
+        // Devuelve 0 o el errno del líder; los eventos secundarios que fallan se
+        // dejan a -1
+        int abrir() {
+            static const uint64_t configuraciones[NUM_EVENTOS_HARDWARE] = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+                PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_STALLED_CYCLES_BACKEND};
+            descriptores[EVENTO_CICLOS] = abrirEvento(configuraciones[EVENTO_CICLOS], -1);
+            if (descriptores[EVENTO_CICLOS] < 0) return errno != 0 ? errno : ENOENT;
+            for (int e = 1; e < NUM_EVENTOS_HARDWARE; ++e) {
+                descriptores[e] = abrirEvento(configuraciones[e], descriptores[EVENTO_CICLOS]);
+            }
+            ids.assign(NUM_EVENTOS_HARDWARE, UINT64_MAX);
+            for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) {
+                if (descriptores[e] >= 0) ioctl(descriptores[e], PERF_EVENT_IOC_ID, &ids[e]);
+            }
+            return 0;
+        }
+
+        void cerrar() {
+            for (int& d : descriptores) {
+                if (d >= 0) close(d);
+                d = -1;
+            }
+        }
+
+        // Lee el grupo completo en una llamada
+        bool leer(Lectura& lectura) {
+            uint64_t buffer[3 + 2 * NUM_EVENTOS_HARDWARE];
+            ssize_t leidos = read(descriptores[EVENTO_CICLOS], buffer, sizeof(buffer));
+            if (leidos < static_cast<ssize_t>(3 * sizeof(uint64_t))) return false;
+            lectura = Lectura();
+            lectura.habilitado = buffer[1];
+            lectura.activo = buffer[2];
+            for (uint64_t i = 0; i < buffer[0] && i < NUM_EVENTOS_HARDWARE; ++i) {
+                for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) {
+                    if (ids[e] == buffer[4 + 2 * i]) lectura.valores[e] = buffer[3 + 2 * i];
+                }
+            }
+            return true;
+        }
+
+        Lectura inicial;
+        std::vector<uint64_t> ids;
+    };
+
+    std::vector<Grupo> grupos;
+#else
+    struct Grupo {};
+    std::vector<Grupo> grupos;
+#endif
+    std::string motivo;
+};
+
+#endif // CONTADORES_H
@@ -0,0 +1,142 @@
+#ifndef MATRIZ2D_H
+#define MATRIZ2D_H
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include <omp.h>
+#include "nucleos/vista.h"
+
+// Contenedor 2-D contiguo en orden por filas: una única reserva alineada a línea
+// de caché, con stride (elementos por fila) configurable para añadir relleno.
+// Sustituye a std::vector<std::vector<T>>, que hace una reserva por fila
+// y rompe la precarga de hardware y la vectorización entre filas.
+template <typename T>
+class Matriz2D {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Matriz2D solo admite tipos trivialmente copiables");
+
+private:
+    T* datos;
+    size_t numFilas;
+    size_t numColumnas;
+    size_t paso;
+
+    static T* reservar(size_t elementos) {
+        if (elementos == 0) return nullptr;
+        return static_cast<T*>(::operator new(elementos * sizeof(T), std::align_val_t(ALINEACION)));
+    }
+
+    static void liberar(T* puntero) {
+        if (puntero) ::operator delete(puntero, std::align_val_t(ALINEACION));
+    }
+
+public:
+    static constexpr size_t ALINEACION = 64;
+
+    // Stride recomendado: redondea cada fila a múltiplo de línea de caché y, si la
+    // fila resultante es múltiplo de 4 KB, añade una línea extra para evitar que
+    // las filas consecutivas compitan por los mismos conjuntos de la caché
+    static size_t strideRecomendado(size_t columnas) {
+        const size_t porLinea = ALINEACION / sizeof(T) > 0 ? ALINEACION / sizeof(T) : 1;
+        size_t stride = (columnas + porLinea - 1) / porLinea * porLinea;
+        if (stride > 0 && (stride * sizeof(T)) % 4096 == 0) {
+            stride += porLinea;
+        }
+        return stride;
+    }
+
+    Matriz2D() : datos(nullptr), numFilas(0), numColumnas(0), paso(0) {}
+
+    // Reserva filas x columnas (stride 0 = stride recomendado) y realiza la primera
+    // escritura en paralelo, de modo que cada página queda en el nodo NUMA del hilo
+    // que después procesará esas filas con schedule(static). Un stride distinto de
+    // 0 menor que columnas lanza std::invalid_argument
+    Matriz2D(size_t filas, size_t columnas, T valor = T(), size_t stride = 0)
+        : datos(nullptr), numFilas(filas), numColumnas(columnas),
+          paso(stride == 0 ? strideRecomendado(columnas) : stride) {
+        if (paso < numColumnas) {
+            throw std::invalid_argument("Matriz2D: el stride no puede ser menor que el número de columnas");
+        }
+        datos = reservar(numFilas * paso);
+        rellenar(valor);
+    }
+
+    Matriz2D(const Matriz2D& otra)
+        : datos(reservar(otra.numFilas * otra.paso)), numFilas(otra.numFilas),
+          numColumnas(otra.numColumnas), paso(otra.paso) {
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < numFilas; ++i) {
+            const T* origen = otra[i];
+            T* destino = (*this)[i];
+            for (size_t j = 0; j < paso; ++j) {
+                destino[j] = origen[j];
+            }
+        }
+    }
+
+    Matriz2D(Matriz2D&& otra) noexcept
+        : datos(otra.datos), numFilas(otra.numFilas), numColumnas(otra.numColumnas), paso(otra.paso) {
+        otra.datos = nullptr;
+        otra.numFilas = otra.numColumnas = otra.paso = 0;
+    }
+
+    Matriz2D& operator=(Matriz2D otra) noexcept {
+        std::swap(datos, otra.datos);
+        std::swap(numFilas, otra.numFilas);
+        std::swap(numColumnas, otra.numColumnas);
+        std::swap(paso, otra.paso);
+        return *this;
+    }
+
+    ~Matriz2D() { liberar(datos); }
+
+    size_t filas() const { return numFilas; }
+    size_t columnas() const { return numColumnas; }
+    size_t stride() const { return paso; }
+    T* data() { return datos; }
+    const T* data() const { return datos; }
+
+    // Acceso por fila: permite la sintaxis matriz[i][j]
+    T* operator[](size_t i) { return datos + i * paso; }
+    const T* operator[](size_t i) const { return datos + i * paso; }
+
+    VistaTile<T> vista() { return VistaTile<T>{datos, numFilas, numColumnas, paso}; }
+    VistaTile<const T> vista() const { return VistaTile<const T>{datos, numFilas, numColumnas, paso}; }
+
+    VistaTile<T> fila(size_t i) { return VistaTile<T>{(*this)[i], 1, numColumnas, paso}; }
+
+    VistaTile<T> tile(size_t fila, size_t columna, size_t filasTile, size_t columnasTile) {
+        return VistaTile<T>{(*this)[fila] + columna, filasTile, columnasTile, paso};
+    }
+    VistaTile<const T> tile(size_t fila, size_t columna, size_t filasTile, size_t columnasTile) const {
+        return VistaTile<const T>{(*this)[fila] + columna, filasTile, columnasTile, paso};
+    }
+
+    // Asigna el mismo valor a todos los elementos (incluido el relleno) en paralelo
+    void rellenar(T valor) {
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < numFilas; ++i) {
+            T* f = (*this)[i];
+            for (size_t j = 0; j < paso; ++j) {
+                f[j] = valor;
+            }
+        }
+    }
+
+    // Compara solo los elementos lógicos; el relleno se ignora
+    bool operator==(const Matriz2D& otra) const {
+        if (numFilas != otra.numFilas || numColumnas != otra.numColumnas) return false;
+        for (size_t i = 0; i < numFilas; ++i) {
+            for (size_t j = 0; j < numColumnas; ++j) {
+                if ((*this)[i][j] != otra[i][j]) return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const Matriz2D& otra) const { return !(*this == otra); }
+};
+
+#endif
@@ -0,0 +1,518 @@
+#ifndef MEDICION_H
+#define MEDICION_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "contadores.h"
+
+// Opciones comunes de medición que aceptan todos los programas:
+//   --calentamiento N   ejecuciones previas sin medir (por defecto 1)
+//   --repeticiones N    ejecuciones medidas (por defecto 5)
+//   --barrido           recorre 1..N hilos (escalado fuerte y débil)
+//   --json archivo      escribe los resultados en JSON
+//   --csv archivo       escribe los resultados en CSV
+//   --contadores        añade una ejecución con contadores de hardware por caso
+//   --semilla N         semilla de los datos de entrada (por defecto 2024); los
+//                       mismos datos con cualquier número de hilos
+//   --ajustar           busca la mejor configuración de los bucles ajustables
+//                       (ajuste.h) y la guarda en la caché
+//   --cache-ajuste ruta caché de configuraciones (por defecto ajuste_openmp.txt)
+struct OpcionesMedicion {
+    int calentamiento = 1;
+    int repeticiones = 5;
+    bool barrido = false;
+    bool contadores = false;
+    std::string archivoJson;
+    std::string archivoCsv;
+    uint64_t semilla = 2024;
+    bool ajustar = false;
+    std::string archivoAjuste = "ajuste_openmp.txt";
+};
+
+// Extrae las opciones de medición de la línea de órdenes y las elimina de argv,
+// de modo que cada programa sigue leyendo sus argumentos posicionales como antes.
+// Devuelve false (con el error en cerr) si una opción está incompleta o no es válida
+inline bool extraerOpcionesMedicion(int& argc, char* argv[], OpcionesMedicion& opciones) {
+    int destino = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string opcion = argv[i];
+        bool conValor = opcion == "--calentamiento" || opcion == "--repeticiones" ||
+                        opcion == "--json" || opcion == "--csv" || opcion == "--semilla" ||
+                        opcion == "--cache-ajuste";
+        if (conValor && i + 1 >= argc) {
+            std::cerr << "Falta el valor de " << opcion << std::endl;
+            return false;
+        }
+        if (opcion == "--calentamiento" || opcion == "--repeticiones") {
+            char* fin = nullptr;
+            long valor = std::strtol(argv[++i], &fin, 10);
+            bool esRepeticiones = opcion == "--repeticiones";
+            if (*fin != '\0' || valor < (esRepeticiones ? 1 : 0) || valor > 1000000) {
+                std::cerr << "Valor no válido para " << opcion << ": " << argv[i] << std::endl;
+                return false;
+            }
+            (esRepeticiones ? opciones.repeticiones : opciones.calentamiento) = static_cast<int>(valor);
+        } else if (opcion == "--semilla") {
+            char* fin = nullptr;
+            unsigned long long valor = std::strtoull(argv[++i], &fin, 10);
+            if (*fin != '\0' || argv[i][0] == '-' || argv[i][0] == '\0') {
+                std::cerr << "Valor no válido para " << opcion << ": " << argv[i] << std::endl;
+                return false;
+            }
+            opciones.semilla = static_cast<uint64_t>(valor);
+        } else if (opcion == "--json") {
+            opciones.archivoJson = argv[++i];
+        } else if (opcion == "--csv") {
+            opciones.archivoCsv = argv[++i];
+        } else if (opcion == "--barrido") {
+            opciones.barrido = true;
+        } else if (opcion == "--contadores") {
+            opciones.contadores = true;
+        } else if (opcion == "--ajustar") {
+            opciones.ajustar = true;
+        } else if (opcion == "--cache-ajuste") {
+            opciones.archivoAjuste = argv[++i];
+        } else {
+            argv[destino++] = argv[i];
+        }
+    }
+    argc = destino;
+    argv[argc] = nullptr;
+    return true;
+}
+
+// Estadísticos de una serie de tiempos, en milisegundos
+struct EstadisticasTiempo {
+    double mediana = 0.0;
+    double p95 = 0.0;
+    double media = 0.0;
+    double desviacion = 0.0;
+    double minimo = 0.0;
+    double maximo = 0.0;
+};
+
+// Percentil por interpolación lineal entre las muestras ordenadas
+inline double percentil(const std::vector<double>& ordenadas, double p) {
+    if (ordenadas.empty()) return 0.0;
+    double posicion = p * static_cast<double>(ordenadas.size() - 1);
+    size_t inferior = static_cast<size_t>(posicion);
+    size_t superior = std::min(inferior + 1, ordenadas.size() - 1);
+    double fraccion = posicion - static_cast<double>(inferior);
+    return ordenadas[inferior] + fraccion * (ordenadas[superior] - ordenadas[inferior]);
+}
+
+inline EstadisticasTiempo calcularEstadisticas(std::vector<double> muestras) {
+    EstadisticasTiempo e;
+    if (muestras.empty()) return e;
+    std::sort(muestras.begin(), muestras.end());
+    e.mediana = percentil(muestras, 0.5);
+    e.p95 = percentil(muestras, 0.95);
+    e.minimo = muestras.front();
+    e.maximo = muestras.back();
+    for (double m : muestras) e.media += m;
+    e.media /= static_cast<double>(muestras.size());
+    // Desviación típica muestral (n - 1); con una sola muestra es 0
+    if (muestras.size() > 1) {
+        double suma = 0.0;
+        for (double m : muestras) suma += (m - e.media) * (m - e.media);
+        e.desviacion = std::sqrt(suma / static_cast<double>(muestras.size() - 1));
+    }
+    return e;
+}
+
+// Cociente de tiempos protegido: 0 si el divisor no es positivo (se imprime como
+// "n/d"), en lugar de infinito o NaN cuando una ejecución dura menos que la
+// resolución del reloj
+inline double cocienteTiempos(double numerador, double denominador) {
+    return denominador > 0.0 ? numerador / denominador : 0.0;
+}
+
+// Una fila de resultados: un caso medido con un número de hilos
+struct ResultadoMedicion {
+    std::string caso;
+    std::string escalado;   // "unico", "fuerte" o "debil"
+    int hilos = 1;
+    double tamano = 0.0;    // tamaño del problema (elementos, pasos, puntos...)
+    EstadisticasTiempo tiempo;
+    double aceleracion = 0.0;
+    double eficiencia = 0.0;
+    double bytes = 0.0;     // bytes y operaciones en punto flotante nominales por
+    double flops = 0.0;     // ejecución (0 si no se declararon)
+    MetricasHardware hardware;
+};
+
+// Arnés de medición compartido. Cada programa registra sus kernels y el arnés
+// los ejecuta con calentamiento y repeticiones, calcula mediana/p95/desviación,
+// opcionalmente barre el número de hilos y escribe JSON/CSV.
+//  - registrar: caso secuencial. El primer caso registrado es la referencia de
+//    las aceleraciones
+//  - registrarParalelo: caso paralelo con todos los hilos; con --barrido se
+//    mide con 1..N hilos
+//    (escalado fuerte: mismo problema, aceleración respecto a 1 hilo)
+//  - registrarEscaladoDebil: solo con --barrido; la fábrica construye un
+//    problema proporcional al número de hilos (eficiencia = t(1) / t(h))
+//  - asignarCarga: bytes y flops nominales de un caso, para bytes/flop
+// Con --contadores cada caso se ejecuta una vez más, fuera de las repeticiones
+// medidas, con contadores de hardware por hilo (ContadoresHardware); si no están
+// disponibles se avisa una vez y la salida contiene solo tiempos
+class ArnesMedicion {
+public:
+    using Funcion = std::function<void()>;
+    using FabricaEscalado = std::function<Funcion(int hilos)>;
+
+    ArnesMedicion(const std::string& nombrePrograma, const OpcionesMedicion& o)
+        : programa(nombrePrograma), opciones(o), hilosMaximos(omp_get_max_threads()) {}
+
+    // preparar (opcional) se ejecuta sin medir antes de cada ejecución, para
+    // restaurar las entradas de los kernels que las modifican
+    void registrar(const std::string& nombre, double tamano, Funcion ejecutar, Funcion preparar = nullptr) {
+        casos.push_back(Caso{nombre, tamano, false, ejecutar, preparar, nullptr});
+    }
+
+    void registrarParalelo(const std::string& nombre, double tamano, Funcion ejecutar, Funcion preparar = nullptr) {
+        casos.push_back(Caso{nombre, tamano, true, ejecutar, preparar, nullptr});
+    }
+
+    // La fábrica devuelve el kernel para un problema de tamanoPorHilo * hilos;
+    // el tamaño se registra solo para la salida
+    void registrarEscaladoDebil(const std::string& nombre, double tamanoPorHilo, FabricaEscalado fabrica) {
+        casos.push_back(Caso{nombre, tamanoPorHilo, true, nullptr, nullptr, fabrica});
+    }
+
+    // Bytes y flops nominales por ejecución de los casos con ese nombre; en el
+    // escalado débil son por hilo y se multiplican por el número de hilos
+    void asignarCarga(const std::string& nombre, double bytes, double flops) {
+        for (Caso& caso : casos) {
+            if (caso.nombre == nombre) {
+                caso.bytes = bytes;
+                caso.flops = flops;
+            }
+        }
+    }
+
+    // Mide todos los casos registrados en orden, imprime la tabla y escribe los
+    // archivos pedidos. Devuelve false si no se pudo escribir algún archivo
+    bool ejecutar() {
+        resultados.clear();
+        for (const Caso& caso : casos) {
+            if (caso.fabrica) {
+                if (opciones.barrido) medirEscaladoDebil(caso);
+            } else if (caso.paralelo && opciones.barrido) {
+                medirEscaladoFuerte(caso);
+            } else {
+                ResultadoMedicion r = filaBase(caso, "unico", caso.paralelo ? hilosMaximos : 1);
+                r.tiempo = medir(caso.ejecutar, caso.preparar);
+                r.hardware = medirContadores(caso.ejecutar, caso.preparar, r.hilos);
+                resultados.push_back(r);
+            }
+        }
+
+        // Aceleración de los casos sin barrido respecto al primero registrado
+        const ResultadoMedicion* referencia = buscar(casos.empty() ? "" : casos.front().nombre, hilosMaximos);
+        for (ResultadoMedicion& r : resultados) {
+            if (r.escalado == "unico" && referencia) {
+                r.aceleracion = cocienteTiempos(referencia->tiempo.mediana, r.tiempo.mediana);
+            }
+        }
+
+        imprimir();
+        imprimirContadores();
+        bool correcto = true;
+        if (!opciones.archivoJson.empty()) correcto = escribirJson(opciones.archivoJson) && correcto;
+        if (!opciones.archivoCsv.empty()) correcto = escribirCsv(opciones.archivoCsv) && correcto;
+        return correcto;
+    }
+
+    // Resultado de un caso ya medido (nullptr si no existe); si se midió con
+    // barrido se devuelve la fila con el número de hilos pedido
+    const ResultadoMedicion* buscar(const std::string& nombre, int hilos) const {
+        const ResultadoMedicion* encontrado = nullptr;
+        for (const ResultadoMedicion& r : resultados) {
+            if (r.caso != nombre || r.escalado == "debil") continue;
+            if (r.escalado == "unico" || r.hilos == hilos) encontrado = &r;
+        }
+        return encontrado;
+    }
+
+    // Mediana en ms de un caso (0 si no se midió)
+    double mediana(const std::string& nombre) const {
+        const ResultadoMedicion* r = buscar(nombre, hilosMaximos);
+        return r ? r->tiempo.mediana : 0.0;
+    }
+
+    const std::vector<ResultadoMedicion>& obtenerResultados() const { return resultados; }
+
+private:
+    struct Caso {
+        std::string nombre;
+        double tamano;
+        bool paralelo;
+        Funcion ejecutar;
+        Funcion preparar;
+        FabricaEscalado fabrica;
+        double bytes = 0.0;
+        double flops = 0.0;
+    };
+
+    std::string programa;
+    OpcionesMedicion opciones;
+    int hilosMaximos;
+    std::vector<Caso> casos;
+    std::vector<ResultadoMedicion> resultados;
+    ContadoresHardware contadores;
+    bool contadoresFallidos = false;
+
+    ResultadoMedicion filaBase(const Caso& caso, const char* escalado, int hilos) const {
+        ResultadoMedicion r;
+        r.caso = caso.nombre;
+        r.escalado = escalado;
+        r.hilos = hilos;
+        r.tamano = caso.tamano;
+        r.bytes = caso.bytes;
+        r.flops = caso.flops;
+        return r;
+    }
+
+    // Calentamiento + repeticiones; cada ejecución se mide por separado con un
+    // reloj monótono. El calentamiento evita que el primer caso pague los fallos
+    // de página y de caché que los siguientes ya no pagan
+    EstadisticasTiempo medir(const Funcion& ejecutar, const Funcion& preparar) const {
+        for (int i = 0; i < opciones.calentamiento; ++i) {
+            if (preparar) preparar();
+            ejecutar();
+        }
+        std::vector<double> muestras;
+        muestras.reserve(opciones.repeticiones);
+        for (int i = 0; i < opciones.repeticiones; ++i) {
+            if (preparar) preparar();
+            auto inicio = std::chrono::steady_clock::now();
+            ejecutar();
+            auto fin = std::chrono::steady_clock::now();
+            muestras.push_back(std::chrono::duration<double, std::milli>(fin - inicio).count());
+        }
+        return calcularEstadisticas(muestras);
+    }
+
+    // Una ejecución adicional con contadores en los hilos 0..hilos-1. Los grupos
+    // se abren para cada medición (el equipo de hilos puede cambiar entre casos);
+    // si no se pueden abrir se avisa una vez y no se vuelve a intentar
+    MetricasHardware medirContadores(const Funcion& ejecutar, const Funcion& preparar, int hilos) {
+        if (!opciones.contadores || contadoresFallidos) return MetricasHardware();
+        if (!contadores.abrir(hilos)) {
+            contadoresFallidos = true;
+            std::cerr << "Contadores de hardware no disponibles (" << contadores.error()
+                      << "); se muestran solo tiempos" << std::endl;
+            return MetricasHardware();
+        }
+        if (preparar) preparar();
+        contadores.iniciar();
+        ejecutar();
+        MetricasHardware metricas = contadores.detener();
+        contadores.cerrar();
+        return metricas;
+    }
+
+    // Números de hilos del barrido: potencias de dos y el máximo
+    std::vector<int> hilosBarrido() const {
+        std::vector<int> hilos;
+        for (int h = 1; h < hilosMaximos; h *= 2) hilos.push_back(h);
+        hilos.push_back(hilosMaximos);
+        return hilos;
+    }
+
+    void medirEscaladoFuerte(const Caso& caso) {
+        double tiempoUnHilo = 0.0;
+        for (int h : hilosBarrido()) {
+            omp_set_num_threads(h);
+            ResultadoMedicion r = filaBase(caso, "fuerte", h);
+            r.tiempo = medir(caso.ejecutar, caso.preparar);
+            r.hardware = medirContadores(caso.ejecutar, caso.preparar, h);
+            if (h == 1) tiempoUnHilo = r.tiempo.mediana;
+            r.aceleracion = cocienteTiempos(tiempoUnHilo, r.tiempo.mediana);
+            r.eficiencia = r.aceleracion / h;
+            resultados.push_back(r);
+        }
+        omp_set_num_threads(hilosMaximos);
+    }
+
+    void medirEscaladoDebil(const Caso& caso) {
+        double tiempoUnHilo = 0.0;
+        for (int h : hilosBarrido()) {
+            omp_set_num_threads(h);
+            Funcion ejecutar = caso.fabrica(h);
+            ResultadoMedicion r = filaBase(caso, "debil", h);
+            r.tamano = caso.tamano * h;
+            r.bytes = caso.bytes * h;
+            r.flops = caso.flops * h;
+            r.tiempo = medir(ejecutar, nullptr);
+            r.hardware = medirContadores(ejecutar, nullptr, h);
+            if (h == 1) tiempoUnHilo = r.tiempo.mediana;
+            // Con escalado débil ideal el tiempo no cambia: la aceleración escalada
+            // es h * t(1) / t(h) y la eficiencia t(1) / t(h)
+            r.eficiencia = cocienteTiempos(tiempoUnHilo, r.tiempo.mediana);
+            r.aceleracion = r.eficiencia * h;
+            resultados.push_back(r);
+        }
+        omp_set_num_threads(hilosMaximos);
+    }
+
+    static std::string formatearCociente(double valor) {
+        if (valor <= 0.0) return "n/d";
+        std::ostringstream texto;
+        texto << std::fixed << std::setprecision(2) << valor << "x";
+        return texto.str();
+    }
+
+    void imprimir() const {
+        std::cout << "Medición (" << opciones.calentamiento << " de calentamiento, "
+                  << opciones.repeticiones << " repeticiones, tiempos en ms):" << std::endl;
+        std::cout << std::left << std::setw(34) << "  caso" << std::setw(8) << "escala" << std::right
+                  << std::setw(6) << "hilos" << std::setw(12) << "mediana" << std::setw(12) << "p95"
+                  << std::setw(11) << "desv." << std::setw(12) << "acel." << std::setw(8) << "efic." << std::endl;
+        std::ios::fmtflags formato = std::cout.flags();
+        std::streamsize precision = std::cout.precision();
+        for (const ResultadoMedicion& r : resultados) {
+            std::cout << "  " << std::left << std::setw(32) << r.caso << std::setw(8) << r.escalado << std::right
+                      << std::setw(6) << r.hilos << std::fixed << std::setprecision(3)
+                      << std::setw(12) << r.tiempo.mediana << std::setw(12) << r.tiempo.p95
+                      << std::setw(11) << r.tiempo.desviacion
+                      << std::setw(12) << formatearCociente(r.aceleracion);
+            if (r.escalado != "unico") std::cout << std::setw(8) << std::setprecision(2) << r.eficiencia;
+            std::cout << std::endl;
+        }
+        std::cout.flags(formato);
+        std::cout.precision(precision);
+    }
+
+    // Métricas derivadas de los contadores: IPC, fallos de LLC y de predicción de
+    // saltos (millones), porcentaje de ciclos parados, desequilibrio de ciclos
+    // entre hilos, y bytes/flop nominales y medidos (fallos de LLC x 64 bytes)
+    void imprimirContadores() const {
+        bool alguno = false;
+        for (const ResultadoMedicion& r : resultados) alguno = alguno || r.hardware.disponibles;
+        if (!alguno) return;
+
+        auto columna = [](bool disponible, double valor, int precision) {
+            std::ostringstream texto;
+            if (disponible) {
+                texto << std::fixed << std::setprecision(precision) << valor;
+            } else {
+                texto << "-";
+            }
+            return texto.str();
+        };
+        std::cout << "Contadores de hardware (una ejecución por caso):" << std::endl;
+        std::cout << std::left << std::setw(34) << "  caso" << std::setw(8) << "escala" << std::right
+                  << std::setw(6) << "hilos" << std::setw(8) << "IPC" << std::setw(12) << "LLC (M)"
+                  << std::setw(12) << "ramas (M)" << std::setw(10) << "parado%" << std::setw(9) << "deseq."
+                  << std::setw(11) << "B/flop" << std::setw(11) << "B LLC/flop" << std::endl;
+        for (const ResultadoMedicion& r : resultados) {
+            if (!r.hardware.disponibles) continue;
+            const MetricasHardware& m = r.hardware;
+            double ciclos = m.total[EVENTO_CICLOS];
+            std::cout << "  " << std::left << std::setw(32) << r.caso << std::setw(8) << r.escalado << std::right
+                      << std::setw(6) << r.hilos
+                      << std::setw(8) << columna(m.evento[EVENTO_INSTRUCCIONES], m.ipc(), 2)
+                      << std::setw(12) << columna(m.evento[EVENTO_FALLOS_LLC], m.total[EVENTO_FALLOS_LLC] / 1e6, 2)
+                      << std::setw(12) << columna(m.evento[EVENTO_FALLOS_RAMA], m.total[EVENTO_FALLOS_RAMA] / 1e6, 2)
+                      << std::setw(10) << columna(m.evento[EVENTO_CICLOS_PARADOS] && ciclos > 0.0,
+                                                  100.0 * cocienteTiempos(m.total[EVENTO_CICLOS_PARADOS], ciclos), 1)
+                      << std::setw(9) << columna(true, m.desequilibrio, 2)
+                      << std::setw(11) << columna(r.flops > 0.0, cocienteTiempos(r.bytes, r.flops), 3)
+                      << std::setw(11) << columna(r.flops > 0.0 && m.evento[EVENTO_FALLOS_LLC],
+                                                  cocienteTiempos(64.0 * m.total[EVENTO_FALLOS_LLC], r.flops), 3)
+                      << std::endl;
+        }
+    }
+
+    static std::string escaparJson(const std::string& texto) {
+        std::string salida;
+        for (char c : texto) {
+            if (c == '"' || c == '\\') salida += '\\';
+            salida += c;
+        }
+        return salida;
+    }
+
+    bool escribirJson(const std::string& ruta) const {
+        std::ofstream archivo(ruta);
+        if (!archivo) {
+            std::cerr << "No se pudo abrir " << ruta << std::endl;
+            return false;
+        }
+        archivo << std::setprecision(9);
+        archivo << "{\n  \"programa\": \"" << escaparJson(programa) << "\",\n"
+                << "  \"calentamiento\": " << opciones.calentamiento << ",\n"
+                << "  \"repeticiones\": " << opciones.repeticiones << ",\n"
+                << "  \"semilla\": " << opciones.semilla << ",\n"
+                << "  \"hilos_maximos\": " << hilosMaximos << ",\n"
+                << "  \"resultados\": [";
+        for (size_t i = 0; i < resultados.size(); ++i) {
+            const ResultadoMedicion& r = resultados[i];
+            archivo << (i ? ",\n" : "\n")
+                    << "    {\"caso\": \"" << escaparJson(r.caso) << "\", \"escalado\": \"" << r.escalado
+                    << "\", \"hilos\": " << r.hilos << ", \"tamano\": " << r.tamano
+                    << ", \"mediana_ms\": " << r.tiempo.mediana << ", \"p95_ms\": " << r.tiempo.p95
+                    << ", \"media_ms\": " << r.tiempo.media << ", \"desviacion_ms\": " << r.tiempo.desviacion
+                    << ", \"minimo_ms\": " << r.tiempo.minimo << ", \"maximo_ms\": " << r.tiempo.maximo
+                    << ", \"aceleracion\": " << r.aceleracion << ", \"eficiencia\": " << r.eficiencia
+                    << ", \"bytes\": " << r.bytes << ", \"flops\": " << r.flops;
+            if (r.hardware.disponibles) {
+                const MetricasHardware& m = r.hardware;
+                archivo << ", \"contadores\": {\"ciclos\": " << m.total[EVENTO_CICLOS]
+                        << ", \"instrucciones\": " << m.total[EVENTO_INSTRUCCIONES]
+                        << ", \"fallos_llc\": " << m.total[EVENTO_FALLOS_LLC]
+                        << ", \"fallos_rama\": " << m.total[EVENTO_FALLOS_RAMA]
+                        << ", \"ciclos_parados\": " << m.total[EVENTO_CICLOS_PARADOS]
+                        << ", \"ipc\": " << m.ipc() << ", \"desequilibrio\": " << m.desequilibrio << "}";
+            }
+            archivo << "}";
+        }
+        archivo << "\n  ]\n}\n";
+        return static_cast<bool>(archivo);
+    }
+
+    bool escribirCsv(const std::string& ruta) const {
+        std::ofstream archivo(ruta);
+        if (!archivo) {
+            std::cerr << "No se pudo abrir " << ruta << std::endl;
+            return false;
+        }
+        archivo << std::setprecision(9);
+        archivo << "programa,caso,escalado,hilos,tamano,repeticiones,mediana_ms,p95_ms,media_ms,"
+                   "desviacion_ms,minimo_ms,maximo_ms,aceleracion,eficiencia,bytes,flops,"
+                   "ciclos,instrucciones,fallos_llc,fallos_rama,ciclos_parados,ipc,desequilibrio\n";
+        for (const ResultadoMedicion& r : resultados) {
+            archivo << programa << ",\"" << r.caso << "\"," << r.escalado << "," << r.hilos << "," << r.tamano
+                    << "," << opciones.repeticiones << "," << r.tiempo.mediana << "," << r.tiempo.p95
+                    << "," << r.tiempo.media << "," << r.tiempo.desviacion << "," << r.tiempo.minimo
+                    << "," << r.tiempo.maximo << "," << r.aceleracion << "," << r.eficiencia
+                    << "," << r.bytes << "," << r.flops;
+            // Sin contadores las columnas quedan vacías
+            const MetricasHardware& m = r.hardware;
+            for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) {
+                archivo << ",";
+                if (m.disponibles && m.evento[e]) archivo << m.total[e];
+            }
+            archivo << ",";
+            if (m.disponibles) archivo << m.ipc();
+            archivo << ",";
+            if (m.disponibles) archivo << m.desequilibrio;
+            archivo << "\n";
+        }
+        return static_cast<bool>(archivo);
+    }
+};
+
+#endif // MEDICION_H
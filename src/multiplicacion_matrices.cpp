@@ -1,44 +1,66 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
-#include <random>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <memory>
 #include <omp.h>
+#include "matriz2d.h"
+#include "medicion.h"
+#include "nucleos/generacion.h"
+#include "nucleos/matrices.h"
 
+// T es el tipo de elemento (double o float); con float las entradas son las
+// de double redondeadas y los kernels mueven la mitad de bytes
+template <typename T>
 class MultiplicadorMatrices {
 private:
-    std::vector<std::vector<double>> matrizA;
-    std::vector<std::vector<double>> matrizB;
-    std::vector<std::vector<double>> resultado;
+    Matriz2D<T> matrizA;
+    Matriz2D<T> matrizB;
+    Matriz2D<T> resultado;
     size_t tamano;
 
-    // Inicializa una matriz con valores aleatorios
-    void inicializarMatriz(std::vector<std::vector<double>>& matriz) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> dis(0.0, 1.0);
+    // Genera una matriz en paralelo por filas con valores uniformes en [0, 1)
+    void inicializarMatriz(Matriz2D<T>& matriz, uint64_t semilla) {
+        generarUniforme(matriz.vista(), 0.0, 1.0, semilla);
+    }
 
-        for (auto& fila : matriz) {
-            for (auto& elemento : fila) {
-                elemento = dis(gen);
+    // Producto ingenuo i-j-k paralelo, común a ambas disposiciones de memoria
+    // (ambas admiten la sintaxis m[i][j]) para poder compararlas con el mismo código.
+    // Cada elemento se acumula en double, también con float
+    template <typename MatrizEntrada, typename MatrizSalida>
+    static void multiplicarIngenuo(const MatrizEntrada& a, const MatrizEntrada& b, MatrizSalida& c, size_t n) {
+        #pragma omp parallel for collapse(2)
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double suma = 0.0;
+                for (size_t k = 0; k < n; ++k) {
+                    suma += a[i][k] * b[k][j];
+                }
+                c[i][j] = suma;
             }
         }
     }
 
 public:
     // Constructor: inicializa las matrices con un tamaño dado
-    MultiplicadorMatrices(size_t n) : tamano(n),
-        matrizA(n, std::vector<double>(n)),
-        matrizB(n, std::vector<double>(n)),
-        resultado(n, std::vector<double>(n, 0.0)) {
-        inicializarMatriz(matrizA);
-        inicializarMatriz(matrizB);
+    MultiplicadorMatrices(size_t n, uint64_t semilla) : matrizA(n, n),
+        matrizB(n, n),
+        resultado(n, n, T(0)),
+        tamano(n) {
+        inicializarMatriz(matrizA, semilla);
+        inicializarMatriz(matrizB, semilla + 1);
     }
 
     // Realiza la multiplicación de matrices de forma secuencial
     void multiplicarSecuencial() {
         for (size_t i = 0; i < tamano; ++i) {
             for (size_t j = 0; j < tamano; ++j) {
-                resultado[i][j] = 0.0;
+                resultado[i][j] = T(0);
                 for (size_t k = 0; k < tamano; ++k) {
                     resultado[i][j] += matrizA[i][k] * matrizB[k][j];
                 }
@@ -54,7 +76,7 @@ public:
         #pragma omp parallel for collapse(2)
         for (size_t i = 0; i < tamano; ++i) {
             for (size_t j = 0; j < tamano; ++j) {
-                resultado[i][j] = 0.0;
+                resultado[i][j] = T(0);
                 for (size_t k = 0; k < tamano; ++k) {
                     resultado[i][j] += matrizA[i][k] * matrizB[k][j];
                 }
@@ -62,9 +84,39 @@ public:
         }
     }
 
+    // Realiza la multiplicación por bloques con el GEMM estilo BLIS de la
+    // biblioteca de núcleos, directamente sobre las matrices (sin copias)
+    void multiplicarBloques() {
+        ::multiplicarBloques<T>(matrizA.vista(), matrizB.vista(), resultado.vista());
+    }
+
+    // GEMM por bloques con las entradas en T y C acumulada en double (con T
+    // float, el producto de precisión mixta)
+    void multiplicarBloquesMixto(Matriz2D<double>& c) {
+        ::multiplicarBloques<T, double>(matrizA.vista(), matrizB.vista(), c.vista());
+    }
+
+    const Matriz2D<T>& obtenerResultado() const { return resultado; }
+
+    // Producto recursivo con tareas de la biblioteca de núcleos (independiente de la caché)
+    void multiplicarRecursivo() {
+        ::multiplicarRecursivo<T>(matrizA.vista(), matrizB.vista(), resultado.vista());
+    }
+
+    // El mismo producto recursivo con el planificador de robo de trabajo
+    void multiplicarRecursivoRobo() {
+        ::multiplicarRecursivo<T, TareasRobo>(matrizA.vista(), matrizB.vista(), resultado.vista());
+    }
+
+    // Producto recursivo con un nivel de Strassen-Winograd en los subproblemas
+    // cuya menor dimensión alcanza UMBRAL_STRASSEN
+    void multiplicarStrassen() {
+        ::multiplicarRecursivo<T>(matrizA.vista(), matrizB.vista(), resultado.vista(), UMBRAL_STRASSEN);
+    }
+
     // Verifica si el resultado de la multiplicación paralela es correcto
     bool verificarResultado() {
-        std::vector<std::vector<double>> resultadoSecuencial(tamano, std::vector<double>(tamano, 0.0));
+        Matriz2D<T> resultadoSecuencial(tamano, tamano, T(0));
         for (size_t i = 0; i < tamano; ++i) {
             for (size_t j = 0; j < tamano; ++j) {
                 for (size_t k = 0; k < tamano; ++k) {
@@ -75,29 +127,268 @@ public:
         return resultadoSecuencial == resultado;
     }
 
-    // Ejecuta y mide el tiempo de las versiones secuencial y paralela
-    void ejecutar() {
+    // Verifica el resultado contra una referencia con tolerancia relativa, ya
+    // que el GEMM por bloques y el recursivo suman los productos en otro orden
+    // (y Strassen además resta productos parciales); unos 4096 épsilon de T por
+    // término sumado
+    bool verificarConTolerancia(const Matriz2D<T>& referencia) {
+        const double tolerancia = 4096 * std::numeric_limits<T>::epsilon() * static_cast<double>(tamano);
+        for (size_t i = 0; i < tamano; ++i) {
+            for (size_t j = 0; j < tamano; ++j) {
+                double diferencia = std::abs(resultado[i][j] - referencia[i][j]);
+                if (diferencia > tolerancia * std::max(1.0, std::abs(referencia[i][j]))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Calcula el rendimiento en GFLOP/s (2n^3 operaciones en punto flotante)
+    double calcularGflops(double segundos) {
+        double n = static_cast<double>(tamano);
+        return segundos > 0.0 ? 2.0 * n * n * n / segundos * 1e-9 : 0.0;
+    }
+
+    // Mide las versiones secuencial, paralela, por bloques, recursiva (con
+    // tareas de OpenMP y con robo de trabajo) y con Strassen con el arnés común;
+    // con --barrido añade el escalado fuerte y el débil (n^3 proporcional a los
+    // hilos). El tamaño registrado es n^3 (multiplicaciones-suma)
+    bool ejecutar(const OpcionesMedicion& opciones) {
+        const double trabajo = static_cast<double>(tamano) * tamano * tamano;
+        std::cout << "Tamaño de la matriz: " << tamano << "x" << tamano << std::endl;
+        std::cout << "Micro-kernel seleccionado: " << seleccionarMicroKernel<T>().nombre << std::endl;
+
+        ArnesMedicion arnes("multiplicacion_matrices", opciones);
+        arnes.registrar("secuencial", trabajo, [&] { multiplicarSecuencial(); });
+        arnes.registrarParalelo("paralelo", trabajo, [&] { multiplicarParalelo(); });
+        arnes.registrarParalelo("bloques", trabajo, [&] { multiplicarBloques(); });
+        arnes.registrarParalelo("recursivo", trabajo, [&] { multiplicarRecursivo(); });
+        arnes.registrarParalelo("recursivo-robo", trabajo, [&] { multiplicarRecursivoRobo(); });
+        arnes.registrarParalelo("strassen", trabajo, [&] { multiplicarStrassen(); });
+        const double porHilo = trabajo / omp_get_max_threads();
+        const uint64_t semilla = opciones.semilla;
+        arnes.registrarEscaladoDebil("bloques", porHilo, [porHilo, semilla](int hilos) {
+            size_t n = std::max<size_t>(static_cast<size_t>(std::cbrt(porHilo * hilos) + 0.5), 1);
+            auto multiplicador = std::make_shared<MultiplicadorMatrices>(n, semilla);
+            return [multiplicador] { multiplicador->multiplicarBloques(); };
+        });
+        // Tráfico mínimo: leer A y B y escribir C una vez; 2n^3 flops
+        const double bytesMinimos = 3.0 * sizeof(T) * tamano * tamano;
+        for (const char* caso : {"secuencial", "paralelo", "bloques", "recursivo", "recursivo-robo", "strassen"}) {
+            arnes.asignarCarga(caso, bytesMinimos, 2.0 * trabajo);
+        }
+        bool escrito = arnes.ejecutar();
+
+        std::cout << "Rendimiento (mediana): secuencial " << calcularGflops(arnes.mediana("secuencial") / 1e3)
+                  << " GFLOP/s, paralelo " << calcularGflops(arnes.mediana("paralelo") / 1e3)
+                  << " GFLOP/s, bloques " << calcularGflops(arnes.mediana("bloques") / 1e3)
+                  << " GFLOP/s, recursivo " << calcularGflops(arnes.mediana("recursivo") / 1e3)
+                  << " GFLOP/s, recursivo-robo " << calcularGflops(arnes.mediana("recursivo-robo") / 1e3)
+                  << " GFLOP/s, strassen " << calcularGflops(arnes.mediana("strassen") / 1e3) << " GFLOP/s"
+                  << " (GFLOP/s equivalentes a 2n^3)" << std::endl;
+
+        // El producto ingenuo se verifica exactamente y sirve de referencia
+        // para las versiones que suman en otro orden
+        multiplicarParalelo();
+        std::cout << "Resultado correcto: " << (verificarResultado() ? "Sí" : "No") << std::endl;
+        Matriz2D<T> referencia = resultado;
+        multiplicarBloques();
+        std::cout << "Resultado correcto (bloques): " << (verificarConTolerancia(referencia) ? "Sí" : "No") << std::endl;
+        multiplicarRecursivo();
+        std::cout << "Resultado correcto (recursivo): " << (verificarConTolerancia(referencia) ? "Sí" : "No") << std::endl;
+        multiplicarRecursivoRobo();
+        std::cout << "Resultado correcto (recursivo-robo): " << (verificarConTolerancia(referencia) ? "Sí" : "No") << std::endl;
+        multiplicarStrassen();
+        std::cout << "Resultado correcto (strassen): " << (verificarConTolerancia(referencia) ? "Sí" : "No") << std::endl;
+        return escrito;
+    }
+
+    // Compara la disposición antigua (un std::vector por fila) con Matriz2D:
+    // mide la construcción de las tres matrices y el producto ingenuo paralelo
+    void compararDisposiciones() {
         auto inicio = std::chrono::high_resolution_clock::now();
-        multiplicarSecuencial();
+        std::vector<std::vector<T>> aFilas(tamano, std::vector<T>(tamano));
+        std::vector<std::vector<T>> bFilas(tamano, std::vector<T>(tamano));
+        std::vector<std::vector<T>> cFilas(tamano, std::vector<T>(tamano, T(0)));
         auto fin = std::chrono::high_resolution_clock::now();
-        auto duracionSecuencial = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
+        double construccionFilas = std::chrono::duration<double, std::milli>(fin - inicio).count();
 
         inicio = std::chrono::high_resolution_clock::now();
-        multiplicarParalelo();
+        Matriz2D<T> aContigua(tamano, tamano);
+        Matriz2D<T> bContigua(tamano, tamano);
+        Matriz2D<T> cContigua(tamano, tamano, T(0));
         fin = std::chrono::high_resolution_clock::now();
-        auto duracionParalelo = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
+        double construccionContigua = std::chrono::duration<double, std::milli>(fin - inicio).count();
 
-        std::cout << "Tamaño de la matriz: " << tamano << "x" << tamano << std::endl;
-        std::cout << "Tiempo de ejecución (secuencial): " << duracionSecuencial << " ms" << std::endl;
-        std::cout << "Tiempo de ejecución (paralelo): " << duracionParalelo << " ms" << std::endl;
-        std::cout << "Aceleración: " << static_cast<double>(duracionSecuencial) / duracionParalelo << "x" << std::endl;
-        std::cout << "Resultado correcto: " << (verificarResultado() ? "Sí" : "No") << std::endl;
+        for (size_t i = 0; i < tamano; ++i) {
+            for (size_t j = 0; j < tamano; ++j) {
+                aFilas[i][j] = aContigua[i][j] = matrizA[i][j];
+                bFilas[i][j] = bContigua[i][j] = matrizB[i][j];
+            }
+        }
+
+        inicio = std::chrono::high_resolution_clock::now();
+        multiplicarIngenuo(aFilas, bFilas, cFilas, tamano);
+        fin = std::chrono::high_resolution_clock::now();
+        double productoFilas = std::chrono::duration<double, std::milli>(fin - inicio).count();
+
+        inicio = std::chrono::high_resolution_clock::now();
+        multiplicarIngenuo(aContigua, bContigua, cContigua, tamano);
+        fin = std::chrono::high_resolution_clock::now();
+        double productoContigua = std::chrono::duration<double, std::milli>(fin - inicio).count();
+
+        bool iguales = true;
+        for (size_t i = 0; i < tamano && iguales; ++i) {
+            for (size_t j = 0; j < tamano; ++j) {
+                if (cFilas[i][j] != cContigua[i][j]) {
+                    iguales = false;
+                    break;
+                }
+            }
+        }
+
+        std::cout << "Tamaño de la matriz: " << tamano << "x" << tamano
+                  << " (stride contiguo: " << cContigua.stride() << ")" << std::endl;
+        std::cout << "Construcción (vector de vectores): " << construccionFilas << " ms" << std::endl;
+        std::cout << "Construcción (Matriz2D):           " << construccionContigua << " ms" << std::endl;
+        std::cout << "Producto (vector de vectores):     " << productoFilas << " ms" << std::endl;
+        std::cout << "Producto (Matriz2D):               " << productoContigua << " ms" << std::endl;
+        std::cout << "Aceleración del producto: " << productoFilas / productoContigua << "x" << std::endl;
+        std::cout << "Resultados idénticos: " << (iguales ? "Sí" : "No") << std::endl;
     }
 };
 
-int main() {
+// Modo "lote": multiplica numero pares de matrices tamano x tamano guardadas
+// una tras otra. Compara una llamada al GEMM por bloques por matriz (cada una
+// abre su región paralela y empaqueta sus paneles), un bucle paralelo con el
+// producto de tamaño variable y una sola llamada a multiplicarLote, que usa el
+// núcleo de tamaño fijo en compilación para 4, 8, 16, 32 y 64
+bool ejecutarLote(size_t tamano, size_t numero, const OpcionesMedicion& opciones) {
+    const size_t elementos = tamano * tamano;
+    VectorNuma<double> a(numero * elementos), b(numero * elementos), c(numero * elementos);
+    generarUniforme(vista(a), 0.0, 1.0, opciones.semilla);
+    generarUniforme(vista(b), 0.0, 1.0, opciones.semilla + 1);
+    std::vector<double> referencia(numero * elementos);
+    for (size_t l = 0; l < numero; ++l) {
+        productoVariable(tamano, tamano, tamano, &a[l * elementos], &b[l * elementos], &referencia[l * elementos]);
+    }
+    auto matriz = [&](VectorNuma<double>& m, size_t l) {
+        return VistaTile<double>{&m[l * elementos], tamano, tamano, tamano};
+    };
+
+    std::cout << "Lote: " << numero << " productos de " << tamano << "x" << tamano << std::endl;
+    const double trabajo = static_cast<double>(numero) * elementos * tamano;
+    ArnesMedicion arnes("multiplicacion_matrices_lote", opciones);
+    arnes.registrarParalelo("bloques por matriz", trabajo, [&] {
+        for (size_t l = 0; l < numero; ++l) {
+            multiplicarBloques<double>(matriz(a, l), matriz(b, l), matriz(c, l));
+        }
+    });
+    arnes.registrarParalelo("bucle por matriz", trabajo, [&] {
+        // Justificación: Los productos del lote son independientes
+        #pragma omp parallel for schedule(static)
+        for (size_t l = 0; l < numero; ++l) {
+            productoVariable(tamano, tamano, tamano, &a[l * elementos], &b[l * elementos], &c[l * elementos]);
+        }
+    });
+    arnes.registrarParalelo("lote", trabajo, [&] { multiplicarLote(tamano, tamano, tamano, vista(a), vista(b), vista(c)); });
+    for (const char* caso : {"bloques por matriz", "bucle por matriz", "lote"}) {
+        arnes.asignarCarga(caso, 3.0 * sizeof(double) * numero * elementos, 2.0 * trabajo);
+    }
+    bool escrito = arnes.ejecutar();
+
+    bool correcto = true;
+    for (size_t i = 0; i < c.size() && correcto; ++i) {
+        correcto = std::abs(c[i] - referencia[i]) <= 1e-12 * static_cast<double>(tamano) * std::max(1.0, referencia[i]);
+    }
+    std::cout << "Resultado correcto (lote): " << (correcto ? "Sí" : "No") << std::endl;
+    return escrito && correcto;
+}
+
+// Modo "precision": el GEMM por bloques con double, con float y con entradas
+// float acumuladas en double, sobre las mismas matrices (las de float son las
+// de double redondeadas). El error de cada variante se mide respecto al
+// producto en double: con entradas float el redondeo de las entradas es común
+// a ambas variantes y la acumulación en double solo elimina el de las sumas
+bool ejecutarPrecision(size_t tamano, const OpcionesMedicion& opciones) {
+    MultiplicadorMatrices<double> doble(tamano, opciones.semilla);
+    MultiplicadorMatrices<float> simple(tamano, opciones.semilla);
+    Matriz2D<double> mixto(tamano, tamano, 0.0);
+
+    const double trabajo = static_cast<double>(tamano) * tamano * tamano;
+    std::cout << "Tamaño de la matriz: " << tamano << "x" << tamano << std::endl;
+    std::cout << "Micro-kernels: double " << seleccionarMicroKernel<double>().nombre << ", float "
+              << seleccionarMicroKernel<float>().nombre << " (float->double empaqueta a double y usa el de double)"
+              << std::endl;
+    ArnesMedicion arnes("multiplicacion_matrices_precision", opciones);
+    arnes.registrarParalelo("bloques double", trabajo, [&] { doble.multiplicarBloques(); });
+    arnes.registrarParalelo("bloques float", trabajo, [&] { simple.multiplicarBloques(); });
+    arnes.registrarParalelo("bloques float->double", trabajo, [&] { simple.multiplicarBloquesMixto(mixto); });
+    const double elementos = static_cast<double>(tamano) * tamano;
+    arnes.asignarCarga("bloques double", 3.0 * sizeof(double) * elementos, 2.0 * trabajo);
+    arnes.asignarCarga("bloques float", 3.0 * sizeof(float) * elementos, 2.0 * trabajo);
+    arnes.asignarCarga("bloques float->double", (2.0 * sizeof(float) + sizeof(double)) * elementos, 2.0 * trabajo);
+    bool escrito = arnes.ejecutar();
+
+    // Error relativo máximo por elemento respecto al producto en double
+    const Matriz2D<double>& referencia = doble.obtenerResultado();
+    auto errorMaximo = [&](auto& c) {
+        double error = 0.0;
+        for (size_t i = 0; i < tamano; ++i) {
+            for (size_t j = 0; j < tamano; ++j) {
+                error = std::max(error, std::abs(c[i][j] - referencia[i][j]) / std::abs(referencia[i][j]));
+            }
+        }
+        return error;
+    };
+    const double tiempoDoble = arnes.mediana("bloques double");
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Rendimiento (mediana): double " << doble.calcularGflops(tiempoDoble / 1e3) << " GFLOP/s, float "
+              << doble.calcularGflops(arnes.mediana("bloques float") / 1e3) << " GFLOP/s, float->double "
+              << doble.calcularGflops(arnes.mediana("bloques float->double") / 1e3) << " GFLOP/s" << std::endl;
+    std::cout << "Aceleración respecto a double: float "
+              << cocienteTiempos(tiempoDoble, arnes.mediana("bloques float")) << "x, float->double "
+              << cocienteTiempos(tiempoDoble, arnes.mediana("bloques float->double")) << "x" << std::endl;
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "Error relativo máximo respecto a double: float " << errorMaximo(simple.obtenerResultado())
+              << ", float->double " << errorMaximo(mixto) << " (épsilon de float: "
+              << std::numeric_limits<float>::epsilon() << ")" << std::endl;
+    std::cout << std::defaultfloat;
+    return escrito;
+}
+
+int main(int argc, char* argv[]) {
     const size_t TAMANO_MATRIZ = 1000;
-    MultiplicadorMatrices multiplicador(TAMANO_MATRIZ);
-    multiplicador.ejecutar();
+    OpcionesMedicion opciones;
+    if (!extraerOpcionesMedicion(argc, argv, opciones)) return 1;
+    // Modo "lote": productos de muchas matrices pequeñas por llamada
+    //   lote [tamano] [numero]
+    if (argc > 1 && std::string(argv[1]) == "lote") {
+        size_t tamano = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+        size_t numero = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10000;
+        if (tamano == 0 || numero == 0) {
+            std::cerr << "Uso: " << argv[0] << " lote [tamano] [numero]" << std::endl;
+            return 1;
+        }
+        return ejecutarLote(tamano, numero, opciones) ? 0 : 1;
+    }
+    // Modo "precision": GEMM en double, float y float con acumulación en double
+    //   precision [tamano]
+    if (argc > 1 && std::string(argv[1]) == "precision") {
+        size_t tamano = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : TAMANO_MATRIZ;
+        if (tamano == 0) {
+            std::cerr << "Uso: " << argv[0] << " precision [tamano]" << std::endl;
+            return 1;
+        }
+        return ejecutarPrecision(tamano, opciones) ? 0 : 1;
+    }
+    MultiplicadorMatrices<double> multiplicador(TAMANO_MATRIZ, opciones.semilla);
+    // Modo "disposicion": compara vector<vector<double>> con Matriz2D
+    if (argc > 1 && std::string(argv[1]) == "disposicion") {
+        multiplicador.compararDisposiciones();
+    } else {
+        return multiplicador.ejecutar(opciones) ? 0 : 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,16 @@
+#ifndef MULTIVERSION_H
+#define MULTIVERSION_H
+
+// Multiversión de funciones para los bucles calientes: CLONES_SIMD compila la
+// función en varias versiones (AVX-512, AVX2 y genérica) y el cargador elige
+// la mejor para la CPU al arrancar, sin necesidad de -march. Solo GCC sobre x86
+// admite target_clones en plantillas; el build con -march=native define
+// SIN_CLONES_SIMD porque la versión genérica ya usa todo el repertorio de la CPU
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(__clang__) && \
+    !defined(SIN_CLONES_SIMD)
+#define CLONES_SIMD __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define CLONES_SIMD
+#endif
+
+#endif // MULTIVERSION_H
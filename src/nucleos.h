@@ -0,0 +1,24 @@
+#ifndef NUCLEOS_H
+#define NUCLEOS_H
+
+// Biblioteca de núcleos paralelos (solo cabeceras). Todos los núcleos operan
+// sobre vistas de memoria del llamador (Vista, VistaTile), son plantillas sobre
+// el tipo de elemento y comunican los errores de dimensiones con un bool. Basta
+// con incluir esta cabecera (o la de un grupo concreto) y compilar con OpenMP:
+//
+//   std::vector<float> x(n), y(n);
+//   axpy(2.0f, vista(x), vista(y));
+//   size_t i = buscarPrimero(vista(y), 4.0f);
+
+#include "nucleos/vista.h"
+#include "nucleos/tareas.h"
+#include "nucleos/vectores.h"
+#include "nucleos/integracion.h"
+#include "nucleos/matrices.h"
+#include "nucleos/busqueda.h"
+#include "nucleos/ordenamiento.h"
+#include "nucleos/imagenes.h"
+#include "nucleos/montecarlo.h"
+#include "nucleos/generacion.h"
+
+#endif // NUCLEOS_H
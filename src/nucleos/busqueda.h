@@ -0,0 +1,543 @@
+#ifndef NUCLEOS_BUSQUEDA_H
+#define NUCLEOS_BUSQUEDA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <omp.h>
+#include "vista.h"
+#include "../multiversion.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BUSQUEDA_X86 1
+#endif
+
+// Elementos por bloque de la búsqueda paralela (256 KB de int): los bloques se
+// reparten en orden creciente y un hilo no empieza un bloque situado después de
+// la mejor coincidencia ya publicada
+const size_t BLOQUE_BUSQUEDA = 1 << 16;
+
+// Elementos que el kernel genérico compara antes de evaluar la rama de salida
+const size_t TRAMO_COMPARACION = 64;
+
+// Kernels de un bloque: buscar devuelve el índice de la primera aparición de
+// objetivo en datos[0,n), o n; contar, el número de apariciones
+template <typename T>
+struct KernelBusqueda {
+    typedef size_t (*FuncionBuscar)(const T* datos, size_t n, T objetivo);
+    typedef size_t (*FuncionContar)(const T* datos, size_t n, T objetivo);
+    const char* nombre;
+    FuncionBuscar buscar;
+    FuncionContar contar;
+};
+
+// Genérico: las comparaciones de cada tramo se unen con una reducción que el
+// compilador vectoriza para cualquier tipo, y solo el tramo con coincidencia se
+// recorre elemento a elemento
+template <typename T>
+CLONES_SIMD size_t buscarGenerico(const T* datos, size_t n, T objetivo) {
+    size_t i = 0;
+    for (; i + TRAMO_COMPARACION <= n; i += TRAMO_COMPARACION) {
+        bool alguno = false;
+        #pragma omp simd reduction(|:alguno)
+        for (size_t k = 0; k < TRAMO_COMPARACION; ++k) {
+            alguno |= (datos[i + k] == objetivo);
+        }
+        if (alguno) break;
+    }
+    for (; i < n; ++i) {
+        if (datos[i] == objetivo) return i;
+    }
+    return n;
+}
+
+template <typename T>
+CLONES_SIMD size_t contarGenerico(const T* datos, size_t n, T objetivo) {
+    size_t cuenta = 0;
+    #pragma omp simd reduction(+:cuenta)
+    for (size_t i = 0; i < n; ++i) {
+        cuenta += (datos[i] == objetivo);
+    }
+    return cuenta;
+}
+
+#ifdef BUSQUEDA_X86
+// AVX2: compara 8 int por instrucción; cada iteración une 4 vectores (32 int)
+// para que la rama de salida se evalúe una vez por línea de caché y media
+__attribute__((target("avx2")))
+inline size_t buscarAvx2(const int* datos, size_t n, int objetivo) {
+    const __m256i v = _mm256_set1_epi32(objetivo);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i c0 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i)), v);
+        __m256i c1 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i + 8)), v);
+        __m256i c2 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i + 16)), v);
+        __m256i c3 = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i + 24)), v);
+        __m256i alguno = _mm256_or_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c2, c3));
+        if (!_mm256_testz_si256(alguno, alguno)) {
+            __m256i comparaciones[4] = {c0, c1, c2, c3};
+            for (size_t k = 0; k < 4; ++k) {
+                int mascara = _mm256_movemask_ps(_mm256_castsi256_ps(comparaciones[k]));
+                if (mascara) return i + 8 * k + __builtin_ctz(mascara);
+            }
+        }
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i)), v);
+        int mascara = _mm256_movemask_ps(_mm256_castsi256_ps(c));
+        if (mascara) return i + __builtin_ctz(mascara);
+    }
+    return i + buscarGenerico(datos + i, n - i, objetivo);
+}
+
+// Cada comparación vale -1 por coincidencia: se restan en 8 contadores de 32 bits
+__attribute__((target("avx2")))
+inline size_t contarAvx2(const int* datos, size_t n, int objetivo) {
+    const __m256i v = _mm256_set1_epi32(objetivo);
+    __m256i acumulador = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + i)), v);
+        acumulador = _mm256_sub_epi32(acumulador, c);
+    }
+    alignas(32) uint32_t parciales[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(parciales), acumulador);
+    size_t cuenta = 0;
+    for (uint32_t parcial : parciales) cuenta += parcial;
+    return cuenta + contarGenerico(datos + i, n - i, objetivo);
+}
+
+// AVX-512: 16 int por comparación, con el resultado directamente en un registro máscara
+__attribute__((target("avx512f")))
+inline size_t buscarAvx512(const int* datos, size_t n, int objetivo) {
+    const __m512i v = _mm512_set1_epi32(objetivo);
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __mmask16 m0 = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(datos + i), v);
+        __mmask16 m1 = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(datos + i + 16), v);
+        __mmask16 m2 = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(datos + i + 32), v);
+        __mmask16 m3 = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(datos + i + 48), v);
+        if ((m0 | m1 | m2 | m3) != 0) {
+            uint64_t mascara = uint64_t(m0) | (uint64_t(m1) << 16) | (uint64_t(m2) << 32) | (uint64_t(m3) << 48);
+            return i + __builtin_ctzll(mascara);
+        }
+    }
+    // Resto con carga enmascarada: sin bucle escalar
+    for (; i < n; i += 16) {
+        __mmask16 validos = n - i >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (n - i)) - 1);
+        __mmask16 m = _mm512_mask_cmpeq_epi32_mask(validos, _mm512_maskz_loadu_epi32(validos, datos + i), v);
+        if (m) return i + __builtin_ctz(m);
+    }
+    return n;
+}
+
+__attribute__((target("avx512f")))
+inline size_t contarAvx512(const int* datos, size_t n, int objetivo) {
+    const __m512i v = _mm512_set1_epi32(objetivo);
+    size_t cuenta = 0;
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 validos = n - i >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (n - i)) - 1);
+        __mmask16 m = _mm512_mask_cmpeq_epi32_mask(validos, _mm512_maskz_loadu_epi32(validos, datos + i), v);
+        cuenta += __builtin_popcount(m);
+    }
+    return cuenta;
+}
+#endif
+
+// Kernel de un bloque para el tipo T: los kernels con intrínsecos existen para
+// int; el resto de tipos usa el genérico autovectorizado
+template <typename T>
+const KernelBusqueda<T>& seleccionarKernelBusqueda() {
+    static const KernelBusqueda<T> generico = {"genérico (omp simd)", buscarGenerico<T>, contarGenerico<T>};
+    return generico;
+}
+
+// Selecciona el kernel más ancho que soporte la CPU en tiempo de ejecución
+template <>
+inline const KernelBusqueda<int>& seleccionarKernelBusqueda<int>() {
+    static const KernelBusqueda<int> generico = {"genérico (omp simd)", buscarGenerico<int>, contarGenerico<int>};
+#ifdef BUSQUEDA_X86
+    static const KernelBusqueda<int> avx2 = {"AVX2 (8 int por comparación)", buscarAvx2, contarAvx2};
+    static const KernelBusqueda<int> avx512 = {"AVX-512 (16 int por comparación)", buscarAvx512, contarAvx512};
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return avx2;
+    }
+#endif
+    return generico;
+}
+
+// Publica valor en minimo si es menor que el actual (mínimo atómico sin bloqueo)
+inline void actualizarMinimo(std::atomic<size_t>& minimo, size_t valor) {
+    size_t actual = minimo.load(std::memory_order_relaxed);
+    while (valor < actual && !minimo.compare_exchange_weak(actual, valor, std::memory_order_relaxed)) {
+    }
+}
+
+// Primera aparición de objetivo en datos, o datos.size() si no aparece. Deja de
+// recorrer bloques cuando ya no pueden contener una coincidencia anterior a la
+// encontrada
+template <typename U>
+size_t buscarPrimero(Vista<U> datos, SinDeducir<SinConst<U>> objetivo) {
+    using T = SinConst<U>;
+    const KernelBusqueda<T>& kernel = seleccionarKernelBusqueda<T>();
+    const size_t tamano = datos.size();
+    const size_t numBloques = (tamano + BLOQUE_BUSQUEDA - 1) / BLOQUE_BUSQUEDA;
+    std::atomic<size_t> minimo(tamano);
+
+    // Bloques repartidos dinámicamente y en orden creciente
+    // Justificación: Con schedule(static) cada hilo debería recorrer todo su
+    // tramo; con bloques dinámicos, en cuanto se publica una coincidencia los
+    // bloques posteriores se descartan con una sola comparación
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t bloque = 0; bloque < numBloques; ++bloque) {
+        const size_t inicio = bloque * BLOQUE_BUSQUEDA;
+        // Un bloque que empieza después de la mejor coincidencia no puede mejorarla;
+        // los anteriores se recorren siempre, lo que garantiza el índice mínimo
+        if (inicio >= minimo.load(std::memory_order_relaxed)) continue;
+        const size_t n = std::min(BLOQUE_BUSQUEDA, tamano - inicio);
+        size_t posicion = kernel.buscar(datos.data() + inicio, n, objetivo);
+        if (posicion < n) {
+            actualizarMinimo(minimo, inicio + posicion);
+        }
+    }
+    return minimo.load();
+}
+
+// Número de apariciones de objetivo (recorre siempre todos los datos)
+template <typename U>
+size_t contar(Vista<U> datos, SinDeducir<SinConst<U>> objetivo) {
+    using T = SinConst<U>;
+    const KernelBusqueda<T>& kernel = seleccionarKernelBusqueda<T>();
+    const size_t tamano = datos.size();
+    const size_t numBloques = (tamano + BLOQUE_BUSQUEDA - 1) / BLOQUE_BUSQUEDA;
+    size_t total = 0;
+
+    #pragma omp parallel for reduction(+:total) schedule(static)
+    for (size_t bloque = 0; bloque < numBloques; ++bloque) {
+        const size_t inicio = bloque * BLOQUE_BUSQUEDA;
+        total += kernel.contar(datos.data() + inicio, std::min(BLOQUE_BUSQUEDA, tamano - inicio), objetivo);
+    }
+    return total;
+}
+
+// Número de apariciones de varios objetivos en una sola pasada: cada bloque se
+// lee de memoria una vez y se cuentan sobre él todos los objetivos mientras sigue
+// en la caché. Devuelve false si objetivos y cuentas no tienen el mismo tamaño
+template <typename U>
+bool contarVarios(Vista<U> datos, Vista<const SinDeducir<SinConst<U>>> objetivos, Vista<size_t> cuentas) {
+    using T = SinConst<U>;
+    if (objetivos.size() != cuentas.size()) return false;
+    const KernelBusqueda<T>& kernel = seleccionarKernelBusqueda<T>();
+    const size_t tamano = datos.size();
+    const size_t numObjetivos = objetivos.size();
+    const size_t numBloques = (tamano + BLOQUE_BUSQUEDA - 1) / BLOQUE_BUSQUEDA;
+    for (size_t q = 0; q < numObjetivos; ++q) cuentas[q] = 0;
+
+    // Justificación: Los bloques son independientes; cada hilo acumula sus cuentas
+    // en privado y las suma una vez al final
+    #pragma omp parallel
+    {
+        std::vector<size_t> locales(numObjetivos, 0);
+        #pragma omp for schedule(static) nowait
+        for (size_t bloque = 0; bloque < numBloques; ++bloque) {
+            const size_t inicio = bloque * BLOQUE_BUSQUEDA;
+            const size_t n = std::min(BLOQUE_BUSQUEDA, tamano - inicio);
+            for (size_t q = 0; q < numObjetivos; ++q) {
+                locales[q] += kernel.contar(datos.data() + inicio, n, objetivos[q]);
+            }
+        }
+        #pragma omp critical
+        for (size_t q = 0; q < numObjetivos; ++q) cuentas[q] += locales[q];
+    }
+    return true;
+}
+
+// Todos los índices donde aparece objetivo, en orden creciente
+template <typename U>
+std::vector<size_t> buscarTodos(Vista<U> datos, SinDeducir<SinConst<U>> objetivo) {
+    using T = SinConst<U>;
+    const KernelBusqueda<T>& kernel = seleccionarKernelBusqueda<T>();
+    const size_t tamano = datos.size();
+    std::vector<std::vector<size_t>> porHilo(omp_get_max_threads());
+
+    // Cada hilo recorre un tramo contiguo y guarda sus coincidencias en orden;
+    // concatenar los tramos por número de hilo da el resultado ordenado
+    #pragma omp parallel
+    {
+        const size_t hilo = omp_get_thread_num();
+        const size_t numHilos = omp_get_num_threads();
+        const size_t ini = tamano * hilo / numHilos;
+        const size_t fin = tamano * (hilo + 1) / numHilos;
+        std::vector<size_t>& locales = porHilo[hilo];
+        for (size_t i = ini; i < fin; ) {
+            size_t posicion = i + kernel.buscar(datos.data() + i, fin - i, objetivo);
+            if (posicion == fin) break;
+            locales.push_back(posicion);
+            i = posicion + 1;
+        }
+    }
+
+    std::vector<size_t> indices;
+    for (const auto& locales : porHilo) {
+        indices.insert(indices.end(), locales.begin(), locales.end());
+    }
+    return indices;
+}
+
+// Consultas que avanzan a la vez en la búsqueda por lotes: mientras se espera
+// la línea de caché de una, las demás siguen avanzando (búsqueda intercalada)
+const size_t GRUPO_INTERCALADO = 16;
+
+// Índice vacío en las tablas de índices
+const uint32_t SIN_INDICE = 0xFFFFFFFFu;
+
+// Los índices guardan posiciones de 32 bits y las devuelven como int: construir()
+// rechaza los arrays con MAX_ELEMENTOS_INDICE (2^31) elementos o más
+const size_t MAX_ELEMENTOS_INDICE = size_t(1) << 31;
+
+// Mezcla de 64 bits (finalizador de splitmix64) para las funciones hash
+inline uint64_t mezclarBits(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Índices para consultas repetidas sobre claves int. Cada estructura copia lo
+// que necesita de la vista al construirse, así que el array del llamador puede
+// liberarse después
+
+// Copia ordenada de las claves distintas en disposición de Eytzinger (árbol
+// binario completo almacenado por niveles, como un montículo). Cada nivel de la
+// búsqueda cae en posiciones 2k o 2k+1, de modo que los 16 descendientes a
+// cuatro niveles de distancia ocupan una línea de caché y se pueden precargar
+class IndiceEytzinger {
+private:
+    std::vector<int> claves;        // claves[1..m] en orden de Eytzinger; claves[0] sin uso
+    std::vector<uint32_t> indices;  // Primera aparición de cada clave en el array original
+    size_t m = 0;
+
+    // Recorrido en orden del árbol implícito: asigna las claves ordenadas a sus nodos
+    size_t rellenar(const std::vector<uint64_t>& ordenados, size_t i, size_t k) {
+        if (k <= m) {
+            i = rellenar(ordenados, i, 2 * k);
+            claves[k] = static_cast<int>(static_cast<uint32_t>(ordenados[i] >> 32) ^ 0x80000000u);
+            indices[k] = static_cast<uint32_t>(ordenados[i]);
+            ++i;
+            i = rellenar(ordenados, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    // Convierte la posición final del descenso en el nodo de la cota inferior
+    static size_t cotaInferior(size_t k) {
+        return k >> __builtin_ffsll(~static_cast<long long>(k));
+    }
+
+public:
+    // Devuelve false (y deja el índice sin cambios) si el array es demasiado grande
+    bool construir(Vista<const int> array) {
+        const size_t n = array.size();
+        if (n >= MAX_ELEMENTOS_INDICE) return false;
+        // Pares (clave ordenable, índice) en 64 bits: ordenarlos agrupa cada clave
+        // con su primera aparición delante
+        std::vector<uint64_t> pares(n);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            pares[i] = (uint64_t(static_cast<uint32_t>(array[i]) ^ 0x80000000u) << 32) | i;
+        }
+
+        // Ordenación paralela: cada hilo ordena su tramo y los tramos se mezclan por parejas
+        const int numTramos = omp_get_max_threads();
+        std::vector<size_t> limites(numTramos + 1);
+        for (int t = 0; t <= numTramos; ++t) limites[t] = n * t / numTramos;
+        #pragma omp parallel for schedule(static, 1)
+        for (int t = 0; t < numTramos; ++t) {
+            std::sort(pares.begin() + limites[t], pares.begin() + limites[t + 1]);
+        }
+        for (int ancho = 1; ancho < numTramos; ancho *= 2) {
+            #pragma omp parallel for schedule(dynamic, 1)
+            for (int t = 0; t < numTramos - ancho; t += 2 * ancho) {
+                std::inplace_merge(pares.begin() + limites[t], pares.begin() + limites[t + ancho],
+                                   pares.begin() + limites[std::min(t + 2 * ancho, numTramos)]);
+            }
+        }
+
+        // Deja solo la primera aparición de cada clave
+        size_t distintas = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (i == 0 || (pares[i] >> 32) != (pares[distintas - 1] >> 32)) {
+                pares[distintas++] = pares[i];
+            }
+        }
+
+        m = distintas;
+        claves.assign(m + 1, 0);
+        indices.assign(m + 1, SIN_INDICE);
+        rellenar(pares, 0, 1);
+        return true;
+    }
+
+    int buscar(int objetivo) const {
+        const int* c = claves.data();
+        size_t k = 1;
+        while (k <= m) {
+            __builtin_prefetch(c + 16 * k);
+            k = 2 * k + (c[k] < objetivo);
+        }
+        k = cotaInferior(k);
+        return (k != 0 && c[k] == objetivo) ? static_cast<int>(indices[k]) : -1;
+    }
+
+    // Búsqueda intercalada: todas las consultas del grupo bajan un nivel por vuelta
+    void buscarGrupo(const int* objetivos, size_t g, int* resultados) const {
+        const int* c = claves.data();
+        size_t k[GRUPO_INTERCALADO];
+        for (size_t q = 0; q < g; ++q) k[q] = 1;
+        for (size_t nivel = m; nivel > 0; nivel >>= 1) {
+            for (size_t q = 0; q < g; ++q) {
+                if (k[q] <= m) {
+                    __builtin_prefetch(c + 16 * k[q]);
+                    k[q] = 2 * k[q] + (c[k[q]] < objetivos[q]);
+                }
+            }
+        }
+        for (size_t q = 0; q < g; ++q) {
+            size_t nodo = cotaInferior(k[q]);
+            resultados[q] = (nodo != 0 && c[nodo] == objetivos[q]) ? static_cast<int>(indices[nodo]) : -1;
+        }
+    }
+};
+
+// Tabla hash de direccionamiento abierto (sondeo lineal) clave -> primera
+// aparición. Cada celda empaqueta clave e índice en 64 bits para construirla en
+// paralelo con compare_exchange: si dos hilos insertan la misma clave, gana el
+// menor índice
+class IndiceHash {
+private:
+    static constexpr uint64_t VACIA = ~uint64_t(0);
+    std::unique_ptr<std::atomic<uint64_t>[]> tabla;
+    size_t mascara = 0;
+
+    size_t posicion(int clave) const {
+        return static_cast<size_t>(mezclarBits(static_cast<uint32_t>(clave))) & mascara;
+    }
+
+    void insertar(int clave, uint32_t indice) {
+        const uint64_t nueva = (uint64_t(static_cast<uint32_t>(clave)) << 32) | indice;
+        for (size_t h = posicion(clave); ; h = (h + 1) & mascara) {
+            uint64_t actual = tabla[h].load(std::memory_order_relaxed);
+            if (actual == VACIA && tabla[h].compare_exchange_strong(actual, nueva, std::memory_order_relaxed)) return;
+            // Si el intercambio falla, actual contiene la celda que otro hilo acaba
+            // de ocupar (una celda ocupada no vuelve a quedar vacía)
+            if ((actual >> 32) == static_cast<uint32_t>(clave)) {
+                while (indice < static_cast<uint32_t>(actual) &&
+                       !tabla[h].compare_exchange_weak(actual, nueva, std::memory_order_relaxed)) {
+                }
+                return;
+            }
+        }
+    }
+
+public:
+    // Devuelve false (y deja el índice sin cambios) si el array es demasiado grande
+    bool construir(Vista<const int> array) {
+        const size_t n = array.size();
+        if (n >= MAX_ELEMENTOS_INDICE) return false;
+        // Capacidad potencia de dos >= 1.25 n: factor de carga máximo del 80%
+        size_t capacidad = 16;
+        while (capacidad < n + n / 4) capacidad *= 2;
+        mascara = capacidad - 1;
+        tabla.reset(new std::atomic<uint64_t>[capacidad]);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < capacidad; ++i) {
+            tabla[i].store(VACIA, std::memory_order_relaxed);
+        }
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            insertar(array[i], static_cast<uint32_t>(i));
+        }
+        return true;
+    }
+
+    int buscar(int objetivo) const {
+        for (size_t h = posicion(objetivo); ; h = (h + 1) & mascara) {
+            uint64_t celda = tabla[h].load(std::memory_order_relaxed);
+            if (celda == VACIA) return -1;
+            if ((celda >> 32) == static_cast<uint32_t>(objetivo)) return static_cast<int>(static_cast<uint32_t>(celda));
+        }
+    }
+
+    // Primero se precargan las celdas de todo el grupo y después se sondean
+    void buscarGrupo(const int* objetivos, size_t g, int* resultados) const {
+        for (size_t q = 0; q < g; ++q) {
+            __builtin_prefetch(&tabla[posicion(objetivos[q])]);
+        }
+        for (size_t q = 0; q < g; ++q) {
+            resultados[q] = buscar(objetivos[q]);
+        }
+    }
+};
+
+// Filtro de Bloom por registro: los bits de cada clave caen todos en una misma
+// palabra de 64 bits, de modo que una consulta negativa cuesta un único acceso a
+// memoria y la construcción paralela un único fetch_or atómico por clave
+class FiltroBloom {
+private:
+    static const size_t BITS_POR_CLAVE_FILTRO = 6;
+    std::unique_ptr<std::atomic<uint64_t>[]> palabras;
+    size_t numPalabras = 0;
+
+    size_t palabra(uint64_t h) const {
+        return static_cast<size_t>((h >> 32) * numPalabras >> 32);
+    }
+
+    // Máscara con BITS_POR_CLAVE_FILTRO bits tomados de 6 en 6 de un segundo hash
+    static uint64_t mascaraBits(uint64_t h) {
+        uint64_t h2 = mezclarBits(h);
+        uint64_t mascara = 0;
+        for (size_t b = 0; b < BITS_POR_CLAVE_FILTRO; ++b) {
+            mascara |= uint64_t(1) << ((h2 >> (6 * b)) & 63);
+        }
+        return mascara;
+    }
+
+public:
+    // bitsPorElemento: tamaño del filtro respecto al array (incluidos duplicados)
+    void construir(Vista<const int> array, size_t bitsPorElemento = 12) {
+        const size_t n = array.size();
+        numPalabras = std::max<size_t>((n * bitsPorElemento + 63) / 64, 1);
+        palabras.reset(new std::atomic<uint64_t>[numPalabras]);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < numPalabras; ++i) {
+            palabras[i].store(0, std::memory_order_relaxed);
+        }
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t h = mezclarBits(static_cast<uint32_t>(array[i]));
+            palabras[palabra(h)].fetch_or(mascaraBits(h), std::memory_order_relaxed);
+        }
+    }
+
+    const std::atomic<uint64_t>* direccion(int clave) const {
+        return &palabras[palabra(mezclarBits(static_cast<uint32_t>(clave)))];
+    }
+
+    bool puedeContener(int clave) const {
+        uint64_t h = mezclarBits(static_cast<uint32_t>(clave));
+        uint64_t mascara = mascaraBits(h);
+        return (palabras[palabra(h)].load(std::memory_order_relaxed) & mascara) == mascara;
+    }
+};
+
+#endif
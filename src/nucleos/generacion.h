@@ -0,0 +1,308 @@
+#ifndef NUCLEOS_GENERACION_H
+#define NUCLEOS_GENERACION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "philox.h"
+#include "vista.h"
+
+// Generación paralela de datos de entrada. El elemento de índice global k se
+// obtiene del contador k de Philox con la semilla como clave: su valor no
+// depende del número de hilos ni del reparto, y cada hilo escribe primero el
+// mismo tramo contiguo que le asigna schedule(static) a los núcleos, de modo
+// que las páginas quedan en su nodo NUMA (primera escritura)
+
+// Palabras aleatorias por lote: se generan vectorizadas en un buffer que cabe
+// en la caché L1 y después se transforman en valores de la distribución
+const size_t LOTE_GENERACION = 1024;
+
+enum class Distribucion { Uniforme, Normal, Zipf, Ordenada, Inversa, CasiOrdenada, Duplicados };
+
+// Parámetros de las distribuciones (cada una usa solo los suyos):
+//   Uniforme      valores en [minimo, maximo] (enteros: ambos extremos incluidos)
+//   Normal        media y desviación típica (enteros: redondeo al más próximo)
+//   Zipf          'valores' puntos equiespaciados en [minimo, maximo]; el de
+//                 rango r aparece con probabilidad proporcional a 1 / r^exponente
+//   Ordenada      creciente de minimo a maximo; Inversa, decreciente
+//   CasiOrdenada  Ordenada con una 'fraccion' de elementos uniformes en [minimo, maximo]
+//   Duplicados    'valores' puntos equiespaciados en [minimo, maximo], equiprobables
+struct ParametrosDistribucion {
+    double minimo = 0.0;
+    double maximo = 1.0;
+    double media = 0.0;
+    double desviacion = 1.0;
+    double exponente = 1.0;
+    size_t valores = 1000;
+    double fraccion = 0.01;
+};
+
+inline const char* nombreDistribucion(Distribucion distribucion) {
+    switch (distribucion) {
+        case Distribucion::Uniforme: return "uniforme";
+        case Distribucion::Normal: return "normal";
+        case Distribucion::Zipf: return "zipf";
+        case Distribucion::Ordenada: return "ordenado";
+        case Distribucion::Inversa: return "inverso";
+        case Distribucion::CasiOrdenada: return "casi-ordenado";
+        case Distribucion::Duplicados: return "duplicados";
+    }
+    return "desconocida";
+}
+
+// Devuelve false si el nombre no corresponde a ninguna distribución
+inline bool distribucionDesdeNombre(const std::string& nombre, Distribucion& distribucion) {
+    const Distribucion todas[] = {Distribucion::Uniforme, Distribucion::Normal, Distribucion::Zipf,
+                                  Distribucion::Ordenada, Distribucion::Inversa,
+                                  Distribucion::CasiOrdenada, Distribucion::Duplicados};
+    for (Distribucion d : todas) {
+        if (nombre == nombreDistribucion(d)) {
+            distribucion = d;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Asignador que no inicializa los elementos al redimensionar: std::vector<T>(n)
+// pone a cero la memoria desde el hilo que lo construye, y esa primera escritura
+// serie fija todas las páginas en su nodo NUMA antes de que el generador paralelo
+// llegue a tocarlas
+template <typename T>
+struct AsignadorSinInicializar : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = AsignadorSinInicializar<U>;
+    };
+
+    AsignadorSinInicializar() = default;
+    template <typename U>
+    AsignadorSinInicializar(const AsignadorSinInicializar<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+// Vector cuya memoria queda sin tocar hasta que la escribe el generador (o un
+// bucle paralelo del llamador)
+template <typename T>
+using VectorNuma = std::vector<T, AsignadorSinInicializar<T>>;
+
+// Convierte un valor real al tipo de elemento; los enteros se saturan al rango
+// del tipo y se redondean al más próximo
+template <typename T>
+inline T convertirValor(double valor) {
+    if (std::is_floating_point<T>::value) return static_cast<T>(valor);
+    const double minimo = static_cast<double>(std::numeric_limits<T>::lowest());
+    const double maximo = static_cast<double>(std::numeric_limits<T>::max());
+    return static_cast<T>(std::llround(std::min(std::max(valor, minimo), maximo)));
+}
+
+// Entero uniforme en [0, rango) a partir de 64 bits aleatorios con la parte
+// alta del producto de 128 bits (sin divisiones); rango 0 equivale a 2^64
+inline uint64_t acotar(uint64_t bits, uint64_t rango) {
+    if (rango == 0) return bits;
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(bits) * rango) >> 64);
+}
+
+// Escribe destino[0, n) con los elementos de índice global indice0 .. indice0+n-1.
+// Si Aleatorio, valor(primera, segunda, k) recibe las dos palabras de 64 bits del
+// contador k; si no, solo se le pasa k y no se generan palabras
+template <bool Aleatorio, typename T, typename Valor>
+void generarTramo(T* destino, size_t n, uint64_t indice0, uint64_t semilla, const Valor& valor) {
+    const uint32_t k0 = static_cast<uint32_t>(semilla), k1 = static_cast<uint32_t>(semilla >> 32);
+    alignas(64) uint64_t primera[LOTE_GENERACION];
+    alignas(64) uint64_t segunda[LOTE_GENERACION];
+    for (size_t inicio = 0; inicio < n; inicio += LOTE_GENERACION) {
+        const size_t m = std::min(LOTE_GENERACION, n - inicio);
+        if (Aleatorio) palabrasPhilox(primera, segunda, m, indice0 + inicio, k0, k1, 0, 0);
+        T* salida = destino + inicio;
+        const uint64_t base = indice0 + inicio;
+        #pragma omp simd
+        for (size_t i = 0; i < m; ++i) {
+            salida[i] = valor(Aleatorio ? primera[i] : 0, Aleatorio ? segunda[i] : 0, base + i);
+        }
+    }
+}
+
+// Reparto de una vista 1-D: cada hilo genera su tramo contiguo, el mismo que
+// le asigna schedule(static) en los bucles paralelos sobre la vista
+template <bool Aleatorio, typename T, typename Valor>
+void recorrerGeneracion(Vista<T> destino, uint64_t semilla, const Valor& valor) {
+    const size_t n = destino.size();
+    // Justificación: Los elementos son independientes y el tramo de cada hilo fija
+    // en qué nodo NUMA quedan sus páginas
+    #pragma omp parallel
+    {
+        const int hilo = omp_get_thread_num();
+        const int numHilos = omp_get_num_threads();
+        const size_t ini = n * hilo / numHilos;
+        const size_t fin = n * (hilo + 1) / numHilos;
+        generarTramo<Aleatorio>(destino.data() + ini, fin - ini, ini, semilla, valor);
+    }
+}
+
+// Reparto de una vista 2-D por filas, como los núcleos de matrices e imágenes;
+// el índice global del elemento (i, j) es i * columnas + j, sin contar el relleno
+template <bool Aleatorio, typename T, typename Valor>
+void recorrerGeneracion(VistaTile<T> destino, uint64_t semilla, const Valor& valor) {
+    // Justificación: Las filas son independientes; mismo reparto que Matriz2D
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < destino.filas; ++i) {
+        generarTramo<Aleatorio>(destino[i], destino.columnas, uint64_t(i) * destino.columnas, semilla, valor);
+    }
+}
+
+template <typename T>
+size_t numElementos(Vista<T> destino) { return destino.size(); }
+template <typename T>
+size_t numElementos(VistaTile<T> destino) { return destino.filas * destino.columnas; }
+
+// Rellena destino (Vista o VistaTile) con la distribución pedida. Devuelve
+// false si los parámetros no son válidos para ella
+template <typename T, typename Destino>
+bool generarDistribucion(Destino destino, Distribucion distribucion, const ParametrosDistribucion& p,
+                         uint64_t semilla) {
+    const size_t n = numElementos(destino);
+    const double minimo = p.minimo, amplitud = p.maximo - p.minimo;
+    if (!(amplitud >= 0.0)) return false;
+    // Valor de la secuencia creciente en la posición k
+    auto ordenado = [=](uint64_t k) {
+        return minimo + amplitud * static_cast<double>(k) / static_cast<double>(std::max<size_t>(n, 1));
+    };
+    // Punto r de los 'valores' equiespaciados en [minimo, maximo]
+    const size_t valores = p.valores;
+    auto equiespaciado = [=](uint64_t r) {
+        return valores > 1 ? minimo + amplitud * static_cast<double>(r) / static_cast<double>(valores - 1)
+                           : minimo;
+    };
+
+    switch (distribucion) {
+        case Distribucion::Uniforme:
+            if (std::is_integral<T>::value) {
+                // Camino entero exacto: sin pasar por double, todos los valores
+                // del rango son equiprobables
+                const long long inferior = std::llround(p.minimo);
+                const uint64_t rango = static_cast<uint64_t>(std::llround(p.maximo) - inferior) + 1;
+                recorrerGeneracion<true>(destino, semilla, [=](uint64_t a, uint64_t, uint64_t) {
+                    return static_cast<T>(inferior + static_cast<long long>(acotar(a, rango)));
+                });
+            } else {
+                recorrerGeneracion<true>(destino, semilla, [=](uint64_t a, uint64_t, uint64_t) {
+                    return static_cast<T>(minimo + amplitud * FlujoPhilox::aDouble(a));
+                });
+            }
+            return true;
+
+        case Distribucion::Normal: {
+            if (!(p.desviacion >= 0.0)) return false;
+            const double media = p.media, desviacion = p.desviacion;
+            // Box-Muller con las dos palabras del contador; 1 - u está en (0, 1]
+            recorrerGeneracion<true>(destino, semilla, [=](uint64_t a, uint64_t b, uint64_t) {
+                const double radio = std::sqrt(-2.0 * std::log(1.0 - FlujoPhilox::aDouble(a)));
+                const double angulo = 6.283185307179586 * FlujoPhilox::aDouble(b);
+                return convertirValor<T>(media + desviacion * radio * std::cos(angulo));
+            });
+            return true;
+        }
+
+        case Distribucion::Zipf: {
+            if (valores == 0 || !(p.exponente >= 0.0)) return false;
+            // Función de distribución acumulada de los rangos; cada elemento se
+            // obtiene por inversión con búsqueda binaria en la tabla compartida
+            std::vector<double> acumulada(valores);
+            double total = 0.0;
+            for (size_t r = 0; r < valores; ++r) {
+                total += std::pow(static_cast<double>(r + 1), -p.exponente);
+                acumulada[r] = total;
+            }
+            const double* tabla = acumulada.data();
+            recorrerGeneracion<true>(destino, semilla, [=](uint64_t a, uint64_t, uint64_t) {
+                const double u = FlujoPhilox::aDouble(a) * total;
+                size_t r = static_cast<size_t>(std::upper_bound(tabla, tabla + valores, u) - tabla);
+                return convertirValor<T>(equiespaciado(std::min(r, valores - 1)));
+            });
+            return true;
+        }
+
+        case Distribucion::Ordenada:
+            recorrerGeneracion<false>(destino, semilla, [=](uint64_t, uint64_t, uint64_t k) {
+                return convertirValor<T>(ordenado(k));
+            });
+            return true;
+
+        case Distribucion::Inversa:
+            recorrerGeneracion<false>(destino, semilla, [=](uint64_t, uint64_t, uint64_t k) {
+                return convertirValor<T>(p.maximo - (ordenado(k) - minimo));
+            });
+            return true;
+
+        case Distribucion::CasiOrdenada: {
+            if (!(p.fraccion >= 0.0 && p.fraccion <= 1.0)) return false;
+            const double fraccion = p.fraccion;
+            recorrerGeneracion<true>(destino, semilla, [=](uint64_t a, uint64_t b, uint64_t k) {
+                const double valor = FlujoPhilox::aDouble(a) < fraccion
+                                         ? minimo + amplitud * FlujoPhilox::aDouble(b)
+                                         : ordenado(k);
+                return convertirValor<T>(valor);
+            });
+            return true;
+        }
+
+        case Distribucion::Duplicados:
+            if (valores == 0) return false;
+            recorrerGeneracion<true>(destino, semilla, [=](uint64_t a, uint64_t, uint64_t) {
+                return convertirValor<T>(equiespaciado(acotar(a, valores)));
+            });
+            return true;
+    }
+    return false;
+}
+
+// Rellena destino con la distribución indicada a partir de la semilla; el
+// resultado es idéntico con cualquier número de hilos
+template <typename T>
+bool generar(Vista<T> destino, Distribucion distribucion, const ParametrosDistribucion& parametros,
+             uint64_t semilla) {
+    return generarDistribucion<T>(destino, distribucion, parametros, semilla);
+}
+
+// Versión 2-D: solo se escriben los elementos lógicos, no el relleno
+template <typename T>
+bool generar(VistaTile<T> destino, Distribucion distribucion, const ParametrosDistribucion& parametros,
+             uint64_t semilla) {
+    return generarDistribucion<T>(destino, distribucion, parametros, semilla);
+}
+
+// Atajo para la distribución uniforme en [minimo, maximo]
+template <typename T>
+bool generarUniforme(Vista<T> destino, double minimo, double maximo, uint64_t semilla) {
+    ParametrosDistribucion parametros;
+    parametros.minimo = minimo;
+    parametros.maximo = maximo;
+    return generar(destino, Distribucion::Uniforme, parametros, semilla);
+}
+template <typename T>
+bool generarUniforme(VistaTile<T> destino, double minimo, double maximo, uint64_t semilla) {
+    ParametrosDistribucion parametros;
+    parametros.minimo = minimo;
+    parametros.maximo = maximo;
+    return generar(destino, Distribucion::Uniforme, parametros, semilla);
+}
+
+#endif
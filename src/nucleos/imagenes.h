@@ -0,0 +1,668 @@
+#ifndef NUCLEOS_IMAGENES_H
+#define NUCLEOS_IMAGENES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <omp.h>
+#include "vista.h"
+#include "../matriz2d.h"
+#include "../multiversion.h"
+
+// Tamaño de los tiles del motor de filtros separables: TILE_COLUMNAS limita los
+// buffers de sumas por columna a unos pocos KB (caché L1) y TILE_FILAS amortiza
+// la inicialización de la ventana vertical deslizante
+const size_t TILE_FILAS = 128;
+const size_t TILE_COLUMNAS = 1024;
+
+// Radio máximo admitido (núcleos de hasta 63x63): mantiene las sumas de la
+// ventana y el numerador del redondeo dentro de 32 bits incluso con píxeles de 16 bits
+const int RADIO_MAXIMO = 31;
+
+// Núcleo separable k x k (k = 2r+1) expresado como un núcleo 1-D que se aplica
+// primero por columnas y luego por filas
+struct NucleoSeparable {
+    std::string nombre;
+    int radio;
+    bool esCaja;
+    std::vector<float> pesos;  // Pesos 1-D normalizados (solo en el gaussiano)
+
+    // Desenfoque de caja k x k; k se redondea al impar siguiente
+    static NucleoSeparable caja(int k) {
+        int radio = std::min(std::max(k / 2, 1), RADIO_MAXIMO);
+        NucleoSeparable nucleo;
+        nucleo.nombre = "caja " + std::to_string(2 * radio + 1) + "x" + std::to_string(2 * radio + 1);
+        nucleo.radio = radio;
+        nucleo.esCaja = true;
+        nucleo.pesos.assign(2 * radio + 1, 1.0f / (2 * radio + 1));
+        return nucleo;
+    }
+
+    // Desenfoque gaussiano k x k con desviación sigma
+    static NucleoSeparable gaussiano(int k, double sigma) {
+        int radio = std::min(std::max(k / 2, 1), RADIO_MAXIMO);
+        NucleoSeparable nucleo;
+        nucleo.nombre = "gaussiano " + std::to_string(2 * radio + 1) + "x" + std::to_string(2 * radio + 1);
+        nucleo.radio = radio;
+        nucleo.esCaja = false;
+        nucleo.pesos.resize(2 * radio + 1);
+        double total = 0.0;
+        for (int d = -radio; d <= radio; ++d) {
+            total += std::exp(-(d * d) / (2.0 * sigma * sigma));
+        }
+        for (int d = -radio; d <= radio; ++d) {
+            nucleo.pesos[d + radio] = static_cast<float>(std::exp(-(d * d) / (2.0 * sigma * sigma)) / total);
+        }
+        return nucleo;
+    }
+};
+
+// Calcula round(suma / cuenta) sin divisiones enteras ni ramas: estima el cociente
+// con un producto en double y lo corrige en +-1, lo que permite vectorizarlo
+inline uint32_t dividirRedondeado(uint32_t suma, uint32_t cuenta, double inversoDoble) {
+    uint32_t numerador = 2 * suma + cuenta;
+    uint32_t divisor = 2 * cuenta;
+    uint32_t q = static_cast<uint32_t>(numerador * inversoDoble);
+    q += ((q + 1) * divisor <= numerador) ? 1 : 0;
+    q -= (q * divisor > numerador) ? 1 : 0;
+    return q;
+}
+
+// Desenfoque de caja sobre el tile [i0,i1) x [j0,j1) con sumas deslizantes:
+// la ventana vertical se actualiza sumando la fila que entra y restando la que
+// sale, y la horizontal se obtiene como diferencia de sumas prefijas. Los bordes
+// se normalizan con el número real de píxeles dentro de la imagen.
+template <typename Pixel>
+CLONES_SIMD
+void filtrarTileCaja(VistaTile<const Pixel> entrada, VistaTile<Pixel> salida,
+                     size_t i0, size_t i1, size_t j0, size_t j1, size_t radio,
+                     std::vector<uint32_t>& sumas, std::vector<uint32_t>& prefijo) {
+    const size_t alto = entrada.filas;
+    const size_t ancho = entrada.columnas;
+    const uint32_t k = static_cast<uint32_t>(2 * radio + 1);
+    const size_t ca = j0 > radio ? j0 - radio : 0;
+    const size_t cb = std::min(j1 + radio, ancho);
+    const size_t w = cb - ca;
+    uint32_t* suma = sumas.data();
+    uint32_t* p = prefijo.data();
+
+    // Columnas interiores: la ventana horizontal completa cae dentro de la imagen
+    const size_t ja = std::max(j0, radio);
+    const size_t jb = std::max(ja, std::min(j1, ancho > radio ? ancho - radio : 0));
+
+    size_t fa = i0 > radio ? i0 - radio : 0;
+    size_t fb = std::min(i0 + radio + 1, alto);
+    std::fill(suma, suma + w, 0u);
+    for (size_t f = fa; f < fb; ++f) {
+        const Pixel* fila = entrada[f] + ca;
+        #pragma omp simd
+        for (size_t c = 0; c < w; ++c) {
+            suma[c] += fila[c];
+        }
+    }
+
+    for (size_t i = i0; i < i1; ++i) {
+        const uint32_t filasVentana = static_cast<uint32_t>(fb - fa);
+        Pixel* salidaFila = salida[i];
+
+        p[0] = 0;
+        for (size_t c = 0; c < w; ++c) {
+            p[c + 1] = p[c] + suma[c];
+        }
+
+        for (size_t j = j0; j < std::min(ja, j1); ++j) {
+            size_t lo = j > radio ? j - radio : 0;
+            size_t hi = std::min(j + radio + 1, ancho);
+            uint32_t cuenta = static_cast<uint32_t>(hi - lo) * filasVentana;
+            salidaFila[j] = static_cast<Pixel>(dividirRedondeado(p[hi - ca] - p[lo - ca], cuenta, 0.5 / cuenta));
+        }
+
+        // Bucle interior sin ramas: todas las ventanas tienen k x filasVentana píxeles
+        // Justificación: #pragma omp simd vectoriza el cálculo de varios píxeles a la vez
+        const uint32_t cuenta = k * filasVentana;
+        const double inverso = 0.5 / cuenta;
+        const uint32_t* pa = p + (ja - radio - ca);
+        const uint32_t* pb = p + (ja + radio + 1 - ca);
+        Pixel* destino = salidaFila + ja;
+        #pragma omp simd
+        for (size_t t = 0; t < jb - ja; ++t) {
+            destino[t] = static_cast<Pixel>(dividirRedondeado(pb[t] - pa[t], cuenta, inverso));
+        }
+
+        for (size_t j = jb; j < j1; ++j) {
+            size_t lo = j - radio;
+            size_t hi = std::min(j + radio + 1, ancho);
+            uint32_t cuentaBorde = static_cast<uint32_t>(hi - lo) * filasVentana;
+            salidaFila[j] = static_cast<Pixel>(dividirRedondeado(p[hi - ca] - p[lo - ca], cuentaBorde, 0.5 / cuentaBorde));
+        }
+
+        // Desliza la ventana vertical una fila hacia abajo
+        if (i + 1 < i1) {
+            if (i + radio + 1 < alto) {
+                const Pixel* entra = entrada[i + radio + 1] + ca;
+                #pragma omp simd
+                for (size_t c = 0; c < w; ++c) {
+                    suma[c] += entra[c];
+                }
+                ++fb;
+            }
+            if (i >= radio) {
+                const Pixel* sale = entrada[i - radio] + ca;
+                #pragma omp simd
+                for (size_t c = 0; c < w; ++c) {
+                    suma[c] -= sale[c];
+                }
+                ++fa;
+            }
+        }
+    }
+}
+
+// Desenfoque gaussiano sobre el tile [i0,i1) x [j0,j1): pasada vertical ponderada
+// por columnas y pasada horizontal por filas, renormalizando los pesos en los bordes
+template <typename Pixel>
+CLONES_SIMD
+void filtrarTileGaussiano(VistaTile<const Pixel> entrada, VistaTile<Pixel> salida,
+                          size_t i0, size_t i1, size_t j0, size_t j1, const NucleoSeparable& nucleo,
+                          std::vector<float>& columnas) {
+    const size_t alto = entrada.filas;
+    const size_t ancho = entrada.columnas;
+    const size_t radio = static_cast<size_t>(nucleo.radio);
+    const float* pesos = nucleo.pesos.data();
+    const size_t ca = j0 > radio ? j0 - radio : 0;
+    const size_t cb = std::min(j1 + radio, ancho);
+    const size_t w = cb - ca;
+    float* acumulado = columnas.data();
+
+    const size_t ja = std::max(j0, radio);
+    const size_t jb = std::max(ja, std::min(j1, ancho > radio ? ancho - radio : 0));
+
+    // Borde horizontal: solo intervienen los pesos de las columnas dentro de la imagen
+    auto filtrarBorde = [&](Pixel* salidaFila, size_t j) {
+        size_t lo = j > radio ? j - radio : 0;
+        size_t hi = std::min(j + radio + 1, ancho);
+        float suma = 0.0f, pesoTotal = 0.0f;
+        for (size_t c = lo; c < hi; ++c) {
+            float peso = pesos[c + radio - j];
+            suma += peso * acumulado[c - ca];
+            pesoTotal += peso;
+        }
+        salidaFila[j] = static_cast<Pixel>(suma / pesoTotal + 0.5f);
+    };
+
+    for (size_t i = i0; i < i1; ++i) {
+        size_t fa = i > radio ? i - radio : 0;
+        size_t fb = std::min(i + radio + 1, alto);
+        float pesoVertical = 0.0f;
+        for (size_t f = fa; f < fb; ++f) {
+            pesoVertical += pesos[f + radio - i];
+        }
+
+        std::fill(acumulado, acumulado + w, 0.0f);
+        for (size_t f = fa; f < fb; ++f) {
+            const float peso = pesos[f + radio - i] / pesoVertical;
+            const Pixel* fila = entrada[f] + ca;
+            #pragma omp simd
+            for (size_t c = 0; c < w; ++c) {
+                acumulado[c] += peso * fila[c];
+            }
+        }
+
+        Pixel* salidaFila = salida[i];
+        for (size_t j = j0; j < std::min(ja, j1); ++j) {
+            filtrarBorde(salidaFila, j);
+        }
+
+        // Bucle interior sin ramas: los pesos horizontales ya suman 1
+        const float* origen = acumulado + (ja - radio - ca);
+        Pixel* destino = salidaFila + ja;
+        const size_t k = 2 * radio + 1;
+        #pragma omp simd
+        for (size_t t = 0; t < jb - ja; ++t) {
+            float suma = 0.0f;
+            for (size_t d = 0; d < k; ++d) {
+                suma += pesos[d] * origen[t + d];
+            }
+            destino[t] = static_cast<Pixel>(suma + 0.5f);
+        }
+
+        for (size_t j = jb; j < j1; ++j) {
+            filtrarBorde(salidaFila, j);
+        }
+    }
+}
+
+// Motor de filtros separables para el equipo de hilos actual: reparte los tiles
+// con un for huérfano, por lo que deben invocarlo todos los hilos de una región
+// paralela ya abierta (así puede combinarse con tareas de E/S en esa misma región)
+template <typename Pixel>
+void filtrarSeparableEnEquipo(VistaTile<const Pixel> entrada, VistaTile<Pixel> salida, const NucleoSeparable& nucleo) {
+    const size_t alto = entrada.filas;
+    const size_t ancho = entrada.columnas;
+    const size_t radio = static_cast<size_t>(nucleo.radio);
+    const size_t tilesVerticales = (alto + TILE_FILAS - 1) / TILE_FILAS;
+    const size_t tilesHorizontales = (ancho + TILE_COLUMNAS - 1) / TILE_COLUMNAS;
+
+    // Buffers privados de cada hilo, reutilizados entre tiles
+    std::vector<uint32_t> sumas(TILE_COLUMNAS + 2 * radio);
+    std::vector<uint32_t> prefijo(TILE_COLUMNAS + 2 * radio + 1);
+    std::vector<float> columnas(TILE_COLUMNAS + 2 * radio);
+
+    // Distribuye los tiles entre los hilos
+    // Justificación: collapse(2) expone todos los tiles a la vez y schedule(dynamic)
+    // equilibra los tiles incompletos del borde derecho e inferior
+    #pragma omp for collapse(2) schedule(dynamic)
+    for (size_t ti = 0; ti < tilesVerticales; ++ti) {
+        for (size_t tj = 0; tj < tilesHorizontales; ++tj) {
+            size_t i0 = ti * TILE_FILAS;
+            size_t i1 = std::min(i0 + TILE_FILAS, alto);
+            size_t j0 = tj * TILE_COLUMNAS;
+            size_t j1 = std::min(j0 + TILE_COLUMNAS, ancho);
+            if (nucleo.esCaja) {
+                filtrarTileCaja(entrada, salida, i0, i1, j0, j1, radio, sumas, prefijo);
+            } else {
+                filtrarTileGaussiano(entrada, salida, i0, i1, j0, j1, nucleo, columnas);
+            }
+        }
+    }
+}
+
+// Motor de filtros separables: reparte la imagen en tiles del tamaño de la caché
+// y los distribuye entre los hilos. Devuelve false si las dimensiones no coinciden
+template <typename Pixel>
+bool filtrarSeparable(VistaTile<const SinDeducir<Pixel>> entrada, VistaTile<Pixel> salida,
+                      const NucleoSeparable& nucleo) {
+    if (entrada.filas != salida.filas || entrada.columnas != salida.columnas) return false;
+    #pragma omp parallel
+    filtrarSeparableEnEquipo<Pixel>(entrada, salida, nucleo);
+    return true;
+}
+
+// Tamaño de los tiles de la tubería fusionada: con el halo de cada etapa, los dos
+// buffers intermedios de un hilo ocupan ~140 KB cada uno (píxeles de 8 bits) y caben en la L2
+const size_t TUBERIA_TILE_FILAS = 64;
+const size_t TUBERIA_TILE_COLUMNAS = 2048;
+
+// Región rectangular de una imagen (o de un buffer intermedio) expresada en
+// coordenadas globales: contiene las filas [fila0, fila0+filas) y las columnas
+// [columna0, columna0+columnas) de la imagen completa
+template <typename Pixel>
+struct RegionImagen {
+    Pixel* datos;
+    size_t stride;
+    size_t fila0, columna0;
+    size_t filas, columnas;
+
+    // Puntero al primer píxel guardado (columna0) de la fila global i
+    Pixel* fila(size_t i) const { return datos + (i - fila0) * stride; }
+    Pixel& operator()(size_t i, size_t j) const { return datos[(i - fila0) * stride + (j - columna0)]; }
+};
+
+enum class TipoEtapa { Plantilla, Puntual, Reduccion };
+
+// Etapa de la tubería de imágenes. Las etapas de plantilla y puntuales calculan
+// toda la región de salida leyendo la de entrada (que incluye el halo necesario,
+// recortado a los bordes de la imagen); las de reducción acumulan en un vector
+template <typename Pixel>
+struct EtapaImagen {
+    std::string nombre;
+    TipoEtapa tipo;
+    size_t halo;  // Radio de vecindad que lee la etapa (0 en las puntuales)
+    std::function<void(const RegionImagen<const Pixel>&, const RegionImagen<Pixel>&, size_t, size_t)> transformar;
+    std::function<void(const RegionImagen<const Pixel>&, std::vector<uint64_t>&)> reducir;
+};
+
+// Desenfoque de caja k x k, normalizado con los píxeles que caen dentro de la imagen
+template <typename Pixel>
+EtapaImagen<Pixel> etapaDesenfoque(int k) {
+    const size_t radio = static_cast<size_t>(std::min(std::max(k / 2, 1), RADIO_MAXIMO));
+    EtapaImagen<Pixel> etapa;
+    etapa.nombre = "desenfoque " + std::to_string(2 * radio + 1) + "x" + std::to_string(2 * radio + 1);
+    etapa.tipo = TipoEtapa::Plantilla;
+    etapa.halo = radio;
+    etapa.transformar = [radio](const RegionImagen<const Pixel>& entrada, const RegionImagen<Pixel>& salida,
+                                size_t alto, size_t ancho) {
+        // Sumas verticales por columna de la región de entrada, privadas de cada hilo
+        thread_local std::vector<uint32_t> columnas;
+        columnas.resize(entrada.columnas);
+        const size_t j0 = salida.columna0;
+        const size_t j1 = salida.columna0 + salida.columnas;
+        const size_t ja = std::min(std::max(j0, radio), j1);
+        const size_t jb = std::max(ja, std::min(j1, ancho > radio ? ancho - radio : 0));
+        const uint32_t k = static_cast<uint32_t>(2 * radio + 1);
+
+        for (size_t i = salida.fila0; i < salida.fila0 + salida.filas; ++i) {
+            size_t fa = i > radio ? i - radio : 0;
+            size_t fb = std::min(i + radio + 1, alto);
+            std::fill(columnas.begin(), columnas.end(), 0u);
+            for (size_t f = fa; f < fb; ++f) {
+                const Pixel* origen = entrada.fila(f);
+                #pragma omp simd
+                for (size_t c = 0; c < entrada.columnas; ++c) {
+                    columnas[c] += origen[c];
+                }
+            }
+
+            const uint32_t filasVentana = static_cast<uint32_t>(fb - fa);
+            const uint32_t* suma = columnas.data() - entrada.columna0;  // Indexado por columna global
+            Pixel* destino = salida.fila(i) - salida.columna0;
+            auto filtrarBorde = [&](size_t j) {
+                size_t ca = j > radio ? j - radio : 0;
+                size_t cb = std::min(j + radio + 1, ancho);
+                uint32_t total = 0;
+                for (size_t c = ca; c < cb; ++c) {
+                    total += suma[c];
+                }
+                uint32_t cuenta = static_cast<uint32_t>(cb - ca) * filasVentana;
+                destino[j] = static_cast<Pixel>(dividirRedondeado(total, cuenta, 0.5 / cuenta));
+            };
+
+            for (size_t j = j0; j < ja; ++j) {
+                filtrarBorde(j);
+            }
+            const uint32_t cuenta = k * filasVentana;
+            const double inverso = 0.5 / cuenta;
+            #pragma omp simd
+            for (size_t j = ja; j < jb; ++j) {
+                uint32_t total = 0;
+                for (size_t d = 0; d < k; ++d) {
+                    total += suma[j - radio + d];
+                }
+                destino[j] = static_cast<Pixel>(dividirRedondeado(total, cuenta, inverso));
+            }
+            for (size_t j = jb; j < j1; ++j) {
+                filtrarBorde(j);
+            }
+        }
+    };
+    return etapa;
+}
+
+// Magnitud del gradiente de Sobel (|gx| + |gy|, saturada), replicando los bordes
+template <typename Pixel>
+EtapaImagen<Pixel> etapaSobel() {
+    EtapaImagen<Pixel> etapa;
+    etapa.nombre = "Sobel";
+    etapa.tipo = TipoEtapa::Plantilla;
+    etapa.halo = 1;
+    etapa.transformar = [](const RegionImagen<const Pixel>& entrada, const RegionImagen<Pixel>& salida,
+                           size_t alto, size_t ancho) {
+        const int maximo = std::numeric_limits<Pixel>::max();
+        for (size_t i = salida.fila0; i < salida.fila0 + salida.filas; ++i) {
+            const Pixel* a = entrada.fila(i > 0 ? i - 1 : 0);
+            const Pixel* b = entrada.fila(i);
+            const Pixel* c = entrada.fila(std::min(i + 1, alto - 1));
+            Pixel* destino = salida.fila(i);
+            auto gradiente = [&](size_t jm, size_t jc, size_t jp) {
+                int gx = (a[jp] + 2 * b[jp] + c[jp]) - (a[jm] + 2 * b[jm] + c[jm]);
+                int gy = (c[jm] + 2 * c[jc] + c[jp]) - (a[jm] + 2 * a[jc] + a[jp]);
+                return static_cast<Pixel>(std::min(std::abs(gx) + std::abs(gy), maximo));
+            };
+            const size_t j0 = salida.columna0;
+            const size_t j1 = salida.columna0 + salida.columnas;
+            const size_t e0 = entrada.columna0;
+            // Columnas interiores sin recorte; las de los bordes de la imagen replican el píxel
+            const size_t ja = std::min(std::max<size_t>(j0, 1), j1);
+            const size_t jb = std::max(ja, std::min(j1, ancho - 1));
+            for (size_t j = j0; j < ja; ++j) {
+                destino[j - j0] = gradiente(0 - e0, j - e0, std::min(j + 1, ancho - 1) - e0);
+            }
+            #pragma omp simd
+            for (size_t j = ja; j < jb; ++j) {
+                destino[j - j0] = gradiente(j - 1 - e0, j - e0, j + 1 - e0);
+            }
+            for (size_t j = jb; j < j1; ++j) {
+                destino[j - j0] = gradiente(j - 1 - e0, j - e0, ancho - 1 - e0);
+            }
+        }
+    };
+    return etapa;
+}
+
+// Umbral binario: máximo del tipo si el píxel alcanza el umbral, 0 en otro caso
+template <typename Pixel>
+EtapaImagen<Pixel> etapaUmbral(Pixel umbral) {
+    EtapaImagen<Pixel> etapa;
+    etapa.nombre = "umbral " + std::to_string(umbral);
+    etapa.tipo = TipoEtapa::Puntual;
+    etapa.halo = 0;
+    etapa.transformar = [umbral](const RegionImagen<const Pixel>& entrada, const RegionImagen<Pixel>& salida,
+                                 size_t, size_t) {
+        const Pixel maximo = std::numeric_limits<Pixel>::max();
+        for (size_t i = salida.fila0; i < salida.fila0 + salida.filas; ++i) {
+            const Pixel* origen = entrada.fila(i) + (salida.columna0 - entrada.columna0);
+            Pixel* destino = salida.fila(i);
+            #pragma omp simd
+            for (size_t j = 0; j < salida.columnas; ++j) {
+                destino[j] = origen[j] >= umbral ? maximo : 0;
+            }
+        }
+    };
+    return etapa;
+}
+
+// Cierto para los píxeles enteros sin signo de 8 o 16 bits, los únicos cuyo
+// rango completo cabe en un histograma con un contenedor por valor
+template <typename Pixel>
+struct PixelHistogramable
+    : std::integral_constant<bool, std::is_integral<Pixel>::value && std::is_unsigned<Pixel>::value &&
+                                       !std::is_same<Pixel, bool>::value &&
+                                       (sizeof(Pixel) == 1 || sizeof(Pixel) == 2)> {};
+
+// Histograma con un contenedor por cada valor posible del píxel
+template <typename Pixel>
+EtapaImagen<Pixel> etapaHistograma() {
+    static_assert(PixelHistogramable<Pixel>::value,
+                  "El histograma requiere píxeles enteros sin signo de 8 o 16 bits");
+    EtapaImagen<Pixel> etapa;
+    etapa.nombre = "histograma";
+    etapa.tipo = TipoEtapa::Reduccion;
+    etapa.halo = 0;
+    etapa.reducir = [](const RegionImagen<const Pixel>& entrada, std::vector<uint64_t>& histograma) {
+        for (size_t i = entrada.fila0; i < entrada.fila0 + entrada.filas; ++i) {
+            const Pixel* origen = entrada.fila(i);
+            for (size_t j = 0; j < entrada.columnas; ++j) {
+                ++histograma[origen[j]];
+            }
+        }
+    };
+    return etapa;
+}
+
+// Tubería de etapas de plantilla/puntuales, opcionalmente terminada en una reducción.
+// La ejecución fusionada recorre la imagen por tiles y encadena todas las etapas
+// dentro de cada tile, recalculando los halos solapados en lugar de escribir
+// las imágenes intermedias completas en memoria
+template <typename Pixel>
+class TuberiaImagen {
+private:
+    std::vector<EtapaImagen<Pixel>> etapas;
+
+    template <typename P>
+    static RegionImagen<P> regionCompleta(VistaTile<P> imagen) {
+        return RegionImagen<P>{imagen.datos, imagen.stride, 0, 0, imagen.filas, imagen.columnas};
+    }
+
+    static RegionImagen<const Pixel> comoConstante(const RegionImagen<Pixel>& region) {
+        return RegionImagen<const Pixel>{region.datos, region.stride, region.fila0, region.columna0,
+                                         region.filas, region.columnas};
+    }
+
+    size_t numTransformaciones() const {
+        return (!etapas.empty() && etapas.back().tipo == TipoEtapa::Reduccion) ? etapas.size() - 1 : etapas.size();
+    }
+
+    // Contenedores del histograma de la reducción final; sin reducción (o con
+    // píxeles que etapaHistograma no admite) no se reserva ninguno
+    size_t numContenedores() const {
+        if (numTransformaciones() == etapas.size()) return 0;
+        if constexpr (PixelHistogramable<Pixel>::value) {
+            return static_cast<size_t>(std::numeric_limits<Pixel>::max()) + 1;
+        } else {
+            return 0;
+        }
+    }
+
+public:
+    // Añade una etapa; una reducción solo puede ser la última
+    TuberiaImagen& agregar(const EtapaImagen<Pixel>& etapa) {
+        etapas.push_back(etapa);
+        return *this;
+    }
+
+    std::string descripcion() const {
+        std::string texto;
+        for (const auto& etapa : etapas) {
+            texto += (texto.empty() ? "" : " -> ") + etapa.nombre;
+        }
+        return texto;
+    }
+
+    // Ejecuta cada etapa sobre la imagen completa, materializando los intermedios.
+    // Devuelve false (en ambas ejecuciones) si las dimensiones no coinciden
+    bool ejecutarSinFusion(VistaTile<const Pixel> entrada, VistaTile<Pixel> salida,
+                           std::vector<uint64_t>& histograma) const {
+        const size_t alto = entrada.filas;
+        const size_t ancho = entrada.columnas;
+        if (salida.filas != alto || salida.columnas != ancho) return false;
+        const size_t transformaciones = numTransformaciones();
+        std::vector<Matriz2D<Pixel>> intermedios;
+        for (size_t s = 0; s + 1 < transformaciones; ++s) {
+            intermedios.emplace_back(alto, ancho);
+        }
+
+        RegionImagen<const Pixel> actual = regionCompleta(entrada);
+        for (size_t s = 0; s < transformaciones; ++s) {
+            RegionImagen<Pixel> destino = regionCompleta(s + 1 < transformaciones ? intermedios[s].vista() : salida);
+            // Reparte la imagen por bandas de filas
+            // Justificación: Cada banda escribe filas disjuntas de la salida de la etapa
+            #pragma omp parallel for schedule(static)
+            for (size_t i0 = 0; i0 < alto; i0 += TUBERIA_TILE_FILAS) {
+                RegionImagen<Pixel> banda = destino;
+                banda.datos = destino.fila(i0);
+                banda.fila0 = i0;
+                banda.filas = std::min(TUBERIA_TILE_FILAS, alto - i0);
+                etapas[s].transformar(actual, banda, alto, ancho);
+            }
+            actual = comoConstante(destino);
+        }
+
+        histograma.assign(numContenedores(), 0);
+        if (transformaciones < etapas.size()) {
+            const auto& reduccion = etapas.back();
+            #pragma omp parallel
+            {
+                std::vector<uint64_t> local(numContenedores(), 0);
+                #pragma omp for schedule(static)
+                for (size_t i0 = 0; i0 < alto; i0 += TUBERIA_TILE_FILAS) {
+                    RegionImagen<const Pixel> banda = actual;
+                    banda.datos = actual.fila(i0);
+                    banda.fila0 = i0;
+                    banda.filas = std::min(TUBERIA_TILE_FILAS, alto - i0);
+                    reduccion.reducir(banda, local);
+                }
+                // Combina los histogramas privados de cada hilo
+                // Justificación: Una única sección crítica por hilo en lugar de una operación atómica por píxel
+                #pragma omp critical
+                for (size_t b = 0; b < local.size(); ++b) {
+                    histograma[b] += local[b];
+                }
+            }
+        }
+        return true;
+    }
+
+    // Ejecuta todas las etapas tile a tile: para cada tile de salida, la etapa s
+    // calcula el tile ampliado con la suma de los halos de las etapas posteriores
+    bool ejecutarFusionada(VistaTile<const Pixel> entrada, VistaTile<Pixel> salida,
+                           std::vector<uint64_t>& histograma) const {
+        const size_t alto = entrada.filas;
+        const size_t ancho = entrada.columnas;
+        if (salida.filas != alto || salida.columnas != ancho) return false;
+        const size_t transformaciones = numTransformaciones();
+        const bool hayReduccion = transformaciones < etapas.size();
+
+        // ampliacion[s]: halo que debe cubrir la salida de la etapa s
+        std::vector<size_t> ampliacion(transformaciones + 1, 0);
+        for (size_t s = transformaciones; s-- > 1;) {
+            ampliacion[s - 1] = ampliacion[s] + etapas[s].halo;
+        }
+        const size_t haloMaximo = transformaciones > 0 ? ampliacion[0] : 0;
+        const size_t strideBuffer = TUBERIA_TILE_COLUMNAS + 2 * haloMaximo;
+        const size_t tamanoBuffer = (TUBERIA_TILE_FILAS + 2 * haloMaximo) * strideBuffer;
+        const size_t tilesVerticales = (alto + TUBERIA_TILE_FILAS - 1) / TUBERIA_TILE_FILAS;
+        const size_t tilesHorizontales = (ancho + TUBERIA_TILE_COLUMNAS - 1) / TUBERIA_TILE_COLUMNAS;
+
+        histograma.assign(numContenedores(), 0);
+        RegionImagen<const Pixel> origenCompleto = regionCompleta(entrada);
+        RegionImagen<Pixel> salidaCompleta = regionCompleta(salida);
+
+        #pragma omp parallel
+        {
+            // Buffers intermedios privados (ping-pong) reutilizados en todos los tiles del hilo
+            std::vector<Pixel> buffers[2] = {std::vector<Pixel>(tamanoBuffer), std::vector<Pixel>(tamanoBuffer)};
+            std::vector<uint64_t> local(hayReduccion ? numContenedores() : 0, 0);
+
+            // Distribuye los tiles entre los hilos
+            // Justificación: Cada tile produce una región disjunta de la salida y
+            // recalcula su propio halo, así que los tiles son independientes
+            #pragma omp for collapse(2) schedule(dynamic)
+            for (size_t ti = 0; ti < tilesVerticales; ++ti) {
+                for (size_t tj = 0; tj < tilesHorizontales; ++tj) {
+                    const size_t i0 = ti * TUBERIA_TILE_FILAS;
+                    const size_t j0 = tj * TUBERIA_TILE_COLUMNAS;
+                    const size_t i1 = std::min(i0 + TUBERIA_TILE_FILAS, alto);
+                    const size_t j1 = std::min(j0 + TUBERIA_TILE_COLUMNAS, ancho);
+
+                    RegionImagen<const Pixel> actual = origenCompleto;
+                    for (size_t s = 0; s < transformaciones; ++s) {
+                        const size_t h = ampliacion[s];
+                        const size_t fa = i0 > h ? i0 - h : 0;
+                        const size_t ca = j0 > h ? j0 - h : 0;
+                        RegionImagen<Pixel> destino;
+                        if (s + 1 == transformaciones) {
+                            destino = salidaCompleta;
+                            destino.datos = salidaCompleta.fila(i0) + j0;
+                        } else {
+                            destino.datos = buffers[s % 2].data();
+                            destino.stride = strideBuffer;
+                        }
+                        destino.fila0 = fa;
+                        destino.columna0 = ca;
+                        destino.filas = std::min(i1 + h, alto) - fa;
+                        destino.columnas = std::min(j1 + h, ancho) - ca;
+                        etapas[s].transformar(actual, destino, alto, ancho);
+                        actual = comoConstante(destino);
+                    }
+
+                    if (hayReduccion) {
+                        RegionImagen<const Pixel> tile = actual;
+                        tile.datos = &actual(i0, j0);
+                        tile.fila0 = i0;
+                        tile.columna0 = j0;
+                        tile.filas = i1 - i0;
+                        tile.columnas = j1 - j0;
+                        etapas.back().reducir(tile, local);
+                    }
+                }
+            }
+
+            if (hayReduccion) {
+                // Justificación: Una única sección crítica por hilo para combinar los histogramas
+                #pragma omp critical
+                for (size_t b = 0; b < local.size(); ++b) {
+                    histograma[b] += local[b];
+                }
+            }
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef NUCLEOS_INTEGRACION_H
+#define NUCLEOS_INTEGRACION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <omp.h>
+#include "tareas.h"
+
+// Motor de cuadratura: reglas compuestas con suma compensada y determinista, e
+// integración adaptativa con tareas. El integrando es cualquier objeto invocable
+// como f(double); al ser un parámetro de plantilla se expande dentro del bucle
+
+// Subintervalos por bloque del motor de cuadratura. Cada bloque produce una suma
+// parcial y los bloques se combinan por pares en un orden fijo, por lo que el
+// resultado no depende del número de hilos ni del reparto
+const long long BLOQUE_CUADRATURA = 1 << 14;
+
+// Carriles de evaluación simultánea: 8 doubles (un registro AVX-512, dos AVX2)
+const int CARRILES_CUADRATURA = 8;
+
+// Reglas de cuadratura sobre un subintervalo de ancho h: nodos en unidades de h
+// (0 = extremo izquierdo) y pesos que suman 1
+struct ReglaPuntoMedio {
+    static constexpr const char* nombre = "punto medio";
+    static constexpr int NODOS = 1;
+    static constexpr double nodos[NODOS] = {0.5};
+    static constexpr double pesos[NODOS] = {1.0};
+    static constexpr bool corregirExtremos = false;
+};
+
+// Simpson compuesta: el extremo derecho de cada subintervalo es el izquierdo del
+// siguiente, así que se evalúa una sola vez (peso 2/6 + 4/6 en el punto medio) y
+// al final se corrige con (f(b) - f(a)) / 6
+struct ReglaSimpson {
+    static constexpr const char* nombre = "Simpson";
+    static constexpr int NODOS = 2;
+    static constexpr double nodos[NODOS] = {0.0, 0.5};
+    static constexpr double pesos[NODOS] = {1.0 / 3.0, 2.0 / 3.0};
+    static constexpr bool corregirExtremos = true;
+};
+
+// Gauss-Legendre de 5 nodos: exacta para polinomios de grado 9
+struct ReglaGaussLegendre5 {
+    static constexpr const char* nombre = "Gauss-Legendre 5";
+    static constexpr int NODOS = 5;
+    static constexpr double nodos[NODOS] = {
+        0.5 - 0.5 * 0.9061798459386640, 0.5 - 0.5 * 0.5384693101056831, 0.5,
+        0.5 + 0.5 * 0.5384693101056831, 0.5 + 0.5 * 0.9061798459386640};
+    static constexpr double pesos[NODOS] = {
+        0.5 * 0.2369268850561891, 0.5 * 0.4786286704993665, 0.5 * 0.5688888888888889,
+        0.5 * 0.4786286704993665, 0.5 * 0.2369268850561891};
+    static constexpr bool corregirExtremos = false;
+};
+
+struct ResultadoCuadratura {
+    double valor;
+    long long evaluaciones;
+};
+
+// Suma compensada de Kahan: acumula el error de redondeo de cada suma en
+// 'compensacion' y lo reincorpora en la siguiente
+struct SumaKahan {
+    double suma = 0.0;
+    double compensacion = 0.0;
+
+    void agregar(double valor) {
+        double y = valor - compensacion;
+        double t = suma + y;
+        compensacion = (t - suma) - y;
+        suma = t;
+    }
+};
+
+// Suma por pares de valores[inicio, fin): el error crece con log(n) en lugar de n
+// y el orden de las sumas es fijo
+inline double sumaPorPares(const double* valores, size_t n) {
+    if (n <= 8) {
+        double suma = 0.0;
+        for (size_t i = 0; i < n; ++i) suma += valores[i];
+        return suma;
+    }
+    size_t mitad = n / 2;
+    return sumaPorPares(valores, mitad) + sumaPorPares(valores + mitad, n - mitad);
+}
+
+// Suma de la regla sobre los subintervalos [inicio, fin) de ancho h desde a, sin
+// multiplicar por h. Los CARRILES_CUADRATURA subintervalos consecutivos se evalúan
+// a la vez (bucle simd) y cada carril lleva su propia suma de Kahan
+template <typename Regla, typename Funcion>
+double sumarBloque(const Funcion& f, double a, double h, long long inicio, long long fin) {
+    double suma[CARRILES_CUADRATURA] = {};
+    double compensacion[CARRILES_CUADRATURA] = {};
+    long long i = inicio;
+    for (; i + CARRILES_CUADRATURA <= fin; i += CARRILES_CUADRATURA) {
+        // La conversión de 64 bits se hace una vez por grupo: long long -> double
+        // no tiene instrucción vectorial sin AVX-512DQ, int -> double sí. base + c
+        // es exacto (i < 2^53), así que el resultado no cambia
+        const double base = static_cast<double>(i);
+        #pragma omp simd
+        for (int c = 0; c < CARRILES_CUADRATURA; ++c) {
+            double valor = 0.0;
+            for (int k = 0; k < Regla::NODOS; ++k) {
+                valor += Regla::pesos[k] * f(a + (base + static_cast<double>(c) + Regla::nodos[k]) * h);
+            }
+            double y = valor - compensacion[c];
+            double t = suma[c] + y;
+            compensacion[c] = (t - suma[c]) - y;
+            suma[c] = t;
+        }
+    }
+    SumaKahan resto;
+    for (; i < fin; ++i) {
+        double valor = 0.0;
+        for (int k = 0; k < Regla::NODOS; ++k) {
+            valor += Regla::pesos[k] * f(a + (static_cast<double>(i) + Regla::nodos[k]) * h);
+        }
+        resto.agregar(valor);
+    }
+    return sumaPorPares(suma, CARRILES_CUADRATURA) + resto.suma;
+}
+
+// Regla compuesta sobre n subintervalos de [a, b]. Los bloques de
+// BLOQUE_CUADRATURA subintervalos se reparten entre los hilos y sus sumas se
+// guardan por índice de bloque para combinarlas por pares en orden fijo: el
+// resultado es idéntico bit a bit con cualquier número de hilos
+template <typename Regla, typename Funcion>
+ResultadoCuadratura integrarCompuesta(const Funcion& f, double a, double b, long long n) {
+    const double h = (b - a) / static_cast<double>(n);
+    const long long numBloques = (n + BLOQUE_CUADRATURA - 1) / BLOQUE_CUADRATURA;
+    std::vector<double> parciales(numBloques);
+
+    // Justificación: Bloques independientes de coste uniforme; no se usa
+    // reduction(+) porque su orden de combinación depende del número de hilos
+    #pragma omp parallel for schedule(static)
+    for (long long bloque = 0; bloque < numBloques; ++bloque) {
+        long long inicio = bloque * BLOQUE_CUADRATURA;
+        parciales[bloque] = sumarBloque<Regla>(f, a, h, inicio, std::min(inicio + BLOQUE_CUADRATURA, n));
+    }
+
+    double suma = sumaPorPares(parciales.data(), parciales.size());
+    long long evaluaciones = n * Regla::NODOS;
+    if (Regla::corregirExtremos) {
+        suma += (f(b) - f(a)) / 6.0;
+        evaluaciones += 1;
+    }
+    return ResultadoCuadratura{h * suma, evaluaciones};
+}
+
+// Profundidad hasta la que la subdivisión adaptativa crea tareas
+const int PROFUNDIDAD_TAREAS_CUADRATURA = 8;
+
+// Profundidad máxima de la subdivisión adaptativa
+const int PROFUNDIDAD_MAXIMA_CUADRATURA = 50;
+
+// Gauss-Legendre 5 sobre [a, b]
+template <typename Funcion>
+double gaussLegendre5(const Funcion& f, double a, double b) {
+    const double h = b - a;
+    double suma = 0.0;
+    for (int k = 0; k < ReglaGaussLegendre5::NODOS; ++k) {
+        suma += ReglaGaussLegendre5::pesos[k] * f(a + ReglaGaussLegendre5::nodos[k] * h);
+    }
+    return h * suma;
+}
+
+// Subdivisión adaptativa: compara la regla en [a, b] con la suma en sus dos
+// mitades y solo divide donde la diferencia supera la tolerancia local. Las
+// mitades de los niveles altos son tareas; el valor se combina siempre como
+// izquierda + derecha, así que no depende de qué hilo calculó cada parte
+template <typename Tareas, typename Funcion>
+ResultadoCuadratura subdividir(const Funcion& f, double a, double b, double total,
+                                      double tolerancia, int profundidad) {
+    const double medio = 0.5 * (a + b);
+    const double izquierda = gaussLegendre5(f, a, medio);
+    const double derecha = gaussLegendre5(f, medio, b);
+    const long long evaluaciones = 2 * ReglaGaussLegendre5::NODOS;
+    const double diferencia = izquierda + derecha - total;
+    if (std::abs(diferencia) <= tolerancia || profundidad >= PROFUNDIDAD_MAXIMA_CUADRATURA) {
+        return ResultadoCuadratura{izquierda + derecha, evaluaciones};
+    }
+    ResultadoCuadratura ri, rd;
+    auto mitadIzquierda = [&] { ri = subdividir<Tareas>(f, a, medio, izquierda, 0.5 * tolerancia, profundidad + 1); };
+    auto mitadDerecha = [&] { rd = subdividir<Tareas>(f, medio, b, derecha, 0.5 * tolerancia, profundidad + 1); };
+    // Las dos mitades son independientes; por debajo de cierta profundidad el
+    // coste de crear tareas supera al de evaluar
+    if (profundidad < PROFUNDIDAD_TAREAS_CUADRATURA) {
+        Tareas::unir(mitadIzquierda, mitadDerecha);
+    } else {
+        mitadIzquierda();
+        mitadDerecha();
+    }
+    return ResultadoCuadratura{ri.valor + rd.valor, evaluaciones + ri.evaluaciones + rd.evaluaciones};
+}
+
+// Integración adaptativa con Gauss-Legendre 5 hasta un error absoluto estimado
+// <= tolerancia, con las tareas del backend Tareas (TareasOpenMP o TareasRobo)
+template <typename Tareas = TareasOpenMP, typename Funcion>
+ResultadoCuadratura integrarAdaptativa(const Funcion& f, double a, double b, double tolerancia) {
+    ResultadoCuadratura resultado{0.0, 0};
+    Tareas::ejecutar([&] {
+        double total = gaussLegendre5(f, a, b);
+        resultado = subdividir<Tareas>(f, a, b, total, tolerancia, 0);
+        resultado.evaluaciones += ReglaGaussLegendre5::NODOS;
+    });
+    return resultado;
+}
+
+#endif // NUCLEOS_INTEGRACION_H
@@ -0,0 +1,660 @@
+#ifndef NUCLEOS_MATRICES_H
+#define NUCLEOS_MATRICES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <omp.h>
+#include "../multiversion.h"
+#include "tareas.h"
+#include "vista.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_X86 1
+#endif
+
+// Tamaños de bloque del GEMM por bloques (en elementos; calculados para double)
+// KC: profundidad del panel; un micro-panel de B (KC x NR) cabe en la caché L1
+// MC: filas del bloque de A empaquetado (MC x KC ~ 192 KB), pensado para la L2
+// NC: columnas del bloque de B empaquetado (KC x NC ~ 8 MB), pensado para la L3
+const size_t GEMM_KC = 256;
+const size_t GEMM_MC = 96;
+const size_t GEMM_NC = 4096;
+
+// Micro-kernel: acumula en un tile MR x NR de C (con stride ldc) el producto de un
+// micro-panel de A (MR x kc, empaquetado por columnas) y uno de B (kc x NR, empaquetado por filas)
+template <typename T>
+struct MicroKernel {
+    typedef void (*Funcion)(size_t kc, const T* a, const T* b, T* c, size_t ldc);
+    const char* nombre;
+    size_t mr;
+    size_t nr;
+    Funcion funcion;
+};
+
+// Micro-kernel genérico 4x4 en C++ puro (sin extensiones SIMD), para cualquier
+// tipo de elemento
+template <typename T>
+void microKernelGenerico(size_t kc, const T* a, const T* b, T* c, size_t ldc) {
+    T acumulador[4][4] = {};
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t c = 0; c < 4; ++c) {
+                acumulador[r][c] += a[r] * b[c];
+            }
+        }
+        a += 4;
+        b += 4;
+    }
+    for (size_t r = 0; r < 4; ++r) {
+        for (size_t col = 0; col < 4; ++col) {
+            c[r * ldc + col] += acumulador[r][col];
+        }
+    }
+}
+
+#ifdef GEMM_X86
+// Micro-kernel AVX2 + FMA 6x8: 12 registros ymm de acumulación
+__attribute__((target("avx2,fma")))
+inline void microKernelAvx2(size_t kc, const double* a, const double* b,
+                            double* c, size_t ldc) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+    for (size_t p = 0; p < kc; ++p) {
+        __m256d b0 = _mm256_loadu_pd(b);
+        __m256d b1 = _mm256_loadu_pd(b + 4);
+        __m256d ar;
+        ar = _mm256_broadcast_sd(a + 0); c00 = _mm256_fmadd_pd(ar, b0, c00); c01 = _mm256_fmadd_pd(ar, b1, c01);
+        ar = _mm256_broadcast_sd(a + 1); c10 = _mm256_fmadd_pd(ar, b0, c10); c11 = _mm256_fmadd_pd(ar, b1, c11);
+        ar = _mm256_broadcast_sd(a + 2); c20 = _mm256_fmadd_pd(ar, b0, c20); c21 = _mm256_fmadd_pd(ar, b1, c21);
+        ar = _mm256_broadcast_sd(a + 3); c30 = _mm256_fmadd_pd(ar, b0, c30); c31 = _mm256_fmadd_pd(ar, b1, c31);
+        ar = _mm256_broadcast_sd(a + 4); c40 = _mm256_fmadd_pd(ar, b0, c40); c41 = _mm256_fmadd_pd(ar, b1, c41);
+        ar = _mm256_broadcast_sd(a + 5); c50 = _mm256_fmadd_pd(ar, b0, c50); c51 = _mm256_fmadd_pd(ar, b1, c51);
+        a += 6;
+        b += 8;
+    }
+
+    __m256d acumulador[6][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                                {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t r = 0; r < 6; ++r) {
+        double* fila = c + r * ldc;
+        _mm256_storeu_pd(fila, _mm256_add_pd(_mm256_loadu_pd(fila), acumulador[r][0]));
+        _mm256_storeu_pd(fila + 4, _mm256_add_pd(_mm256_loadu_pd(fila + 4), acumulador[r][1]));
+    }
+}
+
+// Micro-kernel AVX-512 6x16: 12 registros zmm de acumulación
+__attribute__((target("avx512f")))
+inline void microKernelAvx512(size_t kc, const double* a, const double* b,
+                              double* c, size_t ldc) {
+    __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+    __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+    __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+    __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+    __m512d c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd();
+    __m512d c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd();
+
+    for (size_t p = 0; p < kc; ++p) {
+        __m512d b0 = _mm512_loadu_pd(b);
+        __m512d b1 = _mm512_loadu_pd(b + 8);
+        __m512d ar;
+        ar = _mm512_set1_pd(a[0]); c00 = _mm512_fmadd_pd(ar, b0, c00); c01 = _mm512_fmadd_pd(ar, b1, c01);
+        ar = _mm512_set1_pd(a[1]); c10 = _mm512_fmadd_pd(ar, b0, c10); c11 = _mm512_fmadd_pd(ar, b1, c11);
+        ar = _mm512_set1_pd(a[2]); c20 = _mm512_fmadd_pd(ar, b0, c20); c21 = _mm512_fmadd_pd(ar, b1, c21);
+        ar = _mm512_set1_pd(a[3]); c30 = _mm512_fmadd_pd(ar, b0, c30); c31 = _mm512_fmadd_pd(ar, b1, c31);
+        ar = _mm512_set1_pd(a[4]); c40 = _mm512_fmadd_pd(ar, b0, c40); c41 = _mm512_fmadd_pd(ar, b1, c41);
+        ar = _mm512_set1_pd(a[5]); c50 = _mm512_fmadd_pd(ar, b0, c50); c51 = _mm512_fmadd_pd(ar, b1, c51);
+        a += 6;
+        b += 16;
+    }
+
+    __m512d acumulador[6][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                                {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t r = 0; r < 6; ++r) {
+        double* fila = c + r * ldc;
+        _mm512_storeu_pd(fila, _mm512_add_pd(_mm512_loadu_pd(fila), acumulador[r][0]));
+        _mm512_storeu_pd(fila + 8, _mm512_add_pd(_mm512_loadu_pd(fila + 8), acumulador[r][1]));
+    }
+}
+
+// Micro-kernels de float: mismo bloqueo de registros que los de double, pero
+// cada registro lleva el doble de columnas
+__attribute__((target("avx2,fma")))
+inline void microKernelAvx2(size_t kc, const float* a, const float* b, float* c, size_t ldc) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for (size_t p = 0; p < kc; ++p) {
+        __m256 b0 = _mm256_loadu_ps(b);
+        __m256 b1 = _mm256_loadu_ps(b + 8);
+        __m256 ar;
+        ar = _mm256_broadcast_ss(a + 0); c00 = _mm256_fmadd_ps(ar, b0, c00); c01 = _mm256_fmadd_ps(ar, b1, c01);
+        ar = _mm256_broadcast_ss(a + 1); c10 = _mm256_fmadd_ps(ar, b0, c10); c11 = _mm256_fmadd_ps(ar, b1, c11);
+        ar = _mm256_broadcast_ss(a + 2); c20 = _mm256_fmadd_ps(ar, b0, c20); c21 = _mm256_fmadd_ps(ar, b1, c21);
+        ar = _mm256_broadcast_ss(a + 3); c30 = _mm256_fmadd_ps(ar, b0, c30); c31 = _mm256_fmadd_ps(ar, b1, c31);
+        ar = _mm256_broadcast_ss(a + 4); c40 = _mm256_fmadd_ps(ar, b0, c40); c41 = _mm256_fmadd_ps(ar, b1, c41);
+        ar = _mm256_broadcast_ss(a + 5); c50 = _mm256_fmadd_ps(ar, b0, c50); c51 = _mm256_fmadd_ps(ar, b1, c51);
+        a += 6;
+        b += 16;
+    }
+
+    __m256 acumulador[6][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                               {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t r = 0; r < 6; ++r) {
+        float* fila = c + r * ldc;
+        _mm256_storeu_ps(fila, _mm256_add_ps(_mm256_loadu_ps(fila), acumulador[r][0]));
+        _mm256_storeu_ps(fila + 8, _mm256_add_ps(_mm256_loadu_ps(fila + 8), acumulador[r][1]));
+    }
+}
+
+__attribute__((target("avx512f")))
+inline void microKernelAvx512(size_t kc, const float* a, const float* b, float* c, size_t ldc) {
+    __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+    __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+    __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+    __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+    __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+    __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+
+    for (size_t p = 0; p < kc; ++p) {
+        __m512 b0 = _mm512_loadu_ps(b);
+        __m512 b1 = _mm512_loadu_ps(b + 16);
+        __m512 ar;
+        ar = _mm512_set1_ps(a[0]); c00 = _mm512_fmadd_ps(ar, b0, c00); c01 = _mm512_fmadd_ps(ar, b1, c01);
+        ar = _mm512_set1_ps(a[1]); c10 = _mm512_fmadd_ps(ar, b0, c10); c11 = _mm512_fmadd_ps(ar, b1, c11);
+        ar = _mm512_set1_ps(a[2]); c20 = _mm512_fmadd_ps(ar, b0, c20); c21 = _mm512_fmadd_ps(ar, b1, c21);
+        ar = _mm512_set1_ps(a[3]); c30 = _mm512_fmadd_ps(ar, b0, c30); c31 = _mm512_fmadd_ps(ar, b1, c31);
+        ar = _mm512_set1_ps(a[4]); c40 = _mm512_fmadd_ps(ar, b0, c40); c41 = _mm512_fmadd_ps(ar, b1, c41);
+        ar = _mm512_set1_ps(a[5]); c50 = _mm512_fmadd_ps(ar, b0, c50); c51 = _mm512_fmadd_ps(ar, b1, c51);
+        a += 6;
+        b += 32;
+    }
+
+    __m512 acumulador[6][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                               {c30, c31}, {c40, c41}, {c50, c51}};
+    for (size_t r = 0; r < 6; ++r) {
+        float* fila = c + r * ldc;
+        _mm512_storeu_ps(fila, _mm512_add_ps(_mm512_loadu_ps(fila), acumulador[r][0]));
+        _mm512_storeu_ps(fila + 16, _mm512_add_ps(_mm512_loadu_ps(fila + 16), acumulador[r][1]));
+    }
+}
+#endif
+
+// Selecciona el micro-kernel más ancho que soporte la CPU en tiempo de ejecución.
+// Los micro-kernels SIMD existen para double y float; el resto de tipos usa el genérico
+template <typename T>
+const MicroKernel<T>& seleccionarMicroKernel() {
+    static const MicroKernel<T> generico = {"genérico 4x4", 4, 4, microKernelGenerico<T>};
+    return generico;
+}
+
+// Elige entre las versiones AVX-512 y AVX2 de un mismo tipo
+template <typename T>
+const MicroKernel<T>& seleccionarMicroKernelSimd(const MicroKernel<T>& avx512, const MicroKernel<T>& avx2,
+                                                 const MicroKernel<T>& generico) {
+#ifdef GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return avx2;
+    }
+#endif
+    return generico;
+}
+
+#ifdef GEMM_X86
+template <>
+inline const MicroKernel<double>& seleccionarMicroKernel<double>() {
+    static const MicroKernel<double> generico = {"genérico 4x4", 4, 4, microKernelGenerico<double>};
+    static const MicroKernel<double> avx2 = {"AVX2+FMA 6x8", 6, 8, microKernelAvx2};
+    static const MicroKernel<double> avx512 = {"AVX-512 6x16", 6, 16, microKernelAvx512};
+    return seleccionarMicroKernelSimd(avx512, avx2, generico);
+}
+
+template <>
+inline const MicroKernel<float>& seleccionarMicroKernel<float>() {
+    static const MicroKernel<float> generico = {"genérico 4x4", 4, 4, microKernelGenerico<float>};
+    static const MicroKernel<float> avx2 = {"AVX2+FMA 6x16", 6, 16, microKernelAvx2};
+    static const MicroKernel<float> avx512 = {"AVX-512 6x32", 6, 32, microKernelAvx512};
+    return seleccionarMicroKernelSimd(avx512, avx2, generico);
+}
+#endif
+
+// Empaqueta el bloque A[ic:ic+mc, pc:pc+kc] en micro-paneles de mr filas,
+// rellenando con ceros las filas que quedan fuera de la matriz. Los paneles
+// empaquetados son del tipo de C (TC), que puede ser más ancho que el de A
+template <typename TC, typename T>
+void empaquetarA(TC* destino, VistaTile<const T> a, size_t ic, size_t mc, size_t pc, size_t kc, size_t mr) {
+    for (size_t ir = 0; ir < mc; ir += mr) {
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t r = 0; r < mr; ++r) {
+                *destino++ = (ir + r < mc) ? static_cast<TC>(a(ic + ir + r, pc + p)) : TC(0);
+            }
+        }
+    }
+}
+
+// Empaqueta el micro-panel B[pc:pc+kc, jr:jr+nr], rellenando con ceros
+// las columnas que quedan fuera de la matriz (y convirtiendo a TC, como empaquetarA)
+template <typename TC, typename T>
+void empaquetarPanelB(TC* destino, VistaTile<const T> b, size_t pc, size_t kc, size_t jr, size_t nr) {
+    size_t columnas = std::min(nr, b.columnas - jr);
+    for (size_t p = 0; p < kc; ++p) {
+        const T* fila = b[pc + p] + jr;
+        for (size_t c = 0; c < columnas; ++c) {
+            destino[c] = static_cast<TC>(fila[c]);
+        }
+        for (size_t c = columnas; c < nr; ++c) {
+            destino[c] = TC(0);
+        }
+        destino += nr;
+    }
+}
+
+// Recorre un bloque mc x nc de C invocando el micro-kernel por cada tile MR x NR;
+// los tiles incompletos del borde se calculan en un buffer y se copian después
+template <typename T>
+void macroKernel(const MicroKernel<T>& uk, const T* aEmpaquetada, const T* bEmpaquetada,
+                 VistaTile<T> bloqueC, size_t kc, std::vector<T>& bufferBorde) {
+    const size_t mc = bloqueC.filas;
+    const size_t nc = bloqueC.columnas;
+    for (size_t jr = 0; jr < nc; jr += uk.nr) {
+        size_t nrEfectivo = std::min(uk.nr, nc - jr);
+        const T* panelB = bEmpaquetada + jr * kc;
+        for (size_t ir = 0; ir < mc; ir += uk.mr) {
+            size_t mrEfectivo = std::min(uk.mr, mc - ir);
+            const T* panelA = aEmpaquetada + ir * kc;
+
+            if (mrEfectivo == uk.mr && nrEfectivo == uk.nr) {
+                uk.funcion(kc, panelA, panelB, bloqueC[ir] + jr, bloqueC.stride);
+            } else {
+                std::fill(bufferBorde.begin(), bufferBorde.end(), T(0));
+                uk.funcion(kc, panelA, panelB, bufferBorde.data(), uk.nr);
+                for (size_t r = 0; r < mrEfectivo; ++r) {
+                    for (size_t c = 0; c < nrEfectivo; ++c) {
+                        bloqueC(ir + r, jr + c) += bufferBorde[r * uk.nr + c];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// C = A * B con A de m x k, B de k x n y C de m x n (GEMM estilo BLIS): bloques
+// NC/KC/MC para las cachés L3/L2/L1, paneles de A y B empaquetados de forma
+// contigua y un micro-kernel SIMD con bloqueo de registros elegido según la CPU.
+// Las tres vistas pueden tener cualquier stride; C no debe solaparse con A ni B.
+// Con TC más ancho que T (multiplicarBloques<float, double>) A y B se leen en
+// T y se convierten a TC al empaquetar, así que el micro-kernel y la acumulación
+// son los de TC: se leen la mitad de bytes de las entradas y el producto de dos
+// float es exacto en double. Devuelve false si las dimensiones no encajan
+template <typename T, typename TC = T>
+bool multiplicarBloques(VistaTile<const T> a, VistaTile<const T> b, VistaTile<TC> c) {
+    if (a.columnas != b.filas || c.filas != a.filas || c.columnas != b.columnas) return false;
+    const size_t m = a.filas, k = a.columnas, n = b.columnas;
+    const MicroKernel<TC>& uk = seleccionarMicroKernel<TC>();
+    const size_t mcMax = (GEMM_MC + uk.mr - 1) / uk.mr * uk.mr;
+    const size_t ncMax = (GEMM_NC + uk.nr - 1) / uk.nr * uk.nr;
+    std::vector<TC> bEmpaquetada(GEMM_KC * ncMax);
+
+    // Crea un único equipo de hilos para todo el producto
+    // Justificación: Evita abrir una región paralela por cada bloque; todos los hilos
+    // recorren los bucles jc/pc y se reparten el empaquetado de B y los bloques de A
+    #pragma omp parallel
+    {
+        std::vector<TC> aEmpaquetada(mcMax * GEMM_KC);
+        std::vector<TC> bufferBorde(uk.mr * uk.nr);
+
+        #pragma omp for
+        for (size_t i = 0; i < m; ++i) {
+            std::fill(c[i], c[i] + n, TC(0));
+        }
+
+        for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+            size_t nc = std::min(GEMM_NC, n - jc);
+            for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+                size_t kc = std::min(GEMM_KC, k - pc);
+
+                // Cada hilo empaqueta un subconjunto de micro-paneles de B
+                // Justificación: El panel de B es compartido por todos los bloques de A;
+                // la barrera implícita garantiza que esté completo antes de usarlo
+                #pragma omp for
+                for (size_t jr = 0; jr < nc; jr += uk.nr) {
+                    empaquetarPanelB(bEmpaquetada.data() + jr * kc, b, pc, kc, jc + jr, uk.nr);
+                }
+
+                // Cada hilo empaqueta su propio bloque de A y calcula su franja de C
+                // Justificación: Las franjas de filas de C son disjuntas, así que no hay
+                // condiciones de carrera; schedule(dynamic) equilibra el bloque final incompleto
+                #pragma omp for schedule(dynamic)
+                for (size_t ic = 0; ic < m; ic += GEMM_MC) {
+                    size_t mc = std::min(GEMM_MC, m - ic);
+                    empaquetarA(aEmpaquetada.data(), a, ic, mc, pc, kc, uk.mr);
+                    macroKernel(uk, aEmpaquetada.data(), bEmpaquetada.data(),
+                                c.tile(ic, jc, mc, nc), kc, bufferBorde);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Producto recursivo: dimensión máxima de una hoja (con double, los tres
+// operandos de una hoja de 64 x 64 ocupan 96 KB y caben en la L2)
+const size_t HOJA_RECURSIVA = 64;
+
+// Volumen m * k * n por debajo del cual la recursión ya no crea tareas
+const size_t VOLUMEN_TAREA_GEMM = size_t(1) << 21;
+
+// Menor dimensión a partir de la cual compensa un nivel de Strassen-Winograd:
+// ahorra un producto de cada ocho a cambio de 15 sumas de matrices, que son
+// limitadas por memoria
+const size_t UMBRAL_STRASSEN = 512;
+
+// Hoja del producto recursivo: C += A * B en orden i-p-j, que recorre B y C
+// por filas y vectoriza el bucle interior
+template <typename T>
+CLONES_SIMD void acumularProductoHoja(VistaTile<const T> a, VistaTile<const T> b, VistaTile<T> c) {
+    const size_t k = a.columnas, n = b.columnas;
+    for (size_t i = 0; i < a.filas; ++i) {
+        T* filaC = c[i];
+        for (size_t p = 0; p < k; ++p) {
+            const T aip = a(i, p);
+            const T* filaB = b[p];
+            #pragma omp simd
+            for (size_t j = 0; j < n; ++j) {
+                filaC[j] += aip * filaB[j];
+            }
+        }
+    }
+}
+
+// d = x + signo * y elemento a elemento; d puede ser la misma vista que x
+template <typename T>
+void combinarTiles(VistaTile<const T> x, VistaTile<const T> y, T signo, VistaTile<T> d) {
+    for (size_t i = 0; i < d.filas; ++i) {
+        const T* filaX = x[i];
+        const T* filaY = y[i];
+        T* filaD = d[i];
+        #pragma omp simd
+        for (size_t j = 0; j < d.columnas; ++j) {
+            filaD[j] = filaX[j] + signo * filaY[j];
+        }
+    }
+}
+
+// c += x + signo * y elemento a elemento
+template <typename T>
+void acumularCombinacion(VistaTile<T> c, VistaTile<const T> x, VistaTile<const T> y, T signo) {
+    for (size_t i = 0; i < c.filas; ++i) {
+        const T* filaX = x[i];
+        const T* filaY = y[i];
+        T* filaC = c[i];
+        #pragma omp simd
+        for (size_t j = 0; j < c.columnas; ++j) {
+            filaC[j] += filaX[j] + signo * filaY[j];
+        }
+    }
+}
+
+template <typename Tareas, typename T>
+void productoStrassen(VistaTile<const T> a, VistaTile<const T> b, VistaTile<T> c, size_t umbralStrassen);
+
+// C += A * B por división recursiva de la dimensión mayor (independiente de
+// la caché: en algún nivel los subproblemas caben en cada nivel de caché sin
+// conocer su tamaño). Las mitades de filas o columnas de C son disjuntas y se
+// calculan en tareas; al dividir k ambas mitades escriben en el mismo C y se
+// hacen en serie. Debe llamarse dentro de Tareas::ejecutar
+template <typename Tareas, typename T>
+void productoRecursivo(VistaTile<const T> a, VistaTile<const T> b, VistaTile<T> c, size_t umbralStrassen) {
+    const size_t m = a.filas, k = a.columnas, n = b.columnas;
+    if (std::max({m, k, n}) <= HOJA_RECURSIVA) {
+        acumularProductoHoja(a, b, c);
+        return;
+    }
+    if (umbralStrassen > 0 && std::min({m, k, n}) >= umbralStrassen && m % 2 == 0 && k % 2 == 0 && n % 2 == 0) {
+        productoStrassen<Tareas>(a, b, c, umbralStrassen);
+        return;
+    }
+
+    // Solo se crean tareas por encima de VOLUMEN_TAREA_GEMM: por debajo del
+    // corte el coste de la tarea supera al del producto
+    const bool conTareas = m * k * n >= VOLUMEN_TAREA_GEMM;
+    auto dividir = [conTareas](auto primera, auto segunda) {
+        if (conTareas) {
+            Tareas::unir(primera, segunda);
+        } else {
+            primera();
+            segunda();
+        }
+    };
+    if (m >= k && m >= n) {
+        // Las dos franjas de filas de C son independientes
+        const size_t mitad = m / 2;
+        dividir([=] { productoRecursivo<Tareas>(a.tile(0, 0, mitad, k), b, c.tile(0, 0, mitad, n), umbralStrassen); },
+                [=] {
+                    productoRecursivo<Tareas>(a.tile(mitad, 0, m - mitad, k), b, c.tile(mitad, 0, m - mitad, n),
+                                              umbralStrassen);
+                });
+    } else if (n >= k) {
+        // Las dos franjas de columnas de C son independientes
+        const size_t mitad = n / 2;
+        dividir([=] { productoRecursivo<Tareas>(a, b.tile(0, 0, k, mitad), c.tile(0, 0, m, mitad), umbralStrassen); },
+                [=] {
+                    productoRecursivo<Tareas>(a, b.tile(0, mitad, k, n - mitad), c.tile(0, mitad, m, n - mitad),
+                                              umbralStrassen);
+                });
+    } else {
+        const size_t mitad = k / 2;
+        productoRecursivo<Tareas>(a.tile(0, 0, m, mitad), b.tile(0, 0, mitad, n), c, umbralStrassen);
+        productoRecursivo<Tareas>(a.tile(0, mitad, m, k - mitad), b.tile(mitad, 0, k - mitad, n), c, umbralStrassen);
+    }
+}
+
+// Un nivel de Strassen-Winograd sobre A, B y C divididos en cuadrantes (las
+// tres dimensiones deben ser pares): 7 productos en lugar de 8 y 15 sumas. Los
+// productos se calculan en tareas sobre temporales propios y se acumulan en C
+template <typename Tareas, typename T>
+void productoStrassen(VistaTile<const T> a, VistaTile<const T> b, VistaTile<T> c, size_t umbralStrassen) {
+    const size_t m = a.filas / 2, k = a.columnas / 2, n = b.columnas / 2;
+    VistaTile<const T> a11 = a.tile(0, 0, m, k), a12 = a.tile(0, k, m, k);
+    VistaTile<const T> a21 = a.tile(m, 0, m, k), a22 = a.tile(m, k, m, k);
+    VistaTile<const T> b11 = b.tile(0, 0, k, n), b12 = b.tile(0, n, k, n);
+    VistaTile<const T> b21 = b.tile(k, 0, k, n), b22 = b.tile(k, n, k, n);
+
+    // Temporales: 4 sumas de A, 4 de B y los 7 productos (a cero). Las filas se
+    // rellenan si su tamaño es múltiplo de 4 KB, como en Matriz2D, para que las
+    // hojas no sufran fallos de conflicto al recorrer columnas
+    auto paso = [](size_t columnas) {
+        return (columnas * sizeof(T)) % 4096 == 0 ? columnas + 64 / sizeof(T) : columnas;
+    };
+    const size_t pasoK = paso(k), pasoN = paso(n);
+    std::vector<T> sumasA(4 * m * pasoK), sumasB(4 * k * pasoN), productos(7 * m * pasoN, T(0));
+    auto s = [&](size_t i) { return VistaTile<T>{sumasA.data() + i * m * pasoK, m, k, pasoK}; };
+    auto t = [&](size_t i) { return VistaTile<T>{sumasB.data() + i * k * pasoN, k, n, pasoN}; };
+    auto p = [&](size_t i) { return VistaTile<T>{productos.data() + i * m * pasoN, m, n, pasoN}; };
+    const T uno = T(1), menosUno = T(-1);
+
+    combinarTiles<T>(a21, a22, uno, s(0));         // S1 = A21 + A22
+    combinarTiles<T>(s(0), a11, menosUno, s(1));   // S2 = S1 - A11
+    combinarTiles<T>(a11, a21, menosUno, s(2));    // S3 = A11 - A21
+    combinarTiles<T>(a12, s(1), menosUno, s(3));   // S4 = A12 - S2
+    combinarTiles<T>(b12, b11, menosUno, t(0));    // T1 = B12 - B11
+    combinarTiles<T>(b22, t(0), menosUno, t(1));   // T2 = B22 - T1
+    combinarTiles<T>(b22, b12, menosUno, t(2));    // T3 = B22 - B12
+    combinarTiles<T>(t(1), b21, menosUno, t(3));   // T4 = T2 - B21
+
+    VistaTile<const T> izquierda[7] = {a11, a12, s(3), a22, s(0), s(1), s(2)};
+    VistaTile<const T> derecha[7] = {b11, b21, b22, t(3), t(0), t(1), t(2)};
+    // Los siete productos escriben en temporales distintos
+    Tareas::repartir(7, [&](size_t i) {
+        productoRecursivo<Tareas>(izquierda[i], derecha[i], p(i), umbralStrassen);
+    });
+
+    // U2 = M1 + M6, U3 = U2 + M7, U4 = U2 + M5 (en el sitio sobre M6 y M7)
+    combinarTiles<T>(p(5), p(0), uno, p(5));
+    combinarTiles<T>(p(6), p(5), uno, p(6));
+    combinarTiles<T>(p(5), p(4), uno, p(5));
+    acumularCombinacion<T>(c.tile(0, 0, m, n), p(0), p(1), uno);       // C11 += M1 + M2
+    acumularCombinacion<T>(c.tile(0, n, m, n), p(5), p(2), uno);       // C12 += U4 + M3
+    acumularCombinacion<T>(c.tile(m, 0, m, n), p(6), p(3), menosUno);  // C21 += U3 - M4
+    acumularCombinacion<T>(c.tile(m, n, m, n), p(6), p(4), uno);       // C22 += U3 + M5
+}
+
+// C = A * B con el producto recursivo con tareas, para matrices grandes de
+// cualquier forma y stride. Con umbralStrassen > 0, los subproblemas de
+// dimensiones pares cuya menor dimensión alcanza el umbral se resuelven con un
+// nivel de Strassen-Winograd (menos operaciones, algo más de error de
+// redondeo). Las tareas usan el backend Tareas (TareasOpenMP o TareasRobo).
+// C no debe solaparse con A ni B. Devuelve false si las dimensiones no encajan
+template <typename T, typename Tareas = TareasOpenMP>
+bool multiplicarRecursivo(VistaTile<const T> a, VistaTile<const T> b, VistaTile<T> c, size_t umbralStrassen = 0) {
+    if (a.columnas != b.filas || c.filas != a.filas || c.columnas != b.columnas) return false;
+    const size_t filasPorTarea = HOJA_RECURSIVA;
+    Tareas::ejecutar([&] {
+        // La puesta a cero de C se reparte por franjas de filas en el mismo equipo
+        Tareas::repartir((c.filas + filasPorTarea - 1) / filasPorTarea, [&](size_t franja) {
+            const size_t fin = std::min(c.filas, (franja + 1) * filasPorTarea);
+            for (size_t i = franja * filasPorTarea; i < fin; ++i) {
+                std::fill(c[i], c[i] + c.columnas, T(0));
+            }
+        });
+        productoRecursivo<Tareas>(a, b, c, umbralStrassen);
+    });
+    return true;
+}
+
+// Lotes de matrices pequeñas: volumen total (número de productos x m x k x n)
+// por debajo del cual el lote se calcula en el hilo llamador, sin región paralela
+const size_t UMBRAL_LOTE_PARALELO = size_t(1) << 20;
+
+// C = A * B con dimensiones conocidas en compilación: los bucles tienen trip
+// count constante, así que el compilador los desenrolla y mantiene en registros
+// vectoriales un bloque de hasta 16 columnas de la fila de C (con N = 64 la
+// fila entera no cabe en el banco de registros)
+template <size_t M, size_t K, size_t N, typename T>
+inline void productoFijo(const T* a, const T* b, T* c) {
+    constexpr size_t BLOQUE = N < 16 ? N : 16;
+    static_assert(N % BLOQUE == 0, "N debe ser menor que 16 o múltiplo de 16");
+    for (size_t i = 0; i < M; ++i) {
+        for (size_t j0 = 0; j0 < N; j0 += BLOQUE) {
+            T acumulador[BLOQUE] = {};
+            for (size_t p = 0; p < K; ++p) {
+                const T aip = a[i * K + p];
+                #pragma omp simd
+                for (size_t j = 0; j < BLOQUE; ++j) {
+                    acumulador[j] += aip * b[p * N + j0 + j];
+                }
+            }
+            for (size_t j = 0; j < BLOQUE; ++j) {
+                c[i * N + j0 + j] = acumulador[j];
+            }
+        }
+    }
+}
+
+// Mismo producto con dimensiones en tiempo de ejecución, para las formas sin
+// núcleo de tamaño fijo
+template <typename T>
+inline void productoVariable(size_t m, size_t k, size_t n, const T* a, const T* b, T* c) {
+    for (size_t i = 0; i < m; ++i) {
+        T* filaC = c + i * n;
+        std::fill(filaC, filaC + n, T(0));
+        for (size_t p = 0; p < k; ++p) {
+            const T aip = a[i * k + p];
+            #pragma omp simd
+            for (size_t j = 0; j < n; ++j) {
+                filaC[j] += aip * b[p * n + j];
+            }
+        }
+    }
+}
+
+// Productos [inicio, fin) del lote con el núcleo de tamaño fijo
+template <size_t M, size_t K, size_t N, typename T>
+CLONES_SIMD void multiplicarTramoFijo(const T* a, const T* b, T* c, size_t inicio, size_t fin) {
+    for (size_t l = inicio; l < fin; ++l) {
+        productoFijo<M, K, N>(a + l * M * K, b + l * K * N, c + l * M * N);
+    }
+}
+
+template <typename T>
+CLONES_SIMD void multiplicarTramoVariable(size_t m, size_t k, size_t n, const T* a, const T* b, T* c,
+                                          size_t inicio, size_t fin) {
+    for (size_t l = inicio; l < fin; ++l) {
+        productoVariable(m, k, n, a + l * m * k, b + l * k * n, c + l * m * n);
+    }
+}
+
+// Reparte los productos del lote en tramos contiguos, uno por hilo; los lotes
+// pequeños se calculan sin abrir región paralela
+template <typename Tramo>
+void repartirLote(size_t numero, size_t volumen, const Tramo& tramo) {
+    const bool paralelo = numero > 1 && numero * volumen >= UMBRAL_LOTE_PARALELO;
+    // Justificación: Los productos del lote son independientes
+    #pragma omp parallel if(paralelo)
+    {
+        const int hilo = omp_get_thread_num();
+        const int numHilos = omp_get_num_threads();
+        tramo(numero * hilo / numHilos, numero * (hilo + 1) / numHilos);
+    }
+}
+
+// Comprueba las dimensiones de un lote y devuelve su número de productos (0 si
+// los tamaños de las vistas no corresponden a un lote de m x k por k x n)
+inline size_t productosLote(size_t m, size_t k, size_t n, size_t tamA, size_t tamB, size_t tamC) {
+    if (m == 0 || k == 0 || n == 0 || tamC % (m * n) != 0) return 0;
+    const size_t numero = tamC / (m * n);
+    return (tamA == numero * m * k && tamB == numero * k * n) ? numero : 0;
+}
+
+// Lote con dimensiones fijas en compilación: C_l = A_l * B_l para cada l, con
+// A_l de M x K, B_l de K x N y C_l de M x N guardadas una tras otra en orden por
+// filas. Devuelve false si los tamaños de las vistas no corresponden a un lote
+template <size_t M, size_t K, size_t N, typename T>
+bool multiplicarLoteFijo(Vista<const SinDeducir<T>> a, Vista<const SinDeducir<T>> b, Vista<T> c) {
+    const size_t numero = productosLote(M, K, N, a.size(), b.size(), c.size());
+    if (numero == 0) return c.empty() && a.empty() && b.empty();
+    repartirLote(numero, M * K * N, [&](size_t inicio, size_t fin) {
+        multiplicarTramoFijo<M, K, N, T>(a.data(), b.data(), c.data(), inicio, fin);
+    });
+    return true;
+}
+
+// Lote con dimensiones en tiempo de ejecución: las matrices cuadradas de 4, 8,
+// 16, 32 y 64 usan el núcleo de tamaño fijo; el resto, el de tamaño variable.
+// Una sola llamada (y como mucho una región paralela) para todo el lote
+template <typename T>
+bool multiplicarLote(size_t m, size_t k, size_t n, Vista<const SinDeducir<T>> a, Vista<const SinDeducir<T>> b,
+                     Vista<T> c) {
+    if (m == k && k == n) {
+        switch (m) {
+            case 4: return multiplicarLoteFijo<4, 4, 4>(a, b, c);
+            case 8: return multiplicarLoteFijo<8, 8, 8>(a, b, c);
+            case 16: return multiplicarLoteFijo<16, 16, 16>(a, b, c);
+            case 32: return multiplicarLoteFijo<32, 32, 32>(a, b, c);
+            case 64: return multiplicarLoteFijo<64, 64, 64>(a, b, c);
+            default: break;
+        }
+    }
+    const size_t numero = productosLote(m, k, n, a.size(), b.size(), c.size());
+    if (numero == 0) return c.empty() && a.empty() && b.empty();
+    repartirLote(numero, m * k * n, [&](size_t inicio, size_t fin) {
+        multiplicarTramoVariable<T>(m, k, n, a.data(), b.data(), c.data(), inicio, fin);
+    });
+    return true;
+}
+
+#endif // NUCLEOS_MATRICES_H
@@ -0,0 +1,285 @@
+#ifndef NUCLEOS_MONTECARLO_H
+#define NUCLEOS_MONTECARLO_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+#include "../multiversion.h"
+#include "philox.h"
+
+// Puntos por bloque de la simulación con Philox: cada bloque usa su propio
+// subflujo determinista, de modo que el resultado no depende del reparto entre hilos
+const long long BLOQUE_MC = 1 << 20;
+
+// Uniformes generados por lote dentro de un bloque (caben en la caché L1)
+const size_t LOTE_UNIFORMES = 2048;
+
+// Cuenta los puntos (2u0 - 1, 2u1 - 1) que caen dentro del círculo unitario
+CLONES_SIMD
+inline long long contarDentroCirculo(const double* u, size_t puntos) {
+    long long dentro = 0;
+    #pragma omp simd reduction(+:dentro)
+    for (size_t i = 0; i < puntos; ++i) {
+        double x = 2.0 * u[2 * i] - 1.0;
+        double y = 2.0 * u[2 * i + 1] - 1.0;
+        dentro += (x * x + y * y <= 1.0);
+    }
+    return dentro;
+}
+
+// Puntos de [-1,1]^2 dentro del círculo unitario entre numPuntos generados con
+// Philox: el bloque b de BLOQUE_MC puntos usa el subflujo b de la semilla, y los
+// conteos enteros por bloque se suman exactamente, así el resultado es idéntico
+// bit a bit con cualquier número de hilos (numHilos <= 0: los de por defecto)
+inline long long contarDentroCirculoPhilox(long long numPuntos, uint64_t semilla, int numHilos = 0) {
+    const long long numBloques = (numPuntos + BLOQUE_MC - 1) / BLOQUE_MC;
+    long long dentroCirculo = 0;
+    if (numHilos <= 0) numHilos = omp_get_max_threads();
+
+    // Justificación: Los bloques son independientes; la reducción es de enteros
+    // y por tanto asociativa, sin diferencias por el orden de combinación
+    #pragma omp parallel for schedule(static) reduction(+:dentroCirculo) num_threads(numHilos)
+    for (long long bloque = 0; bloque < numBloques; ++bloque) {
+        FlujoPhilox flujo(semilla, static_cast<uint64_t>(bloque));
+        alignas(64) double u[LOTE_UNIFORMES];
+        long long restantes = std::min(BLOQUE_MC, numPuntos - bloque * BLOQUE_MC);
+        while (restantes > 0) {
+            const size_t puntos = static_cast<size_t>(std::min<long long>(restantes, LOTE_UNIFORMES / 2));
+            flujo.uniformes(u, 2 * puntos);
+            dentroCirculo += contarDentroCirculo(u, puntos);
+            restantes -= static_cast<long long>(puntos);
+        }
+    }
+    return dentroCirculo;
+}
+
+// Técnicas de muestreo del integrador de Monte Carlo
+enum class MetodoMuestreo { Simple, Antitetico, Estratificado, Sobol };
+
+// Muestras por bloque del integrador (potencia de dos: los bloques de Sobol usan
+// los 2^12 primeros puntos de la secuencia). Cada bloque es una réplica
+// independiente y el error estándar se estima a partir de la dispersión entre bloques
+const size_t BLOQUE_INTEGRACION = 1 << 12;
+
+// Bloques por ronda: tras cada ronda se comprueba el criterio de parada. Es una
+// constante (no depende del número de hilos) para que el resultado sea reproducible
+const size_t BLOQUES_POR_RONDA = 64;
+
+// Dimensión máxima admitida por la secuencia de Sobol
+const size_t DIMENSION_MAXIMA_SOBOL = 16;
+
+struct ResultadoIntegracion {
+    double estimacion;
+    double errorEstandar;
+    long long evaluaciones;   // Evaluaciones del integrando
+    bool convergio;           // Se alcanzó el error objetivo antes del máximo
+};
+
+// Números de dirección de Sobol (Joe y Kuo, new-joe-kuo-6.21201) para las
+// dimensiones 2..16; la dimensión 1 es la secuencia de van der Corput
+struct PolinomioSobol {
+    unsigned grado;
+    unsigned coeficientes;
+    unsigned m[6];
+};
+
+const PolinomioSobol POLINOMIOS_SOBOL[DIMENSION_MAXIMA_SOBOL - 1] = {
+    {1, 0, {1}},                    {2, 1, {1, 3}},                 {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},              {4, 1, {1, 1, 3, 3}},           {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},       {5, 4, {1, 1, 5, 5, 5}},        {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},       {5, 13, {1, 1, 1, 3, 11}},      {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},    {6, 13, {1, 1, 1, 15, 21, 21}}, {6, 16, {1, 3, 1, 13, 27, 49}},
+};
+
+// Tabla de direcciones v[dimensión][bit] en punto fijo de 32 bits
+inline const uint32_t (&direccionesSobol())[DIMENSION_MAXIMA_SOBOL][32] {
+    static uint32_t v[DIMENSION_MAXIMA_SOBOL][32];
+    static bool inicializada = [] {
+        for (unsigned k = 0; k < 32; ++k) v[0][k] = 1u << (31 - k);
+        for (size_t d = 1; d < DIMENSION_MAXIMA_SOBOL; ++d) {
+            const PolinomioSobol& p = POLINOMIOS_SOBOL[d - 1];
+            for (unsigned k = 0; k < 32; ++k) {
+                if (k < p.grado) {
+                    v[d][k] = p.m[k] << (31 - k);
+                } else {
+                    uint32_t valor = v[d][k - p.grado] ^ (v[d][k - p.grado] >> p.grado);
+                    for (unsigned l = 1; l < p.grado; ++l) {
+                        if ((p.coeficientes >> (p.grado - 1 - l)) & 1) valor ^= v[d][k - l];
+                    }
+                    v[d][k] = valor;
+                }
+            }
+        }
+        return true;
+    }();
+    (void)inicializada;
+    return v;
+}
+
+// Integrador de Monte Carlo sobre el hiperrectángulo [inferior, superior] de
+// dimensión D. El integrando es cualquier objeto invocable como f(const double* x);
+// al ser un parámetro de plantilla, su llamada se expande dentro del bucle de muestreo.
+// El bloque b de la ronda r usa el subflujo Philox r * BLOQUES_POR_RONDA + b, y las
+// estimaciones por bloque se combinan en orden de bloque: el resultado (incluido
+// el momento de parada) es idéntico con cualquier número de hilos
+template <size_t D>
+class IntegradorMonteCarlo {
+    static_assert(D >= 1, "La dimensión debe ser al menos 1");
+
+private:
+    double inferior[D];
+    double ancho[D];
+    double volumen;
+    uint64_t semilla;
+
+    // Puntos por lote de uniformes dentro de un bloque
+    static const size_t LOTE_PUNTOS = 256;
+
+    static size_t potencia(size_t k) {
+        size_t resultado = 1;
+        for (size_t d = 0; d < D && resultado <= BLOQUE_INTEGRACION; ++d) resultado *= k;
+        return resultado;
+    }
+
+    // Estratos por dimensión: el mayor k con k^D <= BLOQUE_INTEGRACION (en
+    // dimensión alta k tiende a 1 y el muestreo estratificado se reduce al simple)
+    static size_t estratosPorDimension() {
+        size_t k = 1;
+        while (potencia(k + 1) <= BLOQUE_INTEGRACION) ++k;
+        return k;
+    }
+
+    static size_t evaluacionesPorBloque(MetodoMuestreo metodo) {
+        if (metodo == MetodoMuestreo::Estratificado) {
+            size_t estratos = potencia(estratosPorDimension());
+            return estratos * (BLOQUE_INTEGRACION / estratos);
+        }
+        return BLOQUE_INTEGRACION;
+    }
+
+    // Estimación de la media del integrando en un bloque con el método indicado
+    template <typename Funcion>
+    double estimarBloque(const Funcion& f, MetodoMuestreo metodo, uint64_t idBloque) const {
+        FlujoPhilox flujo(semilla, idBloque);
+        alignas(64) double u[LOTE_PUNTOS * D];
+        double x[D];
+        double suma = 0.0;
+
+        if (metodo == MetodoMuestreo::Simple || metodo == MetodoMuestreo::Antitetico) {
+            // Antitético: cada u se acompaña de 1 - u, que está correlado negativamente
+            // con él en integrandos monótonos; el bloque evalúa la mitad de puntos base
+            const bool antitetico = metodo == MetodoMuestreo::Antitetico;
+            const size_t puntos = antitetico ? BLOQUE_INTEGRACION / 2 : BLOQUE_INTEGRACION;
+            for (size_t inicio = 0; inicio < puntos; inicio += LOTE_PUNTOS) {
+                const size_t n = std::min(LOTE_PUNTOS, puntos - inicio);
+                flujo.uniformes(u, n * D);
+                for (size_t p = 0; p < n; ++p) {
+                    for (size_t d = 0; d < D; ++d) x[d] = inferior[d] + ancho[d] * u[p * D + d];
+                    double valor = f(x);
+                    if (antitetico) {
+                        for (size_t d = 0; d < D; ++d) x[d] = inferior[d] + ancho[d] * (1.0 - u[p * D + d]);
+                        valor = 0.5 * (valor + f(x));
+                    }
+                    suma += valor;
+                }
+            }
+            return suma / puntos;
+        }
+
+        if (metodo == MetodoMuestreo::Estratificado) {
+            // Rejilla de k^D estratos iguales con el mismo número de puntos en cada uno
+            const size_t k = estratosPorDimension();
+            const size_t puntos = evaluacionesPorBloque(metodo);
+            const size_t porEstrato = puntos / potencia(k);
+            for (size_t inicio = 0; inicio < puntos; inicio += LOTE_PUNTOS) {
+                const size_t n = std::min(LOTE_PUNTOS, puntos - inicio);
+                flujo.uniformes(u, n * D);
+                for (size_t p = 0; p < n; ++p) {
+                    size_t estrato = (inicio + p) / porEstrato;
+                    for (size_t d = 0; d < D; ++d) {
+                        size_t celda = estrato % k;
+                        estrato /= k;
+                        x[d] = inferior[d] + ancho[d] * ((celda + u[p * D + d]) / k);
+                    }
+                    suma += f(x);
+                }
+            }
+            return suma / puntos;
+        }
+
+        // Sobol con desplazamiento digital aleatorio por bloque (QMC aleatorizado):
+        // cada bloque recorre los mismos 2^12 puntos en código Gray, desplazados con
+        // un XOR distinto, de modo que las réplicas son independientes e insesgadas
+        const auto& v = direccionesSobol();
+        uint32_t desplazamiento[D];
+        uint32_t actual[D];
+        flujo.uniformes(u, D);
+        for (size_t d = 0; d < D; ++d) {
+            desplazamiento[d] = static_cast<uint32_t>(u[d] * 4294967296.0);
+            actual[d] = 0;
+        }
+        for (size_t n = 0; n < BLOQUE_INTEGRACION; ++n) {
+            if (n > 0) {
+                const unsigned bit = __builtin_ctzll(n);
+                for (size_t d = 0; d < D; ++d) actual[d] ^= v[d][bit];
+            }
+            for (size_t d = 0; d < D; ++d) {
+                x[d] = inferior[d] + ancho[d] * ((actual[d] ^ desplazamiento[d]) * 0x1.0p-32);
+            }
+            suma += f(x);
+        }
+        return suma / BLOQUE_INTEGRACION;
+    }
+
+public:
+    IntegradorMonteCarlo(const double (&minimo)[D], const double (&maximo)[D], uint64_t s) : volumen(1.0), semilla(s) {
+        for (size_t d = 0; d < D; ++d) {
+            inferior[d] = minimo[d];
+            ancho[d] = maximo[d] - minimo[d];
+            volumen *= ancho[d];
+        }
+    }
+
+    // Integra f hasta que el error estándar estimado sea <= errorObjetivo o se
+    // agoten maxEvaluaciones evaluaciones del integrando
+    template <typename Funcion>
+    ResultadoIntegracion integrar(const Funcion& f, MetodoMuestreo metodo, double errorObjetivo,
+                                  long long maxEvaluaciones) const {
+        if (metodo == MetodoMuestreo::Sobol && D > DIMENSION_MAXIMA_SOBOL) {
+            return ResultadoIntegracion{0.0, INFINITY, 0, false};
+        }
+        const long long porRonda = static_cast<long long>(BLOQUES_POR_RONDA * evaluacionesPorBloque(metodo));
+        std::vector<double> estimaciones(BLOQUES_POR_RONDA);
+        double media = 0.0, m2 = 0.0;
+        long long bloques = 0;
+        ResultadoIntegracion resultado{0.0, INFINITY, 0, false};
+
+        for (uint64_t ronda = 0; resultado.evaluaciones + porRonda <= std::max(maxEvaluaciones, porRonda); ++ronda) {
+            // Justificación: Los bloques son independientes y de coste uniforme
+            #pragma omp parallel for schedule(static)
+            for (size_t b = 0; b < BLOQUES_POR_RONDA; ++b) {
+                estimaciones[b] = estimarBloque(f, metodo, ronda * BLOQUES_POR_RONDA + b);
+            }
+            // Combinación de Welford en orden de bloque (determinista)
+            for (double e : estimaciones) {
+                ++bloques;
+                double delta = e - media;
+                media += delta / bloques;
+                m2 += delta * (e - media);
+            }
+            resultado.evaluaciones += porRonda;
+            resultado.estimacion = volumen * media;
+            resultado.errorEstandar = volumen * std::sqrt(m2 / (bloques - 1) / bloques);
+            if (resultado.errorEstandar <= errorObjetivo) {
+                resultado.convergio = true;
+                break;
+            }
+        }
+        return resultado;
+    }
+};
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef NUCLEOS_ORDENAMIENTO_H
+#define NUCLEOS_ORDENAMIENTO_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <omp.h>
+#include "tareas.h"
+#include "vista.h"
+
+// Tamaño por debajo del cual una hoja se ordena con inserción directa
+const size_t CORTE_INSERCION = 32;
+
+// Corte de hoja por defecto del merge sort: subarreglos menores se ordenan sin
+// crear tareas
+const size_t CORTE_HOJA_MEZCLA = 8192;
+
+// Elementos de salida por tarea en la mezcla paralela
+const size_t GRANO_MEZCLA = 1 << 16;
+
+// Radix LSD: dígitos de 8 bits, una pasada por byte de la clave
+const int BITS_RADIX = 8;
+const size_t CUBETAS_RADIX = size_t(1) << BITS_RADIX;
+
+// Elementos por cubeta en los buffers de combinación de escritura, que se
+// vuelcan enteros de una vez (una línea de caché con claves de 32 bits)
+const size_t BUFFER_RADIX = 16;
+
+// Ordenamiento por inserción para hojas muy pequeñas
+template <typename T>
+void ordenarInsercion(T* datos, size_t n) {
+    for (size_t i = 1; i < n; ++i) {
+        T valor = datos[i];
+        size_t j = i;
+        while (j > 0 && datos[j - 1] > valor) {
+            datos[j] = datos[j - 1];
+            --j;
+        }
+        datos[j] = valor;
+    }
+}
+
+// Co-rango: devuelve i tal que los k primeros elementos de la mezcla estable
+// de a[0,n) y b[0,m) son a[0,i) y b[0,k-i) (búsqueda binaria sobre i)
+template <typename T>
+size_t coRango(size_t k, const T* a, size_t n, const T* b, size_t m) {
+    size_t lo = k > m ? k - m : 0;
+    size_t hi = std::min(k, n);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+        if (j > 0 && a[i] <= b[j - 1]) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+// Mezcla secuencial estable de a[0,n) y b[0,m) en destino
+template <typename T>
+void mezclarSecuencial(const T* a, size_t n, const T* b, size_t m, T* destino) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < n && j < m) {
+        destino[k++] = (a[i] <= b[j]) ? a[i++] : b[j++];
+    }
+    while (i < n) destino[k++] = a[i++];
+    while (j < m) destino[k++] = b[j++];
+}
+
+// Mezcla paralela: divide la salida en bloques de GRANO_MEZCLA elementos y
+// localiza con el co-rango qué parte de cada entrada le corresponde a cada
+// bloque. Crea tareas del backend Tareas, así que debe llamarse dentro de
+// Tareas::ejecutar
+template <typename Tareas, typename T>
+void mezclarParalelo(const T* a, size_t n, const T* b, size_t m, T* destino) {
+    const size_t total = n + m;
+    if (total <= GRANO_MEZCLA) {
+        mezclarSecuencial(a, n, b, m, destino);
+        return;
+    }
+    // Cada bloque de salida es independiente: sus límites se calculan con
+    // búsqueda binaria, sin comunicación entre tareas
+    Tareas::repartir((total + GRANO_MEZCLA - 1) / GRANO_MEZCLA, [=](size_t bloque) {
+        size_t k0 = bloque * GRANO_MEZCLA;
+        size_t k1 = std::min(k0 + GRANO_MEZCLA, total);
+        size_t i0 = coRango(k0, a, n, b, m);
+        size_t i1 = coRango(k1, a, n, b, m);
+        mezclarSecuencial(a + i0, i1 - i0, b + (k0 - i0), (k1 - i1) - (k0 - i0), destino + k0);
+    });
+}
+
+// Merge sort con buffer ping-pong: ordena a[inicio,fin) y deja el resultado en
+// b si haciaB es verdadero, o en a en caso contrario. Las mitades se ordenan
+// hacia el otro buffer, así cada nivel mezcla sin reservar memoria
+template <typename Tareas, typename T>
+void mergeSortPingPong(T* a, T* b, size_t inicio, size_t fin, bool haciaB, size_t corteHoja) {
+    const size_t n = fin - inicio;
+    if (n <= corteHoja) {
+        if (n <= CORTE_INSERCION) {
+            ordenarInsercion(a + inicio, n);
+        } else {
+            std::sort(a + inicio, a + fin);
+        }
+        if (haciaB) {
+            std::copy(a + inicio, a + fin, b + inicio);
+        }
+        return;
+    }
+
+    size_t medio = inicio + n / 2;
+    // Solo se crean tareas por encima del corte de hoja, para evitar millones
+    // de tareas diminutas cuyo coste supera el trabajo útil
+    Tareas::unir([=] { mergeSortPingPong<Tareas>(a, b, inicio, medio, !haciaB, corteHoja); },
+                 [=] { mergeSortPingPong<Tareas>(a, b, medio, fin, !haciaB, corteHoja); });
+    const T* origen = haciaB ? a : b;
+    T* destino = haciaB ? b : a;
+    mezclarParalelo<Tareas>(origen + inicio, medio - inicio, origen + medio, fin - medio, destino + inicio);
+}
+
+// Ordena datos en paralelo con merge sort; auxiliar (al menos datos.size()
+// elementos) es el buffer ping-pong del llamador. Devuelve false si es pequeño.
+// Las tareas usan el backend Tareas (TareasOpenMP o TareasRobo)
+template <typename Tareas = TareasOpenMP, typename T>
+bool ordenarMezcla(Vista<T> datos, Vista<T> auxiliar, size_t corteHoja = CORTE_HOJA_MEZCLA) {
+    if (auxiliar.size() < datos.size()) return false;
+    corteHoja = std::max<size_t>(corteHoja, 1);
+    Tareas::ejecutar([&] {
+        mergeSortPingPong<Tareas>(datos.data(), auxiliar.data(), 0, datos.size(), false, corteHoja);
+    });
+    return true;
+}
+
+// Transformación de un entero de cualquier ancho a una clave sin signo del
+// mismo tamaño y con el mismo orden: en los tipos con signo se invierte el bit
+// de signo, y la transformación es su propia inversa
+template <typename T>
+struct ClaveRadix {
+    static_assert(std::is_integral<T>::value, "el radix sort solo ordena claves enteras");
+    typedef typename std::make_unsigned<T>::type Tipo;
+    static constexpr Tipo SIGNO = std::is_signed<T>::value ? Tipo(Tipo(1) << (8 * sizeof(T) - 1)) : Tipo(0);
+
+    static Tipo ordenable(T valor) { return static_cast<Tipo>(valor) ^ SIGNO; }
+    static T original(Tipo clave) { return static_cast<T>(static_cast<Tipo>(clave ^ SIGNO)); }
+};
+
+// Radix sort LSD paralelo sobre claves sin signo K (8, 16, 32 o 64 bits). Si
+// ConValores, cada valor acompaña a su clave (ordenación estable de pares
+// clave/valor). auxClaves/auxValores son buffers ping-pong del mismo tamaño;
+// el resultado queda siempre en claves/valores
+template <bool ConValores, typename K>
+void radixSortLSD(K* claves, uint32_t* valores, size_t n, K* auxClaves, uint32_t* auxValores) {
+    static_assert(std::is_unsigned<K>::value, "las claves del radix sort deben ser sin signo");
+    const int maxHilos = omp_get_max_threads();
+    // histogramas[hilo * CUBETAS_RADIX + cubeta]: primero cuentas, luego desplazamientos
+    std::vector<size_t> histogramas(static_cast<size_t>(maxHilos) * CUBETAS_RADIX);
+    std::vector<size_t> totales(CUBETAS_RADIX);
+    bool saltarPasada = false;
+    bool resultadoEnAux = false;
+
+    // Un único equipo para todas las pasadas: cada hilo conserva su bloque
+    // contiguo de entrada (schedule estático implícito) y sus buffers
+    // Justificación: Evita recrear el equipo y reservar buffers en cada pasada
+    #pragma omp parallel
+    {
+        const int hilo = omp_get_thread_num();
+        const int numHilos = omp_get_num_threads();
+        const size_t ini = n * hilo / numHilos;
+        const size_t fin = n * (hilo + 1) / numHilos;
+        size_t* cuenta = &histogramas[static_cast<size_t>(hilo) * CUBETAS_RADIX];
+
+        // Buffers de combinación de escritura propios del hilo
+        std::vector<K> bufClaves(CUBETAS_RADIX * BUFFER_RADIX);
+        std::vector<uint32_t> bufValores(ConValores ? CUBETAS_RADIX * BUFFER_RADIX : 0);
+        std::vector<uint32_t> llenos(CUBETAS_RADIX);
+
+        K* origenClaves = claves;
+        uint32_t* origenValores = valores;
+        K* destinoClaves = auxClaves;
+        uint32_t* destinoValores = auxValores;
+
+        for (int desplazamiento = 0; desplazamiento < int(8 * sizeof(K)); desplazamiento += BITS_RADIX) {
+            // 1) Histograma local del dígito actual
+            std::fill(cuenta, cuenta + CUBETAS_RADIX, size_t(0));
+            for (size_t i = ini; i < fin; ++i) {
+                ++cuenta[(origenClaves[i] >> desplazamiento) & (CUBETAS_RADIX - 1)];
+            }
+            #pragma omp barrier
+
+            // 2) Suma prefija en paralelo por cubetas: cada hilo recorre los
+            // hilos para sus cubetas y deja el desplazamiento dentro de la cubeta
+            // Justificación: Las cubetas son independientes entre sí
+            #pragma omp for schedule(static)
+            for (size_t cubeta = 0; cubeta < CUBETAS_RADIX; ++cubeta) {
+                size_t acumulado = 0;
+                for (int h = 0; h < numHilos; ++h) {
+                    size_t& celda = histogramas[static_cast<size_t>(h) * CUBETAS_RADIX + cubeta];
+                    size_t valor = celda;
+                    celda = acumulado;
+                    acumulado += valor;
+                }
+                totales[cubeta] = acumulado;
+            }
+
+            // Prefijo exclusivo entre cubetas (256 elementos, un solo hilo)
+            #pragma omp single
+            {
+                size_t base = 0;
+                saltarPasada = false;
+                for (size_t cubeta = 0; cubeta < CUBETAS_RADIX; ++cubeta) {
+                    // Si todas las claves comparten el dígito la pasada no reordena nada
+                    if (totales[cubeta] == n) saltarPasada = true;
+                    size_t valor = totales[cubeta];
+                    totales[cubeta] = base;
+                    base += valor;
+                }
+            }
+            if (saltarPasada) continue;
+
+            // 3) Dispersión estable a través de los buffers de combinación de
+            // escritura: cada cubeta se escribe en memoria por bloques completos
+            for (size_t cubeta = 0; cubeta < CUBETAS_RADIX; ++cubeta) {
+                cuenta[cubeta] += totales[cubeta];
+            }
+            std::fill(llenos.begin(), llenos.end(), 0u);
+            for (size_t i = ini; i < fin; ++i) {
+                const K clave = origenClaves[i];
+                const size_t cubeta = (clave >> desplazamiento) & (CUBETAS_RADIX - 1);
+                const uint32_t posicion = llenos[cubeta]++;
+                bufClaves[cubeta * BUFFER_RADIX + posicion] = clave;
+                if (ConValores) bufValores[cubeta * BUFFER_RADIX + posicion] = origenValores[i];
+                if (posicion + 1 == BUFFER_RADIX) {
+                    std::memcpy(destinoClaves + cuenta[cubeta], &bufClaves[cubeta * BUFFER_RADIX],
+                                BUFFER_RADIX * sizeof(K));
+                    if (ConValores) {
+                        std::memcpy(destinoValores + cuenta[cubeta], &bufValores[cubeta * BUFFER_RADIX],
+                                    BUFFER_RADIX * sizeof(uint32_t));
+                    }
+                    cuenta[cubeta] += BUFFER_RADIX;
+                    llenos[cubeta] = 0;
+                }
+            }
+            // Vacía los restos parciales de cada cubeta
+            for (size_t cubeta = 0; cubeta < CUBETAS_RADIX; ++cubeta) {
+                std::memcpy(destinoClaves + cuenta[cubeta], &bufClaves[cubeta * BUFFER_RADIX],
+                            llenos[cubeta] * sizeof(K));
+                if (ConValores) {
+                    std::memcpy(destinoValores + cuenta[cubeta], &bufValores[cubeta * BUFFER_RADIX],
+                                llenos[cubeta] * sizeof(uint32_t));
+                }
+            }
+            // La siguiente pasada lee lo que escribieron todos los hilos
+            #pragma omp barrier
+            std::swap(origenClaves, destinoClaves);
+            std::swap(origenValores, destinoValores);
+        }
+
+        #pragma omp single
+        resultadoEnAux = (origenClaves != claves);
+
+        // Si el número de pasadas efectivas fue impar, devuelve el resultado al origen
+        if (resultadoEnAux) {
+            std::memcpy(claves + ini, auxClaves + ini, (fin - ini) * sizeof(K));
+            if (ConValores) std::memcpy(valores + ini, auxValores + ini, (fin - ini) * sizeof(uint32_t));
+        }
+    }
+}
+
+// Ordena datos en paralelo con radix sort LSD; auxiliar (al menos datos.size()
+// elementos) es el buffer ping-pong. Las claves se transforman en el sitio a
+// sin signo y se restauran al final. Devuelve false si auxiliar es pequeño
+template <typename T>
+bool ordenarRadix(Vista<T> datos, Vista<T> auxiliar) {
+    typedef ClaveRadix<T> Clave;
+    typedef typename Clave::Tipo K;
+    if (auxiliar.size() < datos.size()) return false;
+    const size_t n = datos.size();
+    // T y su versión sin signo pueden accederse una como la otra
+    K* claves = reinterpret_cast<K*>(datos.data());
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        claves[i] = Clave::ordenable(datos[i]);
+    }
+    radixSortLSD<false>(claves, static_cast<uint32_t*>(nullptr), n, reinterpret_cast<K*>(auxiliar.data()),
+                        static_cast<uint32_t*>(nullptr));
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        datos[i] = Clave::original(claves[i]);
+    }
+    return true;
+}
+
+// Ordena pares clave/índice: escribe en permutacion la permutación estable p
+// tal que claves[p[0]] <= claves[p[1]] <= ..., para reordenar registros por su
+// clave. Las claves no se modifican. Devuelve false si los tamaños no
+// coinciden o los índices no caben en 32 bits
+template <typename U>
+bool ordenarRadixIndices(Vista<U> claves, Vista<uint32_t> permutacion) {
+    typedef ClaveRadix<SinConst<U>> Clave;
+    typedef typename Clave::Tipo K;
+    const size_t n = claves.size();
+    if (permutacion.size() != n || n > size_t(UINT32_MAX)) return false;
+    std::vector<K> ordenables(n), auxClaves(n);
+    std::vector<uint32_t> auxIndices(n);
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        ordenables[i] = Clave::ordenable(claves[i]);
+        permutacion[i] = static_cast<uint32_t>(i);
+    }
+    radixSortLSD<true>(ordenables.data(), permutacion.data(), n, auxClaves.data(), auxIndices.data());
+    return true;
+}
+
+#endif
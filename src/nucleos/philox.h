@@ -0,0 +1,111 @@
+#ifndef NUCLEOS_PHILOX_H
+#define NUCLEOS_PHILOX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "../multiversion.h"
+
+// Generador basado en contador Philox4x32-10 (Salmon et al., SC'11): la salida es
+// una función pura de (clave, contador), sin estado entre llamadas. Cada subflujo
+// fija la mitad alta del contador y la posición dentro de él es la mitad baja, así
+// saltar hacia delante es una suma y no hay que guardar ~2.5 KB como en mt19937
+class FlujoPhilox {
+private:
+    uint32_t clave[2];
+    uint64_t flujo;      // Identificador del subflujo (palabras 2 y 3 del contador)
+    uint64_t contador;   // Posición dentro del subflujo (palabras 0 y 1)
+
+public:
+    FlujoPhilox(uint64_t semilla, uint64_t idFlujo)
+        : clave{static_cast<uint32_t>(semilla), static_cast<uint32_t>(semilla >> 32)},
+          flujo(idFlujo), contador(0) {}
+
+    // Aplica las 10 rondas de Philox4x32 al contador (c0..c3) con la clave (k0, k1).
+    // Trabaja sobre escalares para que, dentro de un bucle simd, cada palabra
+    // quede en un registro vectorial
+    static inline void philox(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3,
+                              uint32_t k0, uint32_t k1) {
+        // Desenrollado completo: sin él el bucle de uniformes no se vectoriza
+        #pragma GCC unroll 10
+        for (int ronda = 0; ronda < 10; ++ronda) {
+            uint64_t p0 = uint64_t(0xD2511F53u) * c0;
+            uint64_t p1 = uint64_t(0xCD9E8D57u) * c2;
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<uint32_t>(p1);
+            c3 = static_cast<uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+    }
+
+    // Avanza el subflujo n posiciones (cada posición produce dos doubles)
+    void saltar(uint64_t n) { contador += n; }
+
+    // Convierte 64 bits aleatorios en un double uniforme en [0, 1) con 52 bits:
+    // se colocan como mantisa de un número en [1, 2) y se resta 1. A diferencia de
+    // la conversión entera de 64 bits, estas operaciones existen en SSE2/AVX2
+    static inline double aDouble(uint64_t bits) {
+        uint64_t patron = (bits >> 12) | 0x3FF0000000000000ull;
+        double valor;
+        std::memcpy(&valor, &patron, sizeof(valor));
+        return valor - 1.0;
+    }
+
+    // Llena destino con n uniformes en [0, 1), en el orden del flujo (dos por contador)
+    void uniformes(double* destino, size_t n);
+};
+
+// Genera 2 * pares uniformes de los contadores base .. base+pares-1 del subflujo
+// (f0, f1). Cada contador produce 128 bits (dos doubles); las iteraciones son
+// independientes y se vectorizan (multiplicaciones 32x32->64 por carril). Con
+// solo SSE2 el compilador considera que vectorizarlas no es rentable, de ahí
+// las versiones AVX2 y AVX-512
+CLONES_SIMD
+inline void uniformesPhilox(double* destino, size_t pares, uint64_t base,
+                            uint32_t k0, uint32_t k1, uint32_t f0, uint32_t f1) {
+    #pragma omp simd
+    for (size_t i = 0; i < pares; ++i) {
+        uint64_t ctr = base + i;
+        uint32_t c0 = static_cast<uint32_t>(ctr), c1 = static_cast<uint32_t>(ctr >> 32), c2 = f0, c3 = f1;
+        FlujoPhilox::philox(c0, c1, c2, c3, k0, k1);
+        destino[2 * i] = FlujoPhilox::aDouble((uint64_t(c0) << 32) | c1);
+        destino[2 * i + 1] = FlujoPhilox::aDouble((uint64_t(c2) << 32) | c3);
+    }
+}
+
+// Escribe en primera[i] y segunda[i] las dos mitades de 64 bits de la salida
+// del contador base + i del subflujo (f0, f1). Es la materia prima de los
+// generadores de datos: cada elemento se obtiene de su propio contador, así
+// que su valor depende solo de la semilla y de su posición
+CLONES_SIMD
+inline void palabrasPhilox(uint64_t* primera, uint64_t* segunda, size_t n, uint64_t base,
+                           uint32_t k0, uint32_t k1, uint32_t f0, uint32_t f1) {
+    #pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t ctr = base + i;
+        uint32_t c0 = static_cast<uint32_t>(ctr), c1 = static_cast<uint32_t>(ctr >> 32), c2 = f0, c3 = f1;
+        FlujoPhilox::philox(c0, c1, c2, c3, k0, k1);
+        primera[i] = (uint64_t(c0) << 32) | c1;
+        segunda[i] = (uint64_t(c2) << 32) | c3;
+    }
+}
+
+inline void FlujoPhilox::uniformes(double* destino, size_t n) {
+    const uint32_t k0 = clave[0], k1 = clave[1];
+    const uint32_t f0 = static_cast<uint32_t>(flujo), f1 = static_cast<uint32_t>(flujo >> 32);
+    const size_t pares = n / 2;
+    uniformesPhilox(destino, pares, contador, k0, k1, f0, f1);
+    contador += pares;
+    if (n % 2 != 0) {
+        uint32_t c0 = static_cast<uint32_t>(contador), c1 = static_cast<uint32_t>(contador >> 32), c2 = f0, c3 = f1;
+        philox(c0, c1, c2, c3, k0, k1);
+        destino[n - 1] = aDouble((uint64_t(c0) << 32) | c1);
+        ++contador;
+    }
+}
+
+#endif
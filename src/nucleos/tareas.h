@@ -0,0 +1,413 @@
+#ifndef NUCLEOS_TAREAS_H
+#define NUCLEOS_TAREAS_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Tareas fork/join para los núcleos recursivos, con dos backends
+// intercambiables: las tareas de OpenMP (TareasOpenMP) y un planificador
+// propio de robo de trabajo (TareasRobo). Con libgomp todas las tareas de un
+// equipo pasan por una cola central protegida por un cerrojo; el planificador
+// de robo da a cada trabajador su propia deque de Chase-Lev: el dueño apila y
+// desapila por abajo sin operaciones atómicas de lectura-modificación-escritura
+// y solo los ladrones compiten por arriba
+
+// Marcos pendientes por trabajador. La recursión fork/join apila un marco por
+// nivel, así que basta con holgura; si la deque se llena la tarea se ejecuta
+// en el sitio
+const size_t CAPACIDAD_DEQUE_ROBO = 1 << 13;
+
+// Intentos de robo fallidos antes de ceder el procesador al sistema operativo
+const int INTENTOS_ROBO_ANTES_DE_CEDER = 64;
+
+// Marco de tarea: la función que la ejecuta y su marca de terminada. Los
+// marcos viven en la pila de quien hace la bifurcación, que no sale de ella
+// hasta que la tarea ha terminado: crear una tarea no reserva memoria
+struct MarcoTarea {
+    void (*ejecutar)(MarcoTarea*) = nullptr;
+    std::atomic<bool> terminada{false};
+};
+
+template <typename F>
+struct MarcoFuncion : MarcoTarea {
+    F& funcion;
+
+    explicit MarcoFuncion(F& f) : funcion(f) {
+        ejecutar = [](MarcoTarea* marco) { static_cast<MarcoFuncion*>(marco)->funcion(); };
+    }
+};
+
+// Deque de Chase-Lev de capacidad fija (Lê et al., 2013, para modelos de
+// memoria débiles). El dueño empuja y saca por abajo; los ladrones roban por
+// arriba y solo la última tarea se disputa con un compare_exchange
+class DequeRobo {
+public:
+    DequeRobo() : marcos(new std::atomic<MarcoTarea*>[CAPACIDAD_DEQUE_ROBO]) {}
+
+    // Solo el dueño. Devuelve false si la deque está llena
+    bool empujar(MarcoTarea* marco) {
+        const int64_t b = abajo.load(std::memory_order_relaxed);
+        const int64_t t = arriba.load(std::memory_order_acquire);
+        if (b - t >= int64_t(CAPACIDAD_DEQUE_ROBO)) return false;
+        marcos[b & (CAPACIDAD_DEQUE_ROBO - 1)].store(marco, std::memory_order_relaxed);
+        // Publica el marco y su contenido para el ladrón que lea abajo
+        abajo.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Solo el dueño: el marco más reciente, o nullptr si se lo han robado
+    MarcoTarea* sacar() {
+        const int64_t b = abajo.load(std::memory_order_relaxed) - 1;
+        abajo.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = arriba.load(std::memory_order_relaxed);
+        MarcoTarea* marco = nullptr;
+        if (t <= b) {
+            marco = marcos[b & (CAPACIDAD_DEQUE_ROBO - 1)].load(std::memory_order_relaxed);
+            if (t == b) {
+                // Última tarea: se disputa con los ladrones
+                if (!arriba.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+                    marco = nullptr;
+                }
+                abajo.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            abajo.store(b + 1, std::memory_order_relaxed);
+        }
+        return marco;
+    }
+
+    // Cualquier hilo: el marco más antiguo, o nullptr si no hay o se perdió la carrera
+    MarcoTarea* robar() {
+        int64_t t = arriba.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = abajo.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        MarcoTarea* marco = marcos[t & (CAPACIDAD_DEQUE_ROBO - 1)].load(std::memory_order_relaxed);
+        if (!arriba.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return marco;
+    }
+
+private:
+    // arriba y abajo en líneas distintas: los ladrones escriben una y el dueño la otra
+    alignas(64) std::atomic<int64_t> arriba{0};
+    alignas(64) std::atomic<int64_t> abajo{0};
+    std::unique_ptr<std::atomic<MarcoTarea*>[]> marcos;
+};
+
+class PlanificadorRobo;
+
+// Estado de un trabajador. Los contadores solo los escribe su hilo y se leen
+// entre ejecuciones
+struct alignas(64) TrabajadorRobo {
+    DequeRobo deque;
+    PlanificadorRobo* planificador = nullptr;
+    int id = 0;
+    uint64_t aleatorio = 0;   // Estado xorshift para elegir víctima
+    uint64_t tareas = 0;      // Tareas creadas
+    uint64_t robos = 0;       // Tareas robadas y ejecutadas
+};
+
+// Trabajador del hilo actual (nullptr fuera de PlanificadorRobo::ejecutar)
+inline thread_local TrabajadorRobo* trabajadorRoboActual = nullptr;
+
+struct EstadisticasRobo {
+    uint64_t tareas;
+    uint64_t robos;
+};
+
+// Pausa breve mientras se espera a otro hilo; tras varios intentos fallidos
+// cede el procesador, para no quitárselo al hilo que tiene la tarea cuando hay
+// más trabajadores que núcleos
+inline void esperarRobo(int& fallos) {
+    if (++fallos < INTENTOS_ROBO_ANTES_DE_CEDER) {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+// Equipo de trabajadores con robo de trabajo. El hilo que llama a ejecutar()
+// actúa como trabajador 0 y los demás son hilos propios del planificador, que
+// duermen en una variable de condición entre ejecuciones. En cada ejecución
+// participan min(omp_get_max_threads(), capacidad) trabajadores, así que los
+// barridos de hilos del arnés también controlan este backend
+class PlanificadorRobo {
+public:
+    explicit PlanificadorRobo(int numTrabajadores) {
+        numTrabajadores = std::max(numTrabajadores, 1);
+        for (int i = 0; i < numTrabajadores; ++i) {
+            trabajadores.emplace_back(new TrabajadorRobo());
+            trabajadores[i]->planificador = this;
+            trabajadores[i]->id = i;
+            trabajadores[i]->aleatorio = 0x9E3779B97F4A7C15ull * (i + 1);
+        }
+        for (int i = 1; i < numTrabajadores; ++i) {
+            hilos.emplace_back([this, i] { bucleTrabajador(*trabajadores[i]); });
+        }
+    }
+
+    ~PlanificadorRobo() {
+        {
+            std::lock_guard<std::mutex> cerrojo(mutex);
+            terminar = true;
+        }
+        despertar.notify_all();
+        for (std::thread& hilo : hilos) hilo.join();
+    }
+
+    PlanificadorRobo(const PlanificadorRobo&) = delete;
+    PlanificadorRobo& operator=(const PlanificadorRobo&) = delete;
+
+    // Planificador compartido, con tantos trabajadores como procesadores o
+    // hilos de OpenMP haya al crearlo
+    static PlanificadorRobo& global() {
+        static PlanificadorRobo planificador(std::max(omp_get_max_threads(), omp_get_num_procs()));
+        return planificador;
+    }
+
+    int capacidad() const { return static_cast<int>(trabajadores.size()); }
+
+    // Ejecuta f() con el equipo y vuelve cuando f y todas sus tareas han
+    // terminado. Dentro de un trabajador de este planificador llama a f() sin más
+    template <typename F>
+    void ejecutar(F&& f) {
+        if (trabajadorRoboActual && trabajadorRoboActual->planificador == this) {
+            f();
+            return;
+        }
+        std::lock_guard<std::mutex> turno(entrada);
+        TrabajadorRobo* anterior = trabajadorRoboActual;
+        trabajadorRoboActual = trabajadores[0].get();
+        const int numActivos = std::min(std::max(omp_get_max_threads(), 1), capacidad());
+        {
+            std::lock_guard<std::mutex> cerrojo(mutex);
+            activos.store(numActivos, std::memory_order_relaxed);
+            ++ronda;
+            enCurso.store(true, std::memory_order_release);
+        }
+        if (numActivos > 1) despertar.notify_all();
+
+        f();
+
+        // Ningún trabajador sigue robando cuando se vuelve al llamador
+        {
+            std::unique_lock<std::mutex> cerrojo(mutex);
+            enCurso.store(false, std::memory_order_release);
+            libres.wait(cerrojo, [this] { return ocupados == 0; });
+        }
+        trabajadorRoboActual = anterior;
+    }
+
+    // Suma de los contadores de todos los trabajadores (entre ejecuciones)
+    EstadisticasRobo estadisticas() const {
+        EstadisticasRobo total{0, 0};
+        for (const auto& t : trabajadores) {
+            total.tareas += t->tareas;
+            total.robos += t->robos;
+        }
+        return total;
+    }
+
+    void reiniciarEstadisticas() {
+        for (auto& t : trabajadores) t->tareas = t->robos = 0;
+    }
+
+    // Roba una tarea de una víctima al azar entre los activos y la ejecuta.
+    // Devuelve false si no encontró ninguna
+    bool robarYEjecutar(TrabajadorRobo& yo) {
+        const int n = activos.load(std::memory_order_relaxed);
+        if (n <= 1) return false;
+        for (int intento = 0; intento < n; ++intento) {
+            yo.aleatorio ^= yo.aleatorio << 13;
+            yo.aleatorio ^= yo.aleatorio >> 7;
+            yo.aleatorio ^= yo.aleatorio << 17;
+            int victima = static_cast<int>(yo.aleatorio % uint64_t(n - 1));
+            if (victima >= yo.id) ++victima;
+            if (MarcoTarea* marco = trabajadores[victima]->deque.robar()) {
+                ++yo.robos;
+                marco->ejecutar(marco);
+                marco->terminada.store(true, std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Espera a que termine un marco robado ejecutando mientras tanto tareas de otros
+    void esperarMarco(TrabajadorRobo& yo, const MarcoTarea& marco) {
+        int fallos = 0;
+        while (!marco.terminada.load(std::memory_order_acquire)) {
+            if (robarYEjecutar(yo)) {
+                fallos = 0;
+            } else {
+                esperarRobo(fallos);
+            }
+        }
+    }
+
+private:
+    void bucleTrabajador(TrabajadorRobo& yo) {
+        trabajadorRoboActual = &yo;
+        uint64_t rondaVista = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> cerrojo(mutex);
+                despertar.wait(cerrojo, [&] {
+                    return terminar || (ronda != rondaVista && yo.id < activos.load(std::memory_order_relaxed));
+                });
+                if (terminar) return;
+                rondaVista = ronda;
+                ++ocupados;
+            }
+            // Un trabajador que despierta tarde puede encontrar ya la ronda
+            // siguiente; solo participa si también está activo en ella
+            int fallos = 0;
+            while (enCurso.load(std::memory_order_acquire) && yo.id < activos.load(std::memory_order_relaxed)) {
+                if (robarYEjecutar(yo)) {
+                    fallos = 0;
+                } else {
+                    esperarRobo(fallos);
+                }
+            }
+            {
+                std::lock_guard<std::mutex> cerrojo(mutex);
+                if (--ocupados == 0) libres.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<TrabajadorRobo>> trabajadores;
+    std::vector<std::thread> hilos;
+    std::mutex entrada;                     // Una ejecución a la vez
+    std::mutex mutex;                       // Protege ronda, ocupados y terminar
+    std::condition_variable despertar;
+    std::condition_variable libres;
+    std::atomic<bool> enCurso{false};
+    std::atomic<int> activos{1};            // Trabajadores de la ejecución en curso
+    uint64_t ronda = 0;
+    int ocupados = 0;
+    bool terminar = false;
+};
+
+// Ejecuta f() y g() en paralelo y vuelve cuando ambas han terminado. g queda
+// en la deque del trabajador mientras este ejecuta f; si nadie la ha robado se
+// ejecuta a continuación en el mismo hilo, y si no, el trabajador roba otras
+// tareas hasta que el ladrón la termina. Fuera de un planificador es secuencial
+template <typename F, typename G>
+void unirRobo(F&& f, G&& g) {
+    TrabajadorRobo* yo = trabajadorRoboActual;
+    if (!yo) {
+        f();
+        g();
+        return;
+    }
+    MarcoFuncion<typename std::remove_reference<G>::type> marco(g);
+    if (!yo->deque.empujar(&marco)) {
+        f();
+        g();
+        return;
+    }
+    ++yo->tareas;
+    f();
+    if (yo->deque.sacar() == &marco) {
+        g();
+        return;
+    }
+    yo->planificador->esperarMarco(*yo, marco);
+}
+
+// f(i) para i en [inicio, fin) por bisección con unirRobo
+template <typename F>
+void repartirRangoRobo(size_t inicio, size_t fin, F& f) {
+    if (fin - inicio == 1) {
+        f(inicio);
+        return;
+    }
+    const size_t medio = inicio + (fin - inicio) / 2;
+    unirRobo([&] { repartirRangoRobo(inicio, medio, f); }, [&] { repartirRangoRobo(medio, fin, f); });
+}
+
+// f(i) para i en [0, n) como tareas independientes; vuelve cuando terminan todas
+template <typename F>
+void repartirRobo(size_t n, F&& f) {
+    if (n > 0) repartirRangoRobo(0, n, f);
+}
+
+// Backends para los núcleos recursivos, que reciben uno como parámetro de
+// plantilla:
+//  - ejecutar(f): punto de entrada desde código secuencial; f puede crear tareas
+//  - unir(f, g): f y g en paralelo, vuelve cuando terminan las dos
+//  - repartir(n, f): f(i) para i en [0, n) en paralelo
+struct TareasOpenMP {
+    static constexpr const char* nombre = "openmp";
+
+    template <typename F>
+    static void ejecutar(F&& f) {
+        // Justificación: Un equipo de hilos y un único punto de entrada a la recursión
+        #pragma omp parallel
+        {
+            #pragma omp single
+            f();
+        }
+    }
+
+    template <typename F, typename G>
+    static void unir(F&& f, G&& g) {
+        auto* primera = &f;
+        // Justificación: Una sola tarea por bifurcación; la segunda mitad la
+        // ejecuta el propio hilo mientras otro puede tomar la primera
+        #pragma omp task firstprivate(primera)
+        (*primera)();
+        g();
+        #pragma omp taskwait
+    }
+
+    template <typename F>
+    static void repartir(size_t n, F&& f) {
+        auto* funcion = &f;
+        for (size_t i = 0; i < n; ++i) {
+            #pragma omp task firstprivate(funcion, i)
+            (*funcion)(i);
+        }
+        #pragma omp taskwait
+    }
+};
+
+struct TareasRobo {
+    static constexpr const char* nombre = "robo";
+
+    template <typename F>
+    static void ejecutar(F&& f) {
+        PlanificadorRobo::global().ejecutar(f);
+    }
+
+    template <typename F, typename G>
+    static void unir(F&& f, G&& g) {
+        unirRobo(f, g);
+    }
+
+    template <typename F>
+    static void repartir(size_t n, F&& f) {
+        repartirRobo(n, f);
+    }
+};
+
+#endif // NUCLEOS_TAREAS_H
@@ -0,0 +1,318 @@
+#ifndef NUCLEOS_VECTORES_H
+#define NUCLEOS_VECTORES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <omp.h>
+#include "vista.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VECTORES_X86 1
+#endif
+
+// Bytes por línea de caché
+const size_t BYTES_POR_LINEA = 64;
+
+// A partir de este número de bytes de salida (8 MB) el resultado no cabe en la
+// caché y se escribe con stores no temporales: no se lee la línea antes de
+// escribirla (read-for-ownership) ni desplaza datos útiles de la caché
+const size_t UMBRAL_STREAMING_BYTES = size_t(8) << 20;
+
+// Tipo en el que se acumulan las reducciones: los enteros estrechos se
+// desbordarían, así que se suman en 64 bits; los reales más estrechos que
+// double (float) se suman en double, que cuesta lo mismo por elemento en un
+// bucle limitado por memoria y evita perder los sumandos pequeños cuando la
+// suma parcial crece; double y long double, en su propio tipo
+template <typename T>
+using AcumuladorDe = typename std::conditional<
+    std::is_integral<T>::value,
+    typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type,
+    typename std::conditional<(sizeof(T) < sizeof(double)), double, T>::type>::type;
+
+// Plantillas de expresión: a * x + b * y + c construye un árbol de nodos ligeros
+// que no calcula nada hasta asignarse, y la asignación lo evalúa elemento a
+// elemento en una sola pasada, sin vectores temporales intermedios.
+// La clase base solo sirve para restringir los operadores a nodos de expresión
+template <typename E>
+struct Expresion {
+    const E& derivada() const { return static_cast<const E&>(*this); }
+};
+
+// Hoja: vector de entrada (no propietario)
+template <typename T>
+struct OperandoVector : Expresion<OperandoVector<T>> {
+    using Valor = T;
+    const T* datos;
+
+    explicit OperandoVector(const T* d) : datos(d) {}
+    T operator[](size_t i) const { return datos[i]; }
+    bool lee(const void* p) const { return datos == p; }
+};
+
+// Hoja: escalar que se repite en todos los elementos
+template <typename T>
+struct Escalar : Expresion<Escalar<T>> {
+    using Valor = T;
+    T valor;
+
+    explicit Escalar(T v) : valor(v) {}
+    T operator[](size_t) const { return valor; }
+    bool lee(const void*) const { return false; }
+};
+
+// Las operaciones devuelven el tipo del elemento: con enteros estrechos el
+// resultado se trunca igual que en una asignación escalar
+struct OperacionSuma {
+    template <typename T>
+    static T aplicar(T a, T b) { return static_cast<T>(a + b); }
+};
+struct OperacionResta {
+    template <typename T>
+    static T aplicar(T a, T b) { return static_cast<T>(a - b); }
+};
+struct OperacionProducto {
+    template <typename T>
+    static T aplicar(T a, T b) { return static_cast<T>(a * b); }
+};
+
+// Nodo interno: los hijos se guardan por valor (son unos pocos punteros y escalares)
+template <typename Operacion, typename Izquierda, typename Derecha>
+struct Binaria : Expresion<Binaria<Operacion, Izquierda, Derecha>> {
+    static_assert(std::is_same<typename Izquierda::Valor, typename Derecha::Valor>::value,
+                  "Los operandos de una expresión deben tener el mismo tipo de elemento");
+    using Valor = typename Izquierda::Valor;
+    Izquierda izquierda;
+    Derecha derecha;
+
+    Binaria(const Izquierda& i, const Derecha& d) : izquierda(i), derecha(d) {}
+    Valor operator[](size_t i) const { return Operacion::aplicar(izquierda[i], derecha[i]); }
+    bool lee(const void* p) const { return izquierda.lee(p) || derecha.lee(p); }
+};
+
+// Operando de una expresión a partir de una vista (sin copiar los datos)
+template <typename T>
+OperandoVector<SinConst<T>> operando(Vista<T> v) {
+    return OperandoVector<SinConst<T>>(v.data());
+}
+template <typename T, typename A>
+OperandoVector<T> operando(const std::vector<T, A>& v) { return OperandoVector<T>(v.data()); }
+
+template <typename I, typename D>
+Binaria<OperacionSuma, I, D> operator+(const Expresion<I>& i, const Expresion<D>& d) {
+    return {i.derivada(), d.derivada()};
+}
+template <typename I, typename D>
+Binaria<OperacionResta, I, D> operator-(const Expresion<I>& i, const Expresion<D>& d) {
+    return {i.derivada(), d.derivada()};
+}
+template <typename I, typename D>
+Binaria<OperacionProducto, I, D> operator*(const Expresion<I>& i, const Expresion<D>& d) {
+    return {i.derivada(), d.derivada()};
+}
+template <typename D>
+Binaria<OperacionProducto, Escalar<typename D::Valor>, D> operator*(typename D::Valor a, const Expresion<D>& d) {
+    return {Escalar<typename D::Valor>(a), d.derivada()};
+}
+template <typename I>
+Binaria<OperacionSuma, I, Escalar<typename I::Valor>> operator+(const Expresion<I>& i, typename I::Valor c) {
+    return {i.derivada(), Escalar<typename I::Valor>(c)};
+}
+template <typename I>
+Binaria<OperacionResta, I, Escalar<typename I::Valor>> operator-(const Expresion<I>& i, typename I::Valor c) {
+    return {i.derivada(), Escalar<typename I::Valor>(c)};
+}
+
+// Evalúa los elementos [inicio, fin) de la expresión en destino con stores normales
+template <typename T, typename E>
+void evaluarRango(T* destino, const E& expresion, size_t inicio, size_t fin) {
+    #pragma omp simd
+    for (size_t i = inicio; i < fin; ++i) {
+        destino[i] = expresion[i];
+    }
+}
+
+// Evalúa las líneas completas [inicio, fin) (destino + inicio alineado a 64
+// bytes) con stores no temporales. Cada línea se calcula en registros y se
+// escribe entera, de modo que el buffer de combinación de escritura la envía a
+// memoria sin leerla antes. Los stores de 128 bits sirven para cualquier tipo
+template <typename T, typename E>
+void evaluarRangoStreaming(T* destino, const E& expresion, size_t inicio, size_t fin) {
+#ifdef VECTORES_X86
+    const size_t porLinea = BYTES_POR_LINEA / sizeof(T);
+    for (size_t i = inicio; i < fin; i += porLinea) {
+        alignas(64) T linea[BYTES_POR_LINEA / sizeof(T)];
+        #pragma omp simd
+        for (size_t k = 0; k < porLinea; ++k) {
+            linea[k] = expresion[i + k];
+        }
+        __m128i* salida = reinterpret_cast<__m128i*>(destino + i);
+        const __m128i* origen = reinterpret_cast<const __m128i*>(linea);
+        for (size_t k = 0; k < BYTES_POR_LINEA / sizeof(__m128i); ++k) {
+            _mm_stream_si128(salida + k, _mm_load_si128(origen + k));
+        }
+    }
+    // Los stores no temporales no siguen el orden normal de la memoria: la
+    // barrera los hace visibles antes de que el hilo termine su parte
+    _mm_sfence();
+#else
+    evaluarRango(destino, expresion, inicio, fin);
+#endif
+}
+
+// destino = expresion, en una sola pasada paralela. Se usan stores no
+// temporales si la salida es grande y la expresión no lee el propio destino
+// (en y = a * x + y la línea ya está en caché por la lectura y no hay
+// read-for-ownership que ahorrar)
+template <typename T, typename E>
+void asignar(Vista<T> destino, const Expresion<E>& expresion) {
+    static_assert(std::is_same<T, typename E::Valor>::value,
+                  "El destino y la expresión deben tener el mismo tipo de elemento");
+    const E& e = expresion.derivada();
+    T* d = destino.data();
+    const size_t n = destino.size();
+
+    bool streaming = false;
+#ifdef VECTORES_X86
+    streaming = n * sizeof(T) >= UMBRAL_STREAMING_BYTES && !e.lee(d) &&
+                reinterpret_cast<uintptr_t>(d) % sizeof(T) == 0;
+#endif
+    if (!streaming) {
+        // Justificación: Elementos independientes; reparto estático en bloques
+        // contiguos para que cada hilo recorra memoria secuencial
+        #pragma omp parallel for simd schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            d[i] = e[i];
+        }
+        return;
+    }
+
+    // Los elementos hasta la primera línea alineada y los que no completan la
+    // última línea se escriben con stores normales
+    const size_t porLinea = BYTES_POR_LINEA / sizeof(T);
+    const size_t desalineados = (reinterpret_cast<uintptr_t>(d) % BYTES_POR_LINEA) / sizeof(T);
+    const size_t cabeza = std::min(n, desalineados == 0 ? 0 : porLinea - desalineados);
+    const size_t numLineas = (n - cabeza) / porLinea;
+    const size_t cola = cabeza + numLineas * porLinea;
+    evaluarRango(d, e, 0, cabeza);
+    evaluarRango(d, e, cola, n);
+
+    // Justificación: Cada hilo recibe un tramo contiguo de líneas completas, así
+    // que ninguna línea se comparte entre hilos ni se escribe a medias
+    #pragma omp parallel
+    {
+        int numHilos = omp_get_num_threads();
+        int id = omp_get_thread_num();
+        size_t primera = numLineas * id / numHilos;
+        size_t ultima = numLineas * (id + 1) / numHilos;
+        evaluarRangoStreaming(d, e, cabeza + primera * porLinea, cabeza + ultima * porLinea);
+    }
+}
+
+template <typename T, typename A, typename E>
+void asignar(std::vector<T, A>& destino, const Expresion<E>& expresion) {
+    asignar(vista(destino), expresion);
+}
+
+// destino = origen convertido elemento a elemento (por ejemplo, double a float
+// para pasar una entrada a precisión reducida). Devuelve false si los tamaños
+// no coinciden
+template <typename T, typename U>
+bool convertir(Vista<T> destino, Vista<U> origen) {
+    if (origen.size() != destino.size()) return false;
+    T* d = destino.data();
+    const SinConst<U>* o = origen.data();
+    const size_t n = destino.size();
+    // Justificación: Elementos independientes; mismo reparto estático que asignar
+    #pragma omp parallel for simd schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        d[i] = static_cast<T>(o[i]);
+    }
+    return true;
+}
+
+// Suma de los n primeros elementos de la expresión en una pasada paralela
+template <typename E>
+AcumuladorDe<typename E::Valor> sumar(const Expresion<E>& expresion, size_t n) {
+    const E& e = expresion.derivada();
+    AcumuladorDe<typename E::Valor> suma = 0;
+    // Justificación: Reducción clásica; cada hilo acumula sus elementos en
+    // registros vectoriales y OpenMP combina los parciales al final
+    #pragma omp parallel for simd reduction(+:suma) schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        suma += e[i];
+    }
+    return suma;
+}
+
+// Kernels BLAS-1 sobre la asignación fusionada. El tipo de elemento se deduce de
+// la salida o del escalar; las entradas aceptan vistas constantes o no. Los que
+// reciben varias vistas devuelven false si sus tamaños no coinciden
+
+// y = alfa * x + y
+template <typename T>
+bool axpy(T alfa, Vista<const SinDeducir<T>> x, Vista<T> y) {
+    if (x.size() != y.size()) return false;
+    asignar(y, alfa * operando(x) + operando(y));
+    return true;
+}
+
+// x = alfa * x
+template <typename T>
+void escalar(T alfa, Vista<T> x) {
+    asignar(x, alfa * operando(x));
+}
+
+// Tríada de STREAM: a = b + s * c
+template <typename T>
+bool triada(Vista<T> a, Vista<const SinDeducir<T>> b, SinDeducir<T> s, Vista<const SinDeducir<T>> c) {
+    if (b.size() != a.size() || c.size() != a.size()) return false;
+    asignar(a, operando(b) + s * operando(c));
+    return true;
+}
+
+// Producto escalar de los min(x.size(), y.size()) primeros elementos; los
+// enteros se acumulan en 64 bits y float en double
+template <typename U>
+AcumuladorDe<SinConst<U>> productoPunto(Vista<U> x, Vista<U> y) {
+    using T = SinConst<U>;
+    const T* a = x.data();
+    const T* b = y.data();
+    const size_t n = std::min(x.size(), y.size());
+    AcumuladorDe<T> suma = 0;
+    // Justificación: Reducción paralela y vectorial; los productos se amplían al
+    // acumulador antes de multiplicar para que los enteros estrechos no desborden
+    #pragma omp parallel for simd reduction(+:suma) schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        suma += static_cast<AcumuladorDe<T>>(a[i]) * b[i];
+    }
+    return suma;
+}
+
+// Norma euclídea en una pasada. Solo si la suma de cuadrados desborda o pierde
+// precisión por debajo del rango normal se repite escalando por el máximo
+template <typename U>
+SinConst<U> norma(Vista<U> x) {
+    using T = SinConst<U>;
+    static_assert(std::is_floating_point<T>::value, "La norma solo está definida para reales");
+    const size_t n = x.size();
+    const T* d = x.data();
+    const AcumuladorDe<T> cuadrados = productoPunto(Vista<const T>(d, n), Vista<const T>(d, n));
+    const T minimo = std::numeric_limits<T>::min() / std::numeric_limits<T>::epsilon();
+    if (std::isfinite(cuadrados) && cuadrados >= minimo) return static_cast<T>(std::sqrt(cuadrados));
+
+    T maximo = 0;
+    #pragma omp parallel for simd reduction(max:maximo) schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        maximo = std::max(maximo, std::abs(d[i]));
+    }
+    if (maximo == 0 || !std::isfinite(maximo)) return maximo;
+    const T inverso = 1 / maximo;
+    const OperandoVector<T> v(d);
+    return static_cast<T>(maximo * std::sqrt(sumar((inverso * v) * (inverso * v), n)));
+}
+
+#endif // NUCLEOS_VECTORES_H
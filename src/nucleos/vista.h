@@ -0,0 +1,86 @@
+#ifndef NUCLEOS_VISTA_H
+#define NUCLEOS_VISTA_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Vistas no propietarias sobre memoria del llamador. Los núcleos de la
+// biblioteca solo reciben vistas: no reservan ni copian las entradas, así que
+// pueden operar directamente sobre los buffers de la aplicación que los enlaza
+
+// Vista contigua 1-D (equivalente a std::span de C++20)
+template <typename T>
+struct Vista {
+    T* datos;
+    size_t tamano;
+
+    Vista() : datos(nullptr), tamano(0) {}
+    Vista(T* d, size_t n) : datos(d), tamano(n) {}
+
+    // Desde un std::vector con cualquier asignador (Vista<const T> también
+    // acepta vectores constantes)
+    template <typename U, typename A, typename = typename std::enable_if<
+                                          std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    Vista(std::vector<U, A>& v) : datos(v.data()), tamano(v.size()) {}
+    template <typename U, typename A, typename = typename std::enable_if<
+                                          std::is_convertible<const U (*)[], T (*)[]>::value>::type>
+    Vista(const std::vector<U, A>& v) : datos(v.data()), tamano(v.size()) {}
+
+    // Vista<T> -> Vista<const T>
+    template <typename U, typename = typename std::enable_if<
+                              std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    Vista(const Vista<U>& otra) : datos(otra.datos), tamano(otra.tamano) {}
+
+    size_t size() const { return tamano; }
+    bool empty() const { return tamano == 0; }
+    T* data() const { return datos; }
+    T* begin() const { return datos; }
+    T* end() const { return datos + tamano; }
+    T& operator[](size_t i) const { return datos[i]; }
+
+    // Sub-vista [inicio, inicio + n)
+    Vista<T> subvista(size_t inicio, size_t n) const { return Vista<T>(datos + inicio, n); }
+};
+
+// Crea la vista de un std::vector (constante si el vector lo es)
+template <typename T, typename A>
+Vista<T> vista(std::vector<T, A>& v) { return Vista<T>(v.data(), v.size()); }
+template <typename T, typename A>
+Vista<const T> vista(const std::vector<T, A>& v) { return Vista<const T>(v.data(), v.size()); }
+
+// Parámetro que no participa en la deducción de plantillas: los núcleos deducen
+// el tipo de elemento de la salida (o de un escalar) y las entradas Vista<const T>
+// aceptan entonces también una Vista<T> por conversión implícita
+template <typename T>
+struct Identidad {
+    using tipo = T;
+};
+template <typename T>
+using SinDeducir = typename Identidad<T>::tipo;
+
+// Tipo de elemento de una vista de entrada, constante o no
+template <typename U>
+using SinConst = typename std::remove_const<U>::type;
+
+// Vista rectangular no propietaria (una fila, un tile o una matriz completa)
+// en orden por filas con stride; no copia ni libera memoria
+template <typename T>
+struct VistaTile {
+    T* datos;
+    size_t filas;
+    size_t columnas;
+    size_t stride;
+
+    T* operator[](size_t i) const { return datos + i * stride; }
+    T& operator()(size_t i, size_t j) const { return datos[i * stride + j]; }
+
+    // Sub-vista relativa a esta vista
+    VistaTile<T> tile(size_t fila, size_t columna, size_t numFilas, size_t numColumnas) const {
+        return VistaTile<T>{datos + fila * stride + columna, numFilas, numColumnas, stride};
+    }
+
+    operator VistaTile<const T>() const { return VistaTile<const T>{datos, filas, columnas, stride}; }
+};
+
+#endif // NUCLEOS_VISTA_H
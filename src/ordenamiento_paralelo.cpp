@@ -1,24 +1,45 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
-#include <random>
 #include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <cstdint>
+#include <numeric>
+#include <future>
+#include <limits>
+#include <memory>
+#include <functional>
 #include <omp.h>
+#include "medicion.h"
+#include "nucleos/generacion.h"
+#include "nucleos/ordenamiento.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ORDENAMIENTO_POSIX 1
+#endif
 
 class OrdenadorParalelo {
 private:
-    std::vector<int> array;
+    VectorNuma<int> array;             // Sin inicializar: la primera escritura es la del generador
     size_t tamano;
+    size_t corteHoja;                  // Subarreglos menores se ordenan sin crear tareas
+    Distribucion distribucion;         // Distribución de las claves de entrada
+    std::vector<int> bufferAuxiliar;   // Buffer ping-pong reutilizado en todo el ordenamiento
 
-    // Inicializa el array con valores aleatorios
-    void inicializarArray() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(1, 1000000000);
-
-        for (auto& elemento : array) {
-            elemento = dis(gen);
-        }
+    // Genera el array en paralelo con la distribución elegida sobre [1, 1e9];
+    // la normal se centra en el rango con desviación de un sexto de su amplitud
+    void inicializarArray(uint64_t semilla) {
+        ParametrosDistribucion parametros;
+        parametros.minimo = 1;
+        parametros.maximo = 1000000000;
+        parametros.media = (parametros.minimo + parametros.maximo) / 2;
+        parametros.desviacion = (parametros.maximo - parametros.minimo) / 6;
+        generar(vista(array), distribucion, parametros, semilla);
     }
 
     // Función auxiliar para mezclar dos subarrays ordenados
@@ -75,8 +96,20 @@ private:
         }
     }
 
+    // El mismo merge sort, también con dos tareas por nivel hasta los
+    // elementos sueltos, sobre el planificador de robo de trabajo: cada tarea
+    // es un marco en la pila y la deque propia del hilo, sin cola compartida
+    void mergeSortParaleloRobo(std::vector<int>& arr, size_t inicio, size_t fin) {
+        if (inicio < fin) {
+            size_t medio = inicio + (fin - inicio) / 2;
+            unirRobo([&] { mergeSortParaleloRobo(arr, inicio, medio); },
+                     [&] { mergeSortParaleloRobo(arr, medio + 1, fin); });
+            merge(arr, inicio, medio, fin);
+        }
+    }
+
     // Imprime los primeros y últimos 10 elementos de un array
-    void imprimirElementos(const std::vector<int>& arr, const std::string& mensaje) {
+    void imprimirElementos(Vista<const int> arr, const std::string& mensaje) {
         std::cout << mensaje << std::endl;
         std::cout << "Primeros 10 elementos: ";
         for (size_t i = 0; i < 10 && i < arr.size(); ++i) {
@@ -92,21 +125,22 @@ private:
     }
 
 public:
-    // Constructor: inicializa el array con un tamaño dado
-    OrdenadorParalelo(size_t t) : tamano(t), array(t) {
-        inicializarArray();
+    // Constructor: genera el array de un tamaño dado a partir de la semilla
+    OrdenadorParalelo(size_t t, size_t corte, Distribucion d, uint64_t semilla)
+        : array(t), tamano(t), corteHoja(std::max<size_t>(corte, 1)), distribucion(d) {
+        inicializarArray(semilla);
     }
 
-    // Método para ordenar el array de forma secuencial
-    void ordenarSecuencial() {
-        std::vector<int> arrCopia = array;
+    // Método para ordenar el array de forma secuencial; devuelve una copia ordenada
+    std::vector<int> ordenarSecuencial() {
+        std::vector<int> arrCopia(array.begin(), array.end());
         mergeSortSecuencial(arrCopia, 0, tamano - 1);
-        imprimirElementos(arrCopia, "Resultado secuencial:");
+        return arrCopia;
     }
 
-    // Método para ordenar el array de forma paralela
-    void ordenarParalelo() {
-        std::vector<int> arrCopia = array;
+    // Método para ordenar el array de forma paralela; devuelve una copia ordenada
+    std::vector<int> ordenarParalelo() {
+        std::vector<int> arrCopia(array.begin(), array.end());
         // Crea un equipo de hilos y permite que un solo hilo inicie la tarea raíz
         // Justificación: Inicia la recursión paralela desde un único punto de entrada
         #pragma omp parallel
@@ -114,15 +148,65 @@ public:
             #pragma omp single
             mergeSortParalelo(arrCopia, 0, tamano - 1);
         }
-        imprimirElementos(arrCopia, "Resultado paralelo:");
+        return arrCopia;
+    }
+
+    // Merge sort con una tarea por elemento sobre el planificador de robo de trabajo
+    std::vector<int> ordenarParaleloRobo() {
+        std::vector<int> arrCopia(array.begin(), array.end());
+        PlanificadorRobo::global().ejecutar([&] { mergeSortParaleloRobo(arrCopia, 0, tamano - 1); });
+        return arrCopia;
+    }
+
+    // Ordena en paralelo con un único buffer auxiliar reutilizado, hojas secuenciales
+    // por debajo de corteHoja y mezclas grandes repartidas entre los hilos, con
+    // las tareas de OpenMP o con el planificador de robo de trabajo
+    template <typename Tareas = TareasOpenMP>
+    std::vector<int> ordenarParaleloBuffer() {
+        std::vector<int> arrCopia(array.begin(), array.end());
+        bufferAuxiliar.resize(tamano);
+        ordenarMezcla<Tareas>(vista(arrCopia), vista(bufferAuxiliar), corteHoja);
+        return arrCopia;
+    }
+
+    // Ordena con radix sort LSD paralelo (sin comparaciones)
+    std::vector<int> ordenarRadix() {
+        std::vector<int> arrCopia(array.begin(), array.end());
+        std::vector<int> auxiliar(tamano);
+        ::ordenarRadix(vista(arrCopia), vista(auxiliar));
+        return arrCopia;
+    }
+
+    // Ordena pares clave/índice: devuelve la permutación estable p tal que
+    // array[p[0]] <= array[p[1]] <= ..., para reordenar registros por su clave
+    std::vector<uint32_t> ordenarRadixIndices() {
+        std::vector<uint32_t> indices(tamano);
+        ::ordenarRadixIndices(vista(array), vista(indices));
+        return indices;
+    }
+
+    // Comprueba que la permutación ordena el array, es estable y no repite índices
+    bool verificarPermutacion(const std::vector<uint32_t>& permutacion) const {
+        if (permutacion.size() != tamano) return false;
+        std::vector<bool> visto(tamano, false);
+        for (size_t i = 0; i < tamano; ++i) {
+            uint32_t p = permutacion[i];
+            if (p >= tamano || visto[p]) return false;
+            visto[p] = true;
+            if (i > 0) {
+                int anterior = array[permutacion[i - 1]];
+                if (anterior > array[p] || (anterior == array[p] && permutacion[i - 1] > p)) return false;
+            }
+        }
+        return true;
     }
 
     // Verifica si el resultado del ordenamiento paralelo es correcto
     bool verificarResultado() {
-        std::vector<int> arrOrdenado = array;
+        std::vector<int> arrOrdenado(array.begin(), array.end());
         std::sort(arrOrdenado.begin(), arrOrdenado.end());
         
-        std::vector<int> arrParalelo = array;
+        std::vector<int> arrParalelo(array.begin(), array.end());
         #pragma omp parallel
         {
             #pragma omp single
@@ -132,34 +216,584 @@ public:
         return arrOrdenado == arrParalelo;
     }
 
-    // Método para ejecutar y comparar las versiones secuencial y paralela
-    void ejecutar() {
+    // Mide la versión secuencial y los algoritmos paralelos elegidos con el arnés
+    // común y comprueba sus resultados. Con --barrido añade el escalado fuerte y
+    // el débil (array proporcional a los hilos) de cada algoritmo.
+    // algoritmo: "todos", "mezcla", "mezcla-robo", "buffer", "buffer-robo",
+    // "radix" o "radix-indices"
+    bool ejecutar(const OpcionesMedicion& opciones, const std::string& algoritmo = "todos") {
+        const bool todos = (algoritmo == "todos");
         imprimirElementos(array, "Array original:");
+        std::cout << "Tamaño del array: " << tamano << std::endl;
+        std::cout << "Corte de hoja: " << corteHoja << " elementos" << std::endl;
+        std::cout << "Distribución: " << nombreDistribucion(distribucion) << std::endl;
+
+        std::vector<int> resultadoSecuencial, resultadoParalelo, resultadoRobo, resultadoBuffer, resultadoBufferRobo,
+            resultadoRadix;
+        std::vector<uint32_t> permutacion;
+        ArnesMedicion arnes("ordenamiento_paralelo", opciones);
+        arnes.registrar("secuencial", tamano, [&] { resultadoSecuencial = ordenarSecuencial(); });
+
+        // Registra un algoritmo paralelo y su escalado débil: cada tamaño del
+        // barrido usa un ordenador nuevo con el mismo corte de hoja
+        const size_t porHilo = std::max<size_t>(tamano / omp_get_max_threads(), 1);
+        const size_t corte = corteHoja;
+        const Distribucion d = distribucion;
+        const uint64_t semilla = opciones.semilla;
+        auto registrarAlgoritmo = [&](const char* nombre, std::function<void()> ordenar,
+                                      std::function<void(OrdenadorParalelo&)> ordenarOtro) {
+            arnes.registrarParalelo(nombre, tamano, ordenar);
+            arnes.registrarEscaladoDebil(nombre, porHilo, [porHilo, corte, d, semilla, ordenarOtro](int hilos) {
+                auto ordenador = std::make_shared<OrdenadorParalelo>(porHilo * hilos, corte, d, semilla);
+                return [ordenador, ordenarOtro] { ordenarOtro(*ordenador); };
+            });
+        };
+        if (todos || algoritmo == "mezcla") {
+            registrarAlgoritmo("mezcla", [&] { resultadoParalelo = ordenarParalelo(); },
+                               [](OrdenadorParalelo& o) { o.ordenarParalelo(); });
+        }
+        if (todos || algoritmo == "mezcla-robo") {
+            registrarAlgoritmo("mezcla-robo", [&] { resultadoRobo = ordenarParaleloRobo(); },
+                               [](OrdenadorParalelo& o) { o.ordenarParaleloRobo(); });
+        }
+        if (todos || algoritmo == "buffer") {
+            registrarAlgoritmo("buffer", [&] { resultadoBuffer = ordenarParaleloBuffer(); },
+                               [](OrdenadorParalelo& o) { o.ordenarParaleloBuffer(); });
+        }
+        if (todos || algoritmo == "buffer-robo") {
+            registrarAlgoritmo("buffer-robo", [&] { resultadoBufferRobo = ordenarParaleloBuffer<TareasRobo>(); },
+                               [](OrdenadorParalelo& o) { o.ordenarParaleloBuffer<TareasRobo>(); });
+        }
+        if (todos || algoritmo == "radix") {
+            registrarAlgoritmo("radix", [&] { resultadoRadix = ordenarRadix(); },
+                               [](OrdenadorParalelo& o) { o.ordenarRadix(); });
+        }
+        if (todos || algoritmo == "radix-indices") {
+            // Ordenamiento clave/valor: solo se mide la obtención de la permutación
+            registrarAlgoritmo("radix-indices", [&] { permutacion = ordenarRadixIndices(); },
+                               [](OrdenadorParalelo& o) { o.ordenarRadixIndices(); });
+        }
+        bool escrito = arnes.ejecutar();
+
+        imprimirElementos(resultadoSecuencial, "Resultado secuencial:");
+        std::vector<int> referencia(array.begin(), array.end());
+        std::sort(referencia.begin(), referencia.end());
+        if (todos || algoritmo == "mezcla") {
+            imprimirElementos(resultadoParalelo, "Resultado paralelo:");
+            std::cout << "Resultado correcto: " << (resultadoParalelo == referencia ? "Sí" : "No") << std::endl;
+        }
+        if (todos || algoritmo == "mezcla-robo") {
+            std::cout << "Resultado correcto (robo de trabajo): " << (resultadoRobo == referencia ? "Sí" : "No") << std::endl;
+        }
+        if (todos || algoritmo == "buffer") {
+            imprimirElementos(resultadoBuffer, "Resultado paralelo (buffer único):");
+            std::cout << "Resultado correcto (buffer único): " << (resultadoBuffer == referencia ? "Sí" : "No") << std::endl;
+        }
+        if (todos || algoritmo == "buffer-robo") {
+            std::cout << "Resultado correcto (buffer único, robo de trabajo): "
+                      << (resultadoBufferRobo == referencia ? "Sí" : "No") << std::endl;
+        }
+        if (todos || algoritmo == "radix") {
+            imprimirElementos(resultadoRadix, "Resultado paralelo (radix):");
+            std::cout << "Resultado correcto (radix): " << (resultadoRadix == referencia ? "Sí" : "No") << std::endl;
+        }
+        if (todos || algoritmo == "radix-indices") {
+            std::cout << "Resultado correcto (radix clave/índice): "
+                      << (verificarPermutacion(permutacion) ? "Sí" : "No") << std::endl;
+        }
+        return escrito;
+    }
+};
+
+#ifdef ORDENAMIENTO_POSIX
+// Elementos mínimos por bloque de lectura en la fase de mezcla: limita el grado
+// de mezcla para que cada lectura siga siendo secuencial y grande (256 KB)
+const size_t BLOQUE_MINIMO_EXTERNO = 1 << 16;
+
+// Ordenamiento externo de archivos binarios de claves int de 32 bits (orden de
+// bytes nativo) mayores que la memoria disponible. Fase 1: se leen trozos que
+// caben en el presupuesto, se ordenan con el radix sort paralelo y se escriben
+// como runs ordenados. Fase 2: mezcla de k vías con árbol de perdedores, con
+// lecturas y escrituras asíncronas en doble buffer; si hay más runs que el grado
+// máximo de mezcla se hacen varias pasadas
+class OrdenadorExterno {
+private:
+    // Run ordenado dentro de un archivo temporal (en elementos)
+    struct Run {
+        uint64_t inicio;
+        uint64_t cantidad;
+    };
+
+    // Lector de un run con doble buffer: se consume un bloque mientras el
+    // siguiente se lee en segundo plano
+    struct LectorRun {
+        uint64_t siguiente = 0, fin = 0;   // Próximo elemento a pedir y final del run
+        std::vector<int> bloques[2];
+        size_t actual = 0, posicion = 0, disponibles = 0;
+        size_t cantidadPendiente = 0;
+        std::future<bool> pendiente;
+    };
+
+    size_t presupuestoBytes;
+    std::string directorioTemporal;
+
+    static bool leerCompleto(int descriptor, void* destino, size_t bytes, uint64_t posicion) {
+        size_t leidos = 0;
+        while (leidos < bytes) {
+            ssize_t r = pread(descriptor, static_cast<char*>(destino) + leidos, bytes - leidos, posicion + leidos);
+            if (r <= 0) return false;
+            leidos += static_cast<size_t>(r);
+        }
+        return true;
+    }
+
+    static bool escribirCompleto(int descriptor, const void* origen, size_t bytes, uint64_t posicion) {
+        size_t escritos = 0;
+        while (escritos < bytes) {
+            ssize_t r = pwrite(descriptor, static_cast<const char*>(origen) + escritos, bytes - escritos, posicion + escritos);
+            if (r <= 0) return false;
+            escritos += static_cast<size_t>(r);
+        }
+        return true;
+    }
+
+    // Crea un archivo temporal anónimo: se desvincula nada más abrirlo para que
+    // el sistema lo elimine al cerrarlo, también si el programa termina con error
+    int crearTemporal() const {
+        std::string plantilla = directorioTemporal + "/ordenamiento_externo_XXXXXX";
+        std::vector<char> ruta(plantilla.begin(), plantilla.end());
+        ruta.push_back('\0');
+        int descriptor = mkstemp(ruta.data());
+        if (descriptor >= 0) unlink(ruta.data());
+        return descriptor;
+    }
+
+    // Suma y xor de las claves: firma barata para comprobar que la salida es una
+    // permutación de la entrada sin guardar una copia
+    static void acumularFirma(const int* datos, size_t n, uint64_t& suma, uint64_t& mezcla) {
+        uint64_t s = 0, x = 0;
+        #pragma omp parallel for reduction(+:s) reduction(^:x) schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t v = static_cast<uint32_t>(datos[i]);
+            s += v;
+            x ^= v * 0x9E3779B97F4A7C15ull;
+        }
+        suma += s;
+        mezcla ^= x;
+    }
+
+    // Fase 1: genera runs ordenados de hasta elementosRun claves. La lectura del
+    // trozo siguiente y la escritura del anterior se solapan con la ordenación
+    bool generarRuns(int entrada, uint64_t total, int temporal, size_t elementosRun,
+                     std::vector<Run>& runs, uint64_t& suma, uint64_t& mezcla) {
+        std::vector<int> buffers[2] = {std::vector<int>(elementosRun), std::vector<int>(elementosRun)};
+        std::vector<int> auxiliar(elementosRun);
+        for (uint64_t inicio = 0; inicio < total; inicio += elementosRun) {
+            runs.push_back(Run{inicio, std::min<uint64_t>(elementosRun, total - inicio)});
+        }
+
+        auto leerRun = [&](size_t r) {
+            return std::async(std::launch::async, [&, r]() {
+                return leerCompleto(entrada, buffers[r % 2].data(), runs[r].cantidad * sizeof(int),
+                                    runs[r].inicio * sizeof(int));
+            });
+        };
+
+        bool correcto = true;
+        std::future<bool> lectura, escritura;
+        if (!runs.empty()) lectura = leerRun(0);
+        for (size_t r = 0; r < runs.size() && correcto; ++r) {
+            correcto = lectura.get();
+            // El buffer del run anterior debe estar escrito antes de reutilizarlo
+            if (escritura.valid() && !escritura.get()) correcto = false;
+            if (!correcto) break;
+            if (r + 1 < runs.size()) lectura = leerRun(r + 1);
+
+            int* datos = buffers[r % 2].data();
+            const size_t n = runs[r].cantidad;
+            const uint64_t posicion = runs[r].inicio * sizeof(int);
+            acumularFirma(datos, n, suma, mezcla);
+            ordenarRadix(Vista<int>(datos, n), Vista<int>(auxiliar.data(), n));
+            escritura = std::async(std::launch::async, [=]() {
+                return escribirCompleto(temporal, datos, n * sizeof(int), posicion);
+            });
+        }
+        // No se sale con operaciones pendientes sobre los buffers locales
+        if (lectura.valid()) lectura.wait();
+        if (escritura.valid() && !escritura.get()) correcto = false;
+        return correcto;
+    }
+
+    static void lanzarLectura(int descriptor, LectorRun& lector) {
+        size_t cantidad = static_cast<size_t>(std::min<uint64_t>(lector.bloques[0].size(), lector.fin - lector.siguiente));
+        lector.cantidadPendiente = cantidad;
+        if (cantidad == 0) {
+            lector.pendiente = std::future<bool>();
+            return;
+        }
+        int* destino = lector.bloques[lector.actual ^ 1].data();
+        uint64_t posicion = lector.siguiente * sizeof(int);
+        lector.siguiente += cantidad;
+        lector.pendiente = std::async(std::launch::async, [=]() {
+            return leerCompleto(descriptor, destino, cantidad * sizeof(int), posicion);
+        });
+    }
+
+    // Cambia al bloque leído en segundo plano y pide el siguiente; devuelve
+    // false si el run se agotó (o si falló la lectura, indicado en error)
+    static bool recargar(int descriptor, LectorRun& lector, bool& error) {
+        if (!lector.pendiente.valid()) return false;
+        if (!lector.pendiente.get()) {
+            error = true;
+            return false;
+        }
+        lector.actual ^= 1;
+        lector.disponibles = lector.cantidadPendiente;
+        lector.posicion = 0;
+        lanzarLectura(descriptor, lector);
+        return true;
+    }
+
+    // Fase 2: mezcla los runs [primero, primero+k) de 'entrada' y escribe el
+    // resultado a partir del elemento 'destino' de 'salida'
+    bool mezclarRuns(int entrada, const std::vector<Run>& runs, size_t primero, size_t k,
+                     int salida, uint64_t destino, size_t elementosBloque) {
+        std::vector<LectorRun> lectores(k);
+        std::vector<int> claveActual(k);
+        std::vector<char> agotado(k, 0);
+        bool error = false;
+
+        for (size_t r = 0; r < k; ++r) {
+            LectorRun& lector = lectores[r];
+            lector.bloques[0].resize(elementosBloque);
+            lector.bloques[1].resize(elementosBloque);
+            lector.siguiente = runs[primero + r].inicio;
+            lector.fin = runs[primero + r].inicio + runs[primero + r].cantidad;
+            lector.actual = 1;  // La primera lectura va al bloque 0
+            lanzarLectura(entrada, lector);
+        }
+        for (size_t r = 0; r < k; ++r) {
+            if (recargar(entrada, lectores[r], error)) {
+                claveActual[r] = lectores[r].bloques[lectores[r].actual][0];
+            } else {
+                agotado[r] = 1;
+            }
+        }
+
+        // a gana a b si no está agotado y su clave es menor (a igualdad, el run
+        // de menor índice, para que la mezcla sea estable)
+        auto gana = [&](size_t a, size_t b) {
+            if (agotado[a]) return false;
+            if (agotado[b]) return true;
+            return claveActual[a] < claveActual[b] || (claveActual[a] == claveActual[b] && a < b);
+        };
+
+        // Árbol de perdedores implícito: las hojas son los nodos k..2k-1 y cada
+        // nodo interno guarda el perdedor de su partido; arbol[0] es el ganador.
+        // Reponer el ganador solo recorre su camino hasta la raíz: log2(k)
+        // comparaciones, frente a 2 log2(k) de un montículo
+        std::vector<size_t> arbol(std::max<size_t>(k, 1));
+        {
+            std::vector<size_t> ganadores(2 * k);
+            for (size_t r = 0; r < k; ++r) ganadores[k + r] = r;
+            for (size_t nodo = k - 1; nodo >= 1; --nodo) {
+                size_t a = ganadores[2 * nodo], b = ganadores[2 * nodo + 1];
+                ganadores[nodo] = gana(a, b) ? a : b;
+                arbol[nodo] = gana(a, b) ? b : a;
+            }
+            arbol[0] = k > 1 ? ganadores[1] : 0;
+        }
+
+        // Salida con doble buffer: se llena un bloque mientras el otro se escribe
+        std::vector<int> bloquesSalida[2] = {std::vector<int>(elementosBloque), std::vector<int>(elementosBloque)};
+        size_t actualSalida = 0, llenos = 0;
+        uint64_t posicionSalida = destino;
+        std::future<bool> escritura;
+        auto volcar = [&]() {
+            if (escritura.valid() && !escritura.get()) error = true;
+            const int* datos = bloquesSalida[actualSalida].data();
+            const size_t n = llenos;
+            const uint64_t posicion = posicionSalida * sizeof(int);
+            escritura = std::async(std::launch::async, [=]() {
+                return escribirCompleto(salida, datos, n * sizeof(int), posicion);
+            });
+            posicionSalida += llenos;
+            actualSalida ^= 1;
+            llenos = 0;
+        };
+
+        while (!error && !agotado[arbol[0]]) {
+            size_t ganador = arbol[0];
+            bloquesSalida[actualSalida][llenos++] = claveActual[ganador];
+            if (llenos == elementosBloque) volcar();
+
+            LectorRun& lector = lectores[ganador];
+            if (++lector.posicion < lector.disponibles || recargar(entrada, lector, error)) {
+                claveActual[ganador] = lector.bloques[lector.actual][lector.posicion];
+            } else {
+                agotado[ganador] = 1;
+            }
+            for (size_t nodo = (ganador + k) / 2; nodo > 0; nodo /= 2) {
+                if (gana(arbol[nodo], ganador)) std::swap(arbol[nodo], ganador);
+            }
+            arbol[0] = ganador;
+        }
+        if (llenos > 0) volcar();
+        if (escritura.valid() && !escritura.get()) error = true;
+        for (auto& lector : lectores) {
+            if (lector.pendiente.valid()) lector.pendiente.wait();
+        }
+        return !error;
+    }
+
+    // Lee la salida por bloques y comprueba que está ordenada y que su firma
+    // coincide con la de la entrada
+    static bool verificarSalida(int descriptor, uint64_t total, uint64_t suma, uint64_t mezcla) {
+        std::vector<int> bloque(1 << 20);
+        uint64_t sumaSalida = 0, mezclaSalida = 0;
+        bool hayAnterior = false;
+        int anterior = 0;
+        for (uint64_t inicio = 0; inicio < total; inicio += bloque.size()) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(bloque.size(), total - inicio));
+            if (!leerCompleto(descriptor, bloque.data(), n * sizeof(int), inicio * sizeof(int))) return false;
+            for (size_t i = 0; i < n; ++i) {
+                if (hayAnterior && bloque[i] < anterior) return false;
+                anterior = bloque[i];
+                hayAnterior = true;
+            }
+            acumularFirma(bloque.data(), n, sumaSalida, mezclaSalida);
+        }
+        return sumaSalida == suma && mezclaSalida == mezcla;
+    }
+
+public:
+    OrdenadorExterno(size_t presupuestoMB, const std::string& directorio)
+        : presupuestoBytes(std::max<size_t>(presupuestoMB, 1) << 20), directorioTemporal(directorio) {}
+
+    bool ordenar(const std::string& rutaEntrada, const std::string& rutaSalida) {
+        int entrada = open(rutaEntrada.c_str(), O_RDONLY);
+        if (entrada < 0) {
+            std::cerr << "No se pudo abrir el archivo " << rutaEntrada << std::endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(entrada, &info) != 0 || info.st_size % sizeof(int) != 0) {
+            std::cerr << "El tamaño de " << rutaEntrada << " no es múltiplo de " << sizeof(int) << " bytes" << std::endl;
+            close(entrada);
+            return false;
+        }
+        const uint64_t total = static_cast<uint64_t>(info.st_size) / sizeof(int);
+
+        // Fase 1: dos buffers de lectura/escritura más el auxiliar del radix
+        const size_t elementosRun = std::max<size_t>(presupuestoBytes / (3 * sizeof(int)), BLOQUE_MINIMO_EXTERNO);
+        // Fase 2: cada run usa dos bloques de entrada y la salida otros dos
+        const size_t gradoMaximo = std::max<size_t>(presupuestoBytes / (2 * BLOQUE_MINIMO_EXTERNO * sizeof(int)), 3) - 1;
+
+        int temporales[2] = {crearTemporal(), -1};
+        if (temporales[0] < 0) {
+            std::cerr << "No se pudo crear un archivo temporal en " << directorioTemporal << std::endl;
+            close(entrada);
+            return false;
+        }
 
-        // Ejecución y medición del tiempo para la versión secuencial
         auto inicio = std::chrono::high_resolution_clock::now();
-        ordenarSecuencial();
+        std::vector<Run> runs;
+        uint64_t suma = 0, mezcla = 0;
+        bool correcto = generarRuns(entrada, total, temporales[0], elementosRun, runs, suma, mezcla);
+        close(entrada);
+        auto finRuns = std::chrono::high_resolution_clock::now();
+        const size_t runsIniciales = runs.size();
+
+        // Pasadas de mezcla intermedias mientras haya más runs que el grado máximo
+        size_t pasadas = 0, actual = 0;
+        while (correcto && runs.size() > gradoMaximo) {
+            if (temporales[1 - actual] < 0 && (temporales[1 - actual] = crearTemporal()) < 0) {
+                std::cerr << "No se pudo crear un archivo temporal en " << directorioTemporal << std::endl;
+                correcto = false;
+                break;
+            }
+            std::vector<Run> siguientes;
+            for (size_t primero = 0; primero < runs.size() && correcto; primero += gradoMaximo) {
+                size_t k = std::min(gradoMaximo, runs.size() - primero);
+                uint64_t cantidad = 0;
+                for (size_t r = primero; r < primero + k; ++r) cantidad += runs[r].cantidad;
+                size_t elementosBloque = presupuestoBytes / (2 * (k + 1) * sizeof(int));
+                correcto = mezclarRuns(temporales[actual], runs, primero, k, temporales[1 - actual],
+                                       runs[primero].inicio, elementosBloque);
+                siguientes.push_back(Run{runs[primero].inicio, cantidad});
+            }
+            runs.swap(siguientes);
+            actual = 1 - actual;
+            ++pasadas;
+        }
+
+        // Pasada final hacia el archivo de salida
+        int salida = open(rutaSalida.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+        if (salida < 0) {
+            std::cerr << "No se pudo crear el archivo " << rutaSalida << std::endl;
+            correcto = false;
+        }
+        if (correcto && !runs.empty()) {
+            size_t elementosBloque = presupuestoBytes / (2 * (runs.size() + 1) * sizeof(int));
+            correcto = mezclarRuns(temporales[actual], runs, 0, runs.size(), salida, 0, elementosBloque);
+            ++pasadas;
+        }
         auto fin = std::chrono::high_resolution_clock::now();
-        auto duracionSecuencial = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
+        for (int descriptor : temporales) {
+            if (descriptor >= 0) close(descriptor);
+        }
 
-        // Ejecución y medición del tiempo para la versión paralela
-        inicio = std::chrono::high_resolution_clock::now();
-        ordenarParalelo();
-        fin = std::chrono::high_resolution_clock::now();
-        auto duracionParalelo = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
+        bool verificado = correcto && verificarSalida(salida, total, suma, mezcla);
+        if (salida >= 0) close(salida);
 
-        // Impresión de resultados
-        std::cout << "Tamaño del array: " << tamano << std::endl;
-        std::cout << "Tiempo de ejecución (secuencial): " << duracionSecuencial << " ms" << std::endl;
-        std::cout << "Tiempo de ejecución (paralelo): " << duracionParalelo << " ms" << std::endl;
-        std::cout << "Aceleración: " << static_cast<double>(duracionSecuencial) / duracionParalelo << "x" << std::endl;
-        std::cout << "Resultado correcto: " << (verificarResultado() ? "Sí" : "No") << std::endl;
+        double msRuns = std::chrono::duration<double, std::milli>(finRuns - inicio).count();
+        double msMezcla = std::chrono::duration<double, std::milli>(fin - finRuns).count();
+        double megabytes = static_cast<double>(total * sizeof(int)) / 1e6;
+        struct rusage uso;
+        getrusage(RUSAGE_SELF, &uso);
+
+        std::cout << "Claves: " << total << " (" << megabytes << " MB), presupuesto de memoria: "
+                  << (presupuestoBytes >> 20) << " MB" << std::endl;
+        std::cout << "Runs iniciales: " << runsIniciales << " de hasta " << elementosRun << " claves; grado máximo de mezcla: "
+                  << gradoMaximo << "; pasadas de mezcla: " << pasadas << std::endl;
+        std::cout << "Tiempo de generación de runs: " << msRuns << " ms" << std::endl;
+        std::cout << "Tiempo de mezcla: " << msMezcla << " ms" << std::endl;
+        std::cout << "Rendimiento total: " << megabytes / std::max((msRuns + msMezcla) / 1e3, 1e-9) << " MB/s" << std::endl;
+        std::cout << "Memoria residente máxima: " << uso.ru_maxrss / 1024.0 << " MB" << std::endl;
+        std::cout << "Resultado correcto: " << (verificado ? "Sí" : "No") << std::endl;
+        return verificado;
     }
 };
 
-int main() {
+// Escribe n claves int aleatorias por bloques, para crear entradas mayores que la
+// memoria. Cada bloque se genera en paralelo con su propia semilla derivada, así
+// el archivo depende solo de la semilla
+bool generarArchivoClaves(const std::string& ruta, uint64_t n, uint64_t semilla) {
+    int descriptor = open(ruta.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (descriptor < 0) {
+        std::cerr << "No se pudo crear el archivo " << ruta << std::endl;
+        return false;
+    }
+    VectorNuma<int> bloque(1 << 20);
+    bool correcto = true;
+    for (uint64_t inicio = 0; inicio < n && correcto; inicio += bloque.size()) {
+        size_t cantidad = static_cast<size_t>(std::min<uint64_t>(bloque.size(), n - inicio));
+        generarUniforme(Vista<int>(bloque.data(), cantidad), std::numeric_limits<int>::min(),
+                        std::numeric_limits<int>::max(), semilla + inicio / bloque.size());
+        size_t bytes = cantidad * sizeof(int);
+        correcto = pwrite(descriptor, bloque.data(), bytes, inicio * sizeof(int)) == static_cast<ssize_t>(bytes);
+    }
+    close(descriptor);
+    return correcto;
+}
+#endif
+
+// Árbol binario completo de tareas vacías: cuenta sus 2^profundidad hojas con
+// 2^profundidad - 1 bifurcaciones, así que mide solo el coste de crear, robar
+// y esperar tareas
+template <typename Tareas>
+uint64_t contarHojas(int profundidad) {
+    if (profundidad == 0) return 1;
+    uint64_t izquierda = 0, derecha = 0;
+    Tareas::unir([&] { izquierda = contarHojas<Tareas>(profundidad - 1); },
+                 [&] { derecha = contarHojas<Tareas>(profundidad - 1); });
+    return izquierda + derecha;
+}
+
+// Modo "tareas": rendimiento de creación y robo de tareas de las tareas de
+// OpenMP frente al planificador de robo de trabajo, con el árbol de tareas
+// vacías de la profundidad dada
+bool ejecutarTareas(int profundidad, const OpcionesMedicion& opciones) {
+    const uint64_t hojas = uint64_t(1) << profundidad;
+    const double bifurcaciones = static_cast<double>(hojas - 1);
+    uint64_t hojasOpenMP = 0, hojasRobo = 0, ejecucionesRobo = 0;
+    PlanificadorRobo& planificador = PlanificadorRobo::global();
+    planificador.reiniciarEstadisticas();
+
+    std::cout << "Árbol de tareas: profundidad " << profundidad << ", " << hojas - 1 << " bifurcaciones" << std::endl;
+    ArnesMedicion arnes("ordenamiento_paralelo_tareas", opciones);
+    arnes.registrarParalelo("openmp", bifurcaciones, [&] {
+        TareasOpenMP::ejecutar([&] { hojasOpenMP = contarHojas<TareasOpenMP>(profundidad); });
+    });
+    arnes.registrarParalelo("robo", bifurcaciones, [&] {
+        TareasRobo::ejecutar([&] { hojasRobo = contarHojas<TareasRobo>(profundidad); });
+        ++ejecucionesRobo;
+    });
+    bool escrito = arnes.ejecutar();
+
+    for (const char* caso : {"openmp", "robo"}) {
+        double ms = arnes.mediana(caso);
+        std::cout << "Bifurcaciones por segundo (" << caso << "): "
+                  << (ms > 0.0 ? bifurcaciones / (ms * 1e3) : 0.0) << " millones" << std::endl;
+    }
+    EstadisticasRobo estadisticas = planificador.estadisticas();
+    if (ejecucionesRobo > 0 && estadisticas.tareas > 0) {
+        std::cout << "Robo de trabajo: " << estadisticas.tareas / ejecucionesRobo << " tareas y "
+                  << estadisticas.robos / ejecucionesRobo << " robos por ejecución ("
+                  << 100.0 * estadisticas.robos / estadisticas.tareas << " % de las tareas robadas)" << std::endl;
+    }
+    bool correcto = hojasOpenMP == hojas && hojasRobo == hojas;
+    std::cout << "Resultado correcto: " << (correcto ? "Sí" : "No") << std::endl;
+    return escrito && correcto;
+}
+
+int main(int argc, char* argv[]) {
     const size_t TAMANO_ARRAY = 10000000; // Tamaño del array para el ordenamiento
-    OrdenadorParalelo ordenador(TAMANO_ARRAY);
-    ordenador.ejecutar();
-    return 0;
+    OpcionesMedicion opciones;
+    if (!extraerOpcionesMedicion(argc, argv, opciones)) return 1;
+
+#ifdef ORDENAMIENTO_POSIX
+    // Modo "externo": ordena un archivo binario de claves int que no cabe en memoria
+    //   externo <entrada> <salida> [memoria_MB] [directorio_temporal]
+    // Modo "generar": crea un archivo de n claves aleatorias
+    //   generar <salida> <n>
+    if (argc > 1 && std::string(argv[1]) == "externo") {
+        if (argc < 4) {
+            std::cerr << "Uso: " << argv[0] << " externo <entrada> <salida> [memoria_MB] [directorio_temporal]" << std::endl;
+            return 1;
+        }
+        size_t memoria = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 256;
+        const char* tmpdir = std::getenv("TMPDIR");
+        std::string directorio = argc > 5 ? argv[5] : (tmpdir ? tmpdir : "/tmp");
+        OrdenadorExterno externo(memoria, directorio);
+        return externo.ordenar(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (argc > 1 && std::string(argv[1]) == "generar") {
+        if (argc < 4) {
+            std::cerr << "Uso: " << argv[0] << " generar <salida> <n>" << std::endl;
+            return 1;
+        }
+        return generarArchivoClaves(argv[2], std::strtoull(argv[3], nullptr, 10), opciones.semilla) ? 0 : 1;
+    }
+#endif
+
+    // Modo "tareas": coste de crear y robar tareas con cada backend
+    //   tareas [profundidad]
+    if (argc > 1 && std::string(argv[1]) == "tareas") {
+        int profundidad = argc > 2 ? std::atoi(argv[2]) : 20;
+        if (profundidad < 1 || profundidad > 30) {
+            std::cerr << "Uso: " << argv[0] << " tareas [profundidad entre 1 y 30]" << std::endl;
+            return 1;
+        }
+        return ejecutarTareas(profundidad, opciones) ? 0 : 1;
+    }
+
+    // Argumentos opcionales: algoritmo a comparar con la versión secuencial
+    // (todos, mezcla, mezcla-robo, buffer, buffer-robo, radix, radix-indices),
+    // corte de hoja del ordenamiento con buffer único y distribución de las
+    // claves de entrada
+    std::string algoritmo = argc > 1 ? argv[1] : "todos";
+    Distribucion distribucion = Distribucion::Uniforme;
+    if ((algoritmo != "todos" && algoritmo != "mezcla" && algoritmo != "mezcla-robo" && algoritmo != "buffer" &&
+         algoritmo != "buffer-robo" && algoritmo != "radix" && algoritmo != "radix-indices") ||
+        (argc > 3 && !distribucionDesdeNombre(argv[3], distribucion))) {
+        std::cerr << "Uso: " << argv[0] << " [todos|mezcla|mezcla-robo|buffer|buffer-robo|radix|radix-indices] [corte_hoja] "
+                  << "[uniforme|normal|zipf|ordenado|inverso|casi-ordenado|duplicados] "
+                  << "[--calentamiento N] [--repeticiones N] [--barrido] [--json archivo] [--csv archivo] "
+                  << "[--semilla N]" << std::endl;
+        return 1;
+    }
+    size_t corte = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8192;
+    OrdenadorParalelo ordenador(TAMANO_ARRAY, corte, distribucion, opciones.semilla);
+    return ordenador.ejecutar(opciones, algoritmo) ? 0 : 1;
 }
\ No newline at end of file
@@ -1,48 +1,135 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
-#include <random>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cctype>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
 #include <omp.h>
+#include "ajuste.h"
+#include "matriz2d.h"
+#include "medicion.h"
+#include "nucleos/generacion.h"
+#include "nucleos/imagenes.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define IMAGENES_POSIX 1
+#endif
+
+// Filtro de referencia k x k directo (sin separar) para un píxel, con la misma
+// normalización en los bordes que el motor separable
+template <typename Pixel>
+double filtrarPixelReferencia(const Matriz2D<Pixel>& entrada, const NucleoSeparable& nucleo, size_t x, size_t y) {
+    const long long radio = nucleo.radio;
+    const long long alto = static_cast<long long>(entrada.filas());
+    const long long ancho = static_cast<long long>(entrada.columnas());
+    unsigned long long sumaEntera = 0, cuenta = 0;
+    double suma = 0.0, pesoTotal = 0.0;
+    for (long long di = -radio; di <= radio; ++di) {
+        for (long long dj = -radio; dj <= radio; ++dj) {
+            long long nx = static_cast<long long>(x) + di;
+            long long ny = static_cast<long long>(y) + dj;
+            if (nx >= 0 && nx < alto && ny >= 0 && ny < ancho) {
+                double peso = static_cast<double>(nucleo.pesos[di + radio]) * nucleo.pesos[dj + radio];
+                sumaEntera += entrada[nx][ny];
+                ++cuenta;
+                suma += peso * entrada[nx][ny];
+                pesoTotal += peso;
+            }
+        }
+    }
+    if (nucleo.esCaja) {
+        return static_cast<double>((2 * sumaEntera + cuenta) / (2 * cuenta));
+    }
+    return suma / pesoTotal;
+}
+
+// Pixel es el tipo de muestra (int, uint16_t o uint8_t): los valores van de 0 a
+// 255, así que los tres dan el mismo resultado, pero con uint8_t el filtro lee
+// y escribe la cuarta parte de bytes que con int. Las sumas de la ventana se
+// acumulan siempre en int
+template <typename Pixel>
 class ProcesadorImagenes {
 private:
-    std::vector<std::vector<int>> imagen;
-    std::vector<std::vector<int>> imagenProcesada;
+    Matriz2D<Pixel> imagen;
+    Matriz2D<Pixel> imagenProcesada;
     size_t ancho, alto;
 
-    // Inicializa la imagen con valores aleatorios
-    void inicializarImagen() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 255);
+    // Genera la imagen en paralelo por filas con valores uniformes en [0, 255]
+    void inicializarImagen(uint64_t semilla) {
+        generarUniforme(imagen.vista(), 0, 255, semilla);
+    }
 
-        for (auto& fila : imagen) {
-            for (auto& pixel : fila) {
-                pixel = dis(gen);
+    // Filtro de desenfoque 3x3 paralelo, común a ambas disposiciones de memoria
+    // (ambas admiten la sintaxis img[i][j]) para poder compararlas con el mismo código
+    template <typename ImagenEntrada, typename ImagenSalida>
+    static void filtrarIngenuo(const ImagenEntrada& entrada, ImagenSalida& salida, size_t ancho, size_t alto) {
+        #pragma omp parallel for collapse(2)
+        for (size_t x = 0; x < alto; ++x) {
+            for (size_t y = 0; y < ancho; ++y) {
+                int suma = 0;
+                for (int i = -1; i <= 1; ++i) {
+                    for (int j = -1; j <= 1; ++j) {
+                        long long nx = static_cast<long long>(x) + i;
+                        long long ny = static_cast<long long>(y) + j;
+                        if (nx >= 0 && nx < static_cast<long long>(alto) &&
+                            ny >= 0 && ny < static_cast<long long>(ancho)) {
+                            suma += entrada[nx][ny];
+                        }
+                    }
+                }
+                salida[x][y] = suma / 9;
             }
         }
     }
 
+    // Copia la imagen a otro tipo de píxel, multiplicando por escala
+    template <typename Destino>
+    Matriz2D<Destino> convertirImagen(int escala) {
+        Matriz2D<Destino> copia(alto, ancho);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < alto; ++i) {
+            for (size_t j = 0; j < ancho; ++j) {
+                copia[i][j] = static_cast<Destino>(imagen[i][j] * escala);
+            }
+        }
+        return copia;
+    }
+
     // Aplica un filtro de desenfoque a un pixel
-    int aplicarFiltro(size_t x, size_t y) {
+    Pixel aplicarFiltro(size_t x, size_t y) {
         int suma = 0;
         for (int i = -1; i <= 1; ++i) {
             for (int j = -1; j <= 1; ++j) {
-                int nx = x + i;
-                int ny = y + j;
-                if (nx >= 0 && nx < alto && ny >= 0 && ny < ancho) {
+                ptrdiff_t nx = static_cast<ptrdiff_t>(x) + i;
+                ptrdiff_t ny = static_cast<ptrdiff_t>(y) + j;
+                if (nx >= 0 && nx < static_cast<ptrdiff_t>(alto) && ny >= 0 && ny < static_cast<ptrdiff_t>(ancho)) {
                     suma += imagen[nx][ny];
                 }
             }
         }
-        return suma / 9;
+        return static_cast<Pixel>(suma / 9);
     }
 
 public:
     // Constructor: inicializa la imagen con un tamaño dado
-    ProcesadorImagenes(size_t w, size_t h) : ancho(w), alto(h), 
-        imagen(h, std::vector<int>(w)), imagenProcesada(h, std::vector<int>(w)) {
-        inicializarImagen();
+    ProcesadorImagenes(size_t w, size_t h, uint64_t semilla) : imagen(h, w), imagenProcesada(h, w),
+        ancho(w), alto(h) {
+        inicializarImagen(semilla);
     }
 
     // Procesa la imagen de forma secuencial
@@ -54,22 +141,26 @@ public:
         }
     }
 
-    // Procesa la imagen de forma paralela
-    void procesarParalelo() {
-        // Usamos #pragma omp parallel for collapse(2) para paralelizar los dos bucles anidados
-        // Justificación: Esto permite una paralelización más granular, distribuyendo
-        // el trabajo de procesamiento de píxeles entre los hilos de manera eficiente
-        #pragma omp parallel for collapse(2)
-        for (size_t i = 0; i < alto; ++i) {
-            for (size_t j = 0; j < ancho; ++j) {
-                imagenProcesada[i][j] = aplicarFiltro(i, j);
+    // Procesa la imagen de forma paralela; los hilos, la planificación y la
+    // afinidad son los de la configuración (por defecto, los del entorno)
+    void procesarParalelo(const ConfiguracionParalela& configuracion = ConfiguracionParalela()) {
+        paraleloAjustado(configuracion, [&] {
+            // Usamos #pragma omp for collapse(2) para paralelizar los dos bucles anidados
+            // Justificación: Esto permite una paralelización más granular, distribuyendo
+            // el trabajo de procesamiento de píxeles entre los hilos; schedule(runtime)
+            // toma la planificación y el bloque elegidos por el ajuste
+            #pragma omp for collapse(2) schedule(runtime)
+            for (size_t i = 0; i < alto; ++i) {
+                for (size_t j = 0; j < ancho; ++j) {
+                    imagenProcesada[i][j] = aplicarFiltro(i, j);
+                }
             }
-        }
+        });
     }
 
     // Verifica si el resultado del procesamiento paralelo es correcto
     bool verificarResultado() {
-        std::vector<std::vector<int>> resultadoSecuencial(alto, std::vector<int>(ancho));
+        Matriz2D<Pixel> resultadoSecuencial(alto, ancho);
         for (size_t i = 0; i < alto; ++i) {
             for (size_t j = 0; j < ancho; ++j) {
                 resultadoSecuencial[i][j] = aplicarFiltro(i, j);
@@ -78,30 +169,748 @@ public:
         return resultadoSecuencial == imagenProcesada;
     }
 
-    // Ejecuta y mide el tiempo de las versiones secuencial y paralela
-    void ejecutar() {
+    const Matriz2D<Pixel>& obtenerImagen() const { return imagen; }
+    const Matriz2D<Pixel>& obtenerResultado() const { return imagenProcesada; }
+
+    // Mide las versiones secuencial y paralela del filtro 3x3 y el motor separable
+    // con el arnés común; con --barrido añade el escalado fuerte y el débil
+    // (filas proporcionales a los hilos)
+    bool ejecutar(const OpcionesMedicion& opciones) {
+        const double pixeles = static_cast<double>(ancho) * alto;
+        Matriz2D<uint8_t> imagen8 = convertirImagen<uint8_t>(1);
+        Matriz2D<uint8_t> salida8(alto, ancho);
+        const NucleoSeparable caja3 = NucleoSeparable::caja(3);
+        std::cout << "Tamaño de la imagen: " << ancho << "x" << alto << std::endl;
+
+        AjustadorParalelo ajustador("procesamiento_imagenes", opciones);
+        const ConfiguracionParalela ajustada = ajustador.configurar(
+            "paralelo", ancho * alto, EspacioAjuste::completo(),
+            [&](const ConfiguracionParalela& configuracion) { procesarParalelo(configuracion); });
+
+        ArnesMedicion arnes("procesamiento_imagenes", opciones);
+        arnes.registrar("secuencial", pixeles, [&] { procesarSecuencial(); });
+        arnes.registrarParalelo("paralelo", pixeles, [&] { procesarParalelo(); });
+        if (!ajustada.porDefecto()) {
+            arnes.registrarParalelo("paralelo ajustado", pixeles, [&] { procesarParalelo(ajustada); });
+        }
+        arnes.registrarParalelo("separable caja 3 uint8_t", pixeles,
+                                [&] { filtrarSeparable(imagen8.vista(), salida8.vista(), caja3); });
+        const size_t filasPorHilo = std::max<size_t>(alto / omp_get_max_threads(), 1);
+        const size_t columnas = ancho;
+        const uint64_t semilla = opciones.semilla;
+        arnes.registrarEscaladoDebil("paralelo", static_cast<double>(columnas) * filasPorHilo,
+                                     [columnas, filasPorHilo, semilla](int hilos) {
+            auto procesador = std::make_shared<ProcesadorImagenes>(columnas, filasPorHilo * hilos, semilla);
+            return [procesador] { procesador->procesarParalelo(); };
+        });
+        bool escrito = arnes.ejecutar();
+
+        double msSeparable = arnes.mediana("separable caja 3 uint8_t");
+        std::cout << "Filtro separable (" << caja3.nombre << ", uint8_t): "
+                  << cocienteTiempos(pixeles / 1e3, msSeparable) << " Mpíxeles/s (mediana)" << std::endl;
+        std::cout << "Resultado correcto: " << (verificarResultado() ? "Sí" : "No") << std::endl;
+        std::cout << "Resultado correcto (separable): "
+                  << (verificarFiltroSeparable(imagen8, salida8, caja3) ? "Sí" : "No") << std::endl;
+        return escrito;
+    }
+
+    // Verifica la salida del motor separable contra el filtro directo k x k en una
+    // muestra de filas (las de los bordes y una de cada 64), ya que la referencia
+    // cuesta k^2 operaciones por píxel
+    template <typename P>
+    bool verificarFiltroSeparable(const Matriz2D<P>& entrada, const Matriz2D<P>& salida,
+                                  const NucleoSeparable& nucleo) {
+        const size_t radio = static_cast<size_t>(nucleo.radio);
+        const double tolerancia = nucleo.esCaja ? 0.0 : 1.0;
+        for (size_t i = 0; i < alto; ++i) {
+            if (i > radio && i + radio + 1 < alto && i % 64 != 0) continue;
+            for (size_t j = 0; j < ancho; ++j) {
+                double esperado = filtrarPixelReferencia(entrada, nucleo, i, j);
+                if (std::abs(salida[i][j] - (nucleo.esCaja ? esperado : std::floor(esperado + 0.5))) > tolerancia) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Aplica un núcleo con el motor separable por tiles, mide su rendimiento y lo
+    // verifica con verificarFiltroSeparable
+    template <typename P>
+    void ejecutarFiltroSeparable(const Matriz2D<P>& entrada, const NucleoSeparable& nucleo,
+                                 const std::string& tipo, double msReferencia) {
+        Matriz2D<P> salida(alto, ancho);
+        auto inicio = std::chrono::high_resolution_clock::now();
+        filtrarSeparable(entrada.vista(), salida.vista(), nucleo);
+        auto fin = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(fin - inicio).count();
+        bool correcto = verificarFiltroSeparable(entrada, salida, nucleo);
+
+        std::cout << "Filtro separable (" << nucleo.nombre << ", " << tipo << "): " << ms << " ms ("
+                  << static_cast<double>(ancho) * alto / (ms * 1e3) << " Mpíxeles/s)" << std::endl;
+        if (msReferencia > 0.0) {
+            std::cout << "Aceleración frente al filtro 3x3 paralelo: " << msReferencia / ms << "x" << std::endl;
+        }
+        std::cout << "Resultado correcto: " << (correcto ? "Sí" : "No") << std::endl;
+    }
+
+    // Recorre varios núcleos de caja y gaussianos con píxeles de 8 y 16 bits
+    void compararFiltrosSeparables() {
+        Matriz2D<uint8_t> imagen8 = convertirImagen<uint8_t>(1);
+        Matriz2D<uint16_t> imagen16 = convertirImagen<uint16_t>(257);
+        std::cout << "Tamaño de la imagen: " << ancho << "x" << alto << std::endl;
+        ejecutarFiltroSeparable(imagen8, NucleoSeparable::caja(3), "uint8_t", 0.0);
+        ejecutarFiltroSeparable(imagen8, NucleoSeparable::caja(7), "uint8_t", 0.0);
+        ejecutarFiltroSeparable(imagen8, NucleoSeparable::caja(15), "uint8_t", 0.0);
+        ejecutarFiltroSeparable(imagen8, NucleoSeparable::gaussiano(5, 1.0), "uint8_t", 0.0);
+        ejecutarFiltroSeparable(imagen8, NucleoSeparable::gaussiano(15, 3.0), "uint8_t", 0.0);
+        ejecutarFiltroSeparable(imagen16, NucleoSeparable::caja(3), "uint16_t", 0.0);
+        ejecutarFiltroSeparable(imagen16, NucleoSeparable::caja(63), "uint16_t", 0.0);
+        ejecutarFiltroSeparable(imagen16, NucleoSeparable::gaussiano(5, 1.0), "uint16_t", 0.0);
+    }
+
+    // Compara la tubería desenfoque -> Sobel -> umbral -> histograma ejecutada
+    // etapa por etapa sobre la imagen completa y fusionada por tiles
+    void compararTuberia() {
+        Matriz2D<uint8_t> imagen8 = convertirImagen<uint8_t>(1);
+        TuberiaImagen<uint8_t> tuberia;
+        tuberia.agregar(etapaDesenfoque<uint8_t>(3))
+               .agregar(etapaSobel<uint8_t>())
+               .agregar(etapaUmbral<uint8_t>(64))
+               .agregar(etapaHistograma<uint8_t>());
+
+        Matriz2D<uint8_t> salidaSinFusion(alto, ancho);
+        std::vector<uint64_t> histogramaSinFusion;
         auto inicio = std::chrono::high_resolution_clock::now();
-        procesarSecuencial();
+        tuberia.ejecutarSinFusion(imagen8.vista(), salidaSinFusion.vista(), histogramaSinFusion);
         auto fin = std::chrono::high_resolution_clock::now();
-        auto duracionSecuencial = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
+        double msSinFusion = std::chrono::duration<double, std::milli>(fin - inicio).count();
 
+        Matriz2D<uint8_t> salidaFusionada(alto, ancho);
+        std::vector<uint64_t> histogramaFusionado;
         inicio = std::chrono::high_resolution_clock::now();
-        procesarParalelo();
+        tuberia.ejecutarFusionada(imagen8.vista(), salidaFusionada.vista(), histogramaFusionado);
         fin = std::chrono::high_resolution_clock::now();
-        auto duracionParalelo = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
+        double msFusionada = std::chrono::duration<double, std::milli>(fin - inicio).count();
+
+        // Tráfico de los intermedios sin fusión: cada imagen intermedia se escribe y se vuelve a leer
+        double megabytesIntermedios = 2.0 * 2.0 * ancho * alto / 1e6;
 
         std::cout << "Tamaño de la imagen: " << ancho << "x" << alto << std::endl;
-        std::cout << "Tiempo de ejecución (secuencial): " << duracionSecuencial << " ms" << std::endl;
-        std::cout << "Tiempo de ejecución (paralelo): " << duracionParalelo << " ms" << std::endl;
-        std::cout << "Aceleración: " << static_cast<double>(duracionSecuencial) / duracionParalelo << "x" << std::endl;
-        std::cout << "Resultado correcto: " << (verificarResultado() ? "Sí" : "No") << std::endl;
+        std::cout << "Tubería: " << tuberia.descripcion() << std::endl;
+        std::cout << "Tiempo de ejecución (sin fusión): " << msSinFusion << " ms" << std::endl;
+        std::cout << "Tiempo de ejecución (fusionada):  " << msFusionada << " ms" << std::endl;
+        std::cout << "Aceleración: " << msSinFusion / msFusionada << "x" << std::endl;
+        std::cout << "Tráfico de intermedios evitado: ~" << megabytesIntermedios << " MB" << std::endl;
+        std::cout << "Píxeles sobre el umbral: " << histogramaFusionado.back() << std::endl;
+        std::cout << "Resultado correcto: "
+                  << (salidaSinFusion == salidaFusionada && histogramaSinFusion == histogramaFusionado ? "Sí" : "No")
+                  << std::endl;
+    }
+
+    // Compara la disposición antigua (un std::vector por fila) con Matriz2D:
+    // mide la construcción de las dos imágenes y el filtro paralelo
+    void compararDisposiciones() {
+        auto inicio = std::chrono::high_resolution_clock::now();
+        std::vector<std::vector<int>> entradaFilas(alto, std::vector<int>(ancho));
+        std::vector<std::vector<int>> salidaFilas(alto, std::vector<int>(ancho));
+        auto fin = std::chrono::high_resolution_clock::now();
+        double construccionFilas = std::chrono::duration<double, std::milli>(fin - inicio).count();
+
+        inicio = std::chrono::high_resolution_clock::now();
+        Matriz2D<int> entradaContigua(alto, ancho);
+        Matriz2D<int> salidaContigua(alto, ancho);
+        fin = std::chrono::high_resolution_clock::now();
+        double construccionContigua = std::chrono::duration<double, std::milli>(fin - inicio).count();
+
+        for (size_t i = 0; i < alto; ++i) {
+            for (size_t j = 0; j < ancho; ++j) {
+                entradaFilas[i][j] = entradaContigua[i][j] = imagen[i][j];
+            }
+        }
+
+        inicio = std::chrono::high_resolution_clock::now();
+        filtrarIngenuo(entradaFilas, salidaFilas, ancho, alto);
+        fin = std::chrono::high_resolution_clock::now();
+        double filtroFilas = std::chrono::duration<double, std::milli>(fin - inicio).count();
+
+        inicio = std::chrono::high_resolution_clock::now();
+        filtrarIngenuo(entradaContigua, salidaContigua, ancho, alto);
+        fin = std::chrono::high_resolution_clock::now();
+        double filtroContigua = std::chrono::duration<double, std::milli>(fin - inicio).count();
+
+        bool iguales = true;
+        for (size_t i = 0; i < alto && iguales; ++i) {
+            for (size_t j = 0; j < ancho; ++j) {
+                if (salidaFilas[i][j] != salidaContigua[i][j]) {
+                    iguales = false;
+                    break;
+                }
+            }
+        }
+
+        std::cout << "Tamaño de la imagen: " << ancho << "x" << alto
+                  << " (stride contiguo: " << salidaContigua.stride() << ")" << std::endl;
+        std::cout << "Construcción (vector de vectores): " << construccionFilas << " ms" << std::endl;
+        std::cout << "Construcción (Matriz2D):           " << construccionContigua << " ms" << std::endl;
+        std::cout << "Filtro (vector de vectores):       " << filtroFilas << " ms" << std::endl;
+        std::cout << "Filtro (Matriz2D):                 " << filtroContigua << " ms" << std::endl;
+        std::cout << "Aceleración del filtro: " << filtroFilas / filtroContigua << "x" << std::endl;
+        std::cout << "Resultados idénticos: " << (iguales ? "Sí" : "No") << std::endl;
     }
 };
 
-int main() {
+// Modo "precision": el filtro 3x3 paralelo y el motor separable (caja 3) con
+// píxeles int, uint16_t y uint8_t sobre la misma imagen. Los valores caben en
+// 8 bits, así que las salidas deben ser idénticas a las de int: se comprueba
+// píxel a píxel junto a la aceleración y los bytes movidos por píxel
+bool compararPrecision(size_t ancho, size_t alto, const OpcionesMedicion& opciones) {
+    ProcesadorImagenes<int> procesador32(ancho, alto, opciones.semilla);
+    ProcesadorImagenes<uint16_t> procesador16(ancho, alto, opciones.semilla);
+    ProcesadorImagenes<uint8_t> procesador8(ancho, alto, opciones.semilla);
+    Matriz2D<int> separable32(alto, ancho);
+    Matriz2D<uint16_t> separable16(alto, ancho);
+    Matriz2D<uint8_t> separable8(alto, ancho);
+    const NucleoSeparable caja3 = NucleoSeparable::caja(3);
+    const double pixeles = static_cast<double>(ancho) * alto;
+    std::cout << "Tamaño de la imagen: " << ancho << "x" << alto << std::endl;
+
+    ArnesMedicion arnes("procesamiento_imagenes_precision", opciones);
+    arnes.registrarParalelo("paralelo int", pixeles, [&] { procesador32.procesarParalelo(); });
+    arnes.registrarParalelo("paralelo uint16_t", pixeles, [&] { procesador16.procesarParalelo(); });
+    arnes.registrarParalelo("paralelo uint8_t", pixeles, [&] { procesador8.procesarParalelo(); });
+    arnes.registrarParalelo("separable int", pixeles,
+                            [&] { filtrarSeparable(procesador32.obtenerImagen().vista(), separable32.vista(), caja3); });
+    arnes.registrarParalelo("separable uint16_t", pixeles,
+                            [&] { filtrarSeparable(procesador16.obtenerImagen().vista(), separable16.vista(), caja3); });
+    arnes.registrarParalelo("separable uint8_t", pixeles,
+                            [&] { filtrarSeparable(procesador8.obtenerImagen().vista(), separable8.vista(), caja3); });
+    // Lectura de la imagen y escritura del resultado
+    for (const char* filtro : {"paralelo", "separable"}) {
+        const std::string nombre(filtro);
+        arnes.asignarCarga(nombre + " int", 2.0 * sizeof(int) * pixeles, 9.0 * pixeles);
+        arnes.asignarCarga(nombre + " uint16_t", 2.0 * sizeof(uint16_t) * pixeles, 9.0 * pixeles);
+        arnes.asignarCarga(nombre + " uint8_t", 2.0 * sizeof(uint8_t) * pixeles, 9.0 * pixeles);
+    }
+    bool escrito = arnes.ejecutar();
+
+    auto iguales = [&](const Matriz2D<int>& referencia, const auto& salida) {
+        for (size_t i = 0; i < alto; ++i) {
+            for (size_t j = 0; j < ancho; ++j) {
+                if (referencia[i][j] != static_cast<int>(salida[i][j])) return false;
+            }
+        }
+        return true;
+    };
+    for (const char* filtro : {"paralelo", "separable"}) {
+        const std::string nombre(filtro);
+        const double msInt = arnes.mediana(nombre + " int");
+        std::cout << std::fixed << std::setprecision(2) << "Aceleración respecto a int (" << nombre << "): uint16_t "
+                  << cocienteTiempos(msInt, arnes.mediana(nombre + " uint16_t")) << "x, uint8_t "
+                  << cocienteTiempos(msInt, arnes.mediana(nombre + " uint8_t")) << "x" << std::endl;
+    }
+    std::cout << std::defaultfloat;
+    const Matriz2D<int>& resultado32 = procesador32.obtenerResultado();
+    std::cout << "Idénticos a int (paralelo): uint16_t "
+              << (iguales(resultado32, procesador16.obtenerResultado()) ? "Sí" : "No") << ", uint8_t "
+              << (iguales(resultado32, procesador8.obtenerResultado()) ? "Sí" : "No") << std::endl;
+    std::cout << "Idénticos a int (separable): uint16_t " << (iguales(separable32, separable16) ? "Sí" : "No")
+              << ", uint8_t " << (iguales(separable32, separable8) ? "Sí" : "No") << std::endl;
+    std::cout << "Resultado correcto: " << (procesador8.verificarResultado() ? "Sí" : "No") << std::endl;
+    return escrito;
+}
+
+#ifdef IMAGENES_POSIX
+// Formato de una imagen en disco: PGM/PPM binarios (P5/P6, muestras de 8 o 16 bits
+// en big-endian) o raw planar (un plano por canal, muestras en little-endian)
+struct FormatoImagen {
+    std::string tipo;  // "P5", "P6" o "raw"
+    size_t ancho = 0, alto = 0, canales = 1, bytesPorMuestra = 1;
+    size_t desplazamiento = 0;  // Bytes de cabecera antes de los píxeles
+    unsigned maximo = 255;
+
+    bool entrelazada() const { return tipo == "P6"; }
+    size_t planos() const { return entrelazada() ? 1 : canales; }
+    size_t bytesFila() const { return ancho * (entrelazada() ? canales : 1) * bytesPorMuestra; }
+    size_t bytesDatos() const { return planos() * alto * bytesFila(); }
+
+    // Desplazamiento del primer byte de la fila i del plano c (en formatos
+    // entrelazados todos los canales comparten la misma fila)
+    size_t inicioFila(size_t c, size_t i) const {
+        size_t plano = entrelazada() ? 0 : c * alto * bytesFila();
+        return desplazamiento + plano + i * bytesFila();
+    }
+
+    std::string cabecera() const {
+        if (tipo == "raw") return "";
+        return tipo + "\n" + std::to_string(ancho) + " " + std::to_string(alto) + "\n" + std::to_string(maximo) + "\n";
+    }
+};
+
+// Archivo proyectado en memoria de solo lectura. Las páginas ya consumidas se
+// devuelven al sistema con madvise(MADV_DONTNEED), de modo que la memoria
+// residente no crece con el tamaño del archivo
+class ArchivoMapeado {
+private:
+    int descriptor;
+    unsigned char* datos;
+    size_t tamano;
+
+public:
+    ArchivoMapeado(const std::string& ruta) : descriptor(-1), datos(nullptr), tamano(0) {
+        descriptor = open(ruta.c_str(), O_RDONLY);
+        if (descriptor < 0) return;
+        struct stat info;
+        if (fstat(descriptor, &info) != 0 || info.st_size == 0) return;
+        tamano = static_cast<size_t>(info.st_size);
+        void* mapa = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapa == MAP_FAILED) {
+            tamano = 0;
+            return;
+        }
+        datos = static_cast<unsigned char*>(mapa);
+        madvise(datos, tamano, MADV_SEQUENTIAL);
+    }
+
+    ~ArchivoMapeado() {
+        if (datos) munmap(datos, tamano);
+        if (descriptor >= 0) close(descriptor);
+    }
+
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    bool valido() const { return datos != nullptr; }
+    const unsigned char* data() const { return datos; }
+
+    // Cierto si el descriptor abierto se refiere a este mismo archivo
+    bool mismoArchivo(int otro) const {
+        struct stat propio, ajeno;
+        if (fstat(descriptor, &propio) != 0 || fstat(otro, &ajeno) != 0) return false;
+        return propio.st_dev == ajeno.st_dev && propio.st_ino == ajeno.st_ino;
+    }
+    size_t size() const { return tamano; }
+
+    // Pide al núcleo que lea por adelantado el rango [desde, hasta)
+    void precargar(size_t desde, size_t hasta) const {
+        size_t pagina = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        desde = desde / pagina * pagina;
+        if (hasta > desde) madvise(datos + desde, std::min(hasta, tamano) - desde, MADV_WILLNEED);
+    }
+
+    // Libera las páginas completas contenidas en [desde, hasta)
+    void liberar(size_t desde, size_t hasta) const {
+        size_t pagina = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        desde = (desde + pagina - 1) / pagina * pagina;
+        hasta = std::min(hasta, tamano) / pagina * pagina;
+        if (hasta > desde) madvise(datos + desde, hasta - desde, MADV_DONTNEED);
+    }
+};
+
+// Lee la cabecera de un PGM (P5) o PPM (P6) binario
+bool leerCabeceraPNM(const ArchivoMapeado& archivo, FormatoImagen& formato) {
+    const unsigned char* p = archivo.data();
+    const size_t n = archivo.size();
+    size_t pos = 0;
+    auto saltarEspacios = [&]() {
+        while (pos < n) {
+            if (p[pos] == '#') {
+                while (pos < n && p[pos] != '\n') ++pos;
+            } else if (std::isspace(p[pos])) {
+                ++pos;
+            } else {
+                break;
+            }
+        }
+    };
+    auto leerNumero = [&](size_t& valor) {
+        saltarEspacios();
+        size_t inicio = pos;
+        valor = 0;
+        while (pos < n && std::isdigit(p[pos])) valor = valor * 10 + (p[pos++] - '0');
+        return pos > inicio;
+    };
+
+    if (n < 2 || p[0] != 'P' || (p[1] != '5' && p[1] != '6')) return false;
+    formato.tipo = p[1] == '5' ? "P5" : "P6";
+    formato.canales = p[1] == '5' ? 1 : 3;
+    pos = 2;
+    size_t maximo = 0;
+    if (!leerNumero(formato.ancho) || !leerNumero(formato.alto) || !leerNumero(maximo)) return false;
+    if (maximo == 0 || maximo > 65535 || pos >= n) return false;
+    formato.maximo = static_cast<unsigned>(maximo);
+    formato.bytesPorMuestra = maximo > 255 ? 2 : 1;
+    formato.desplazamiento = pos + 1;  // Un único espacio en blanco separa la cabecera de los datos
+    return formato.desplazamiento + formato.bytesDatos() <= n;
+}
+
+// Procesa imágenes de disco de cualquier tamaño por franjas horizontales con un
+// halo de filas. Un hilo lector y otro escritor dedicados se comunican con el
+// equipo OpenMP a través de un anillo de tres franjas, así la lectura y la
+// escritura avanzan mientras el equipo filtra. La memoria residente depende del
+// tamaño de franja, no del de la imagen.
+class ProcesadorFlujo {
+private:
+    // Progreso del anillo: franjas completadas por cada etapa. La franja i ocupa
+    // la ranura i % 3, que el lector solo reutiliza cuando el escritor ha
+    // terminado con la franja i - 3
+    struct ProgresoAnillo {
+        std::mutex mutex;
+        std::condition_variable cambio;
+        size_t leidas = 0, filtradas = 0, escritas = 0;
+
+        void esperar(const size_t& contador, size_t objetivo) {
+            std::unique_lock<std::mutex> cerrojo(mutex);
+            cambio.wait(cerrojo, [&] { return contador >= objetivo; });
+        }
+
+        void avanzar(size_t& contador) {
+            {
+                std::lock_guard<std::mutex> cerrojo(mutex);
+                ++contador;
+            }
+            cambio.notify_all();
+        }
+    };
+
+    // Tiempo acumulado (ms) de cada etapa; cada una la mide solo su propio hilo
+    struct TiemposEtapas {
+        double lectura = 0.0, filtrado = 0.0, escritura = 0.0;
+    };
+
+    // Franja de trabajo: filas de entrada [filaEntrada, filaEntrada+filasEntrada)
+    // (salida + halo) y filas de salida [fila0, fila0+filas)
+    template <typename Pixel>
+    struct Franja {
+        std::vector<Matriz2D<Pixel>> entrada;
+        std::vector<Matriz2D<Pixel>> salida;
+        std::vector<unsigned char> bytes;
+        size_t fila0 = 0, filas = 0, filaEntrada = 0, filasEntrada = 0;
+    };
+
+    FormatoImagen formatoEntrada;
+    FormatoImagen formatoSalida;  // Misma geometría; solo cambia la cabecera
+    NucleoSeparable nucleo;
+    size_t filasFranja;
+    TiemposEtapas tiempos;
+
+    template <typename Funcion>
+    static double medirMs(Funcion&& funcion) {
+        auto inicio = std::chrono::steady_clock::now();
+        funcion();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    template <typename Pixel>
+    static Pixel decodificar(const unsigned char* p, bool granEndian) {
+        if (sizeof(Pixel) == 1) return p[0];
+        return static_cast<Pixel>(granEndian ? (p[0] << 8) | p[1] : (p[1] << 8) | p[0]);
+    }
+
+    template <typename Pixel>
+    static void codificar(unsigned char* p, Pixel valor, bool granEndian) {
+        if (sizeof(Pixel) == 1) {
+            p[0] = static_cast<unsigned char>(valor);
+        } else if (granEndian) {
+            p[0] = static_cast<unsigned char>(valor >> 8);
+            p[1] = static_cast<unsigned char>(valor & 0xFF);
+        } else {
+            p[0] = static_cast<unsigned char>(valor & 0xFF);
+            p[1] = static_cast<unsigned char>(valor >> 8);
+        }
+    }
+
+    // Etapa de lectura: decodifica las filas de la franja (con halo) desde el
+    // archivo proyectado y libera las páginas que ya no necesitará ninguna franja
+    template <typename Pixel>
+    void leerFranja(const ArchivoMapeado& archivo, size_t indice, Franja<Pixel>& franja) {
+        const size_t radio = static_cast<size_t>(nucleo.radio);
+        const bool granEndian = formatoEntrada.tipo != "raw";
+        const size_t paso = formatoEntrada.entrelazada() ? formatoEntrada.canales : 1;
+        franja.fila0 = indice * filasFranja;
+        franja.filas = std::min(filasFranja, formatoEntrada.alto - franja.fila0);
+        franja.filaEntrada = franja.fila0 > radio ? franja.fila0 - radio : 0;
+        franja.filasEntrada = std::min(franja.fila0 + franja.filas + radio, formatoEntrada.alto) - franja.filaEntrada;
+
+        for (size_t c = 0; c < formatoEntrada.canales; ++c) {
+            for (size_t f = 0; f < franja.filasEntrada; ++f) {
+                const unsigned char* origen = archivo.data() + formatoEntrada.inicioFila(c, franja.filaEntrada + f)
+                                            + (formatoEntrada.entrelazada() ? c * formatoEntrada.bytesPorMuestra : 0);
+                Pixel* destino = franja.entrada[c][f];
+                for (size_t j = 0; j < formatoEntrada.ancho; ++j) {
+                    destino[j] = decodificar<Pixel>(origen + j * paso * formatoEntrada.bytesPorMuestra, granEndian);
+                }
+            }
+            // La siguiente franja empieza a leer en fila0 + filas - radio
+            size_t siguiente = franja.fila0 + franja.filas > radio ? franja.fila0 + franja.filas - radio : 0;
+            archivo.liberar(formatoEntrada.inicioFila(c, 0), formatoEntrada.inicioFila(c, siguiente));
+            size_t finPrecarga = std::min(siguiente + filasFranja + 2 * radio, formatoEntrada.alto);
+            archivo.precargar(formatoEntrada.inicioFila(c, siguiente), formatoEntrada.inicioFila(c, finPrecarga));
+        }
+    }
+
+    // Etapa de cálculo: una región paralela por franja que filtra todos sus canales
+    template <typename Pixel>
+    void filtrarFranja(Franja<Pixel>& franja) {
+        #pragma omp parallel
+        for (size_t c = 0; c < formatoEntrada.canales; ++c) {
+            VistaTile<const Pixel> entrada = static_cast<const Matriz2D<Pixel>&>(franja.entrada[c])
+                                                 .tile(0, 0, franja.filasEntrada, formatoEntrada.ancho);
+            VistaTile<Pixel> salida = franja.salida[c].tile(0, 0, franja.filasEntrada, formatoEntrada.ancho);
+            filtrarSeparableEnEquipo(entrada, salida, nucleo);
+        }
+    }
+
+    // Etapa de escritura: codifica las filas de salida (sin halo) y las escribe con pwrite
+    template <typename Pixel>
+    bool escribirFranja(int descriptor, const Franja<Pixel>& franja, std::vector<unsigned char>& bytes) {
+        const bool granEndian = formatoSalida.tipo != "raw";
+        const size_t desfase = franja.fila0 - franja.filaEntrada;
+        const size_t bytesFila = formatoSalida.bytesFila();
+        const size_t planos = formatoSalida.entrelazada() ? 1 : formatoSalida.canales;
+        const size_t paso = formatoSalida.entrelazada() ? formatoSalida.canales : 1;
+        bytes.resize(franja.filas * bytesFila);
+
+        for (size_t plano = 0; plano < planos; ++plano) {
+            size_t c0 = formatoSalida.entrelazada() ? 0 : plano;
+            size_t c1 = formatoSalida.entrelazada() ? formatoSalida.canales : plano + 1;
+            for (size_t c = c0; c < c1; ++c) {
+                for (size_t f = 0; f < franja.filas; ++f) {
+                    const Pixel* origen = franja.salida[c][desfase + f];
+                    unsigned char* destino = bytes.data() + f * bytesFila + (c - c0) * formatoSalida.bytesPorMuestra;
+                    for (size_t j = 0; j < formatoSalida.ancho; ++j) {
+                        codificar<Pixel>(destino + j * paso * formatoSalida.bytesPorMuestra, origen[j], granEndian);
+                    }
+                }
+            }
+            off_t posicion = static_cast<off_t>(formatoSalida.inicioFila(plano, franja.fila0));
+            size_t escritos = 0;
+            while (escritos < bytes.size()) {
+                ssize_t r = pwrite(descriptor, bytes.data() + escritos, bytes.size() - escritos, posicion + escritos);
+                if (r <= 0) return false;
+                escritos += static_cast<size_t>(r);
+            }
+        }
+        return true;
+    }
+
+    template <typename Pixel>
+    bool procesar(const ArchivoMapeado& archivo, int descriptor) {
+        const size_t radio = static_cast<size_t>(nucleo.radio);
+        const size_t numFranjas = (formatoEntrada.alto + filasFranja - 1) / filasFranja;
+        const size_t filasMaximas = std::min(filasFranja + 2 * radio, formatoEntrada.alto);
+
+        // Anillo de tres franjas: una se lee, otra se filtra y otra se escribe
+        Franja<Pixel> anillo[3];
+        std::vector<unsigned char> bytesEscritura;
+        for (auto& franja : anillo) {
+            for (size_t c = 0; c < formatoEntrada.canales; ++c) {
+                franja.entrada.emplace_back(filasMaximas, formatoEntrada.ancho);
+                franja.salida.emplace_back(filasMaximas, formatoEntrada.ancho);
+            }
+        }
+
+        // El lector y el escritor son hilos del sistema fuera del equipo OpenMP: si
+        // fueran tareas de la región de filtrado solo se ejecutarían en sus
+        // barreras, que esperan a todas las tareas pendientes
+        ProgresoAnillo progreso;
+        std::atomic<bool> correcto(true);
+        tiempos = TiemposEtapas();
+
+        std::thread lector([&] {
+            for (size_t i = 0; i < numFranjas; ++i) {
+                progreso.esperar(progreso.escritas, i >= 3 ? i - 2 : 0);
+                tiempos.lectura += medirMs([&] { leerFranja(archivo, i, anillo[i % 3]); });
+                progreso.avanzar(progreso.leidas);
+            }
+        });
+        // Tras un error de escritura sigue consumiendo franjas para no bloquear al lector
+        std::thread escritor([&] {
+            for (size_t i = 0; i < numFranjas; ++i) {
+                progreso.esperar(progreso.filtradas, i + 1);
+                if (correcto) {
+                    tiempos.escritura += medirMs([&] {
+                        if (!escribirFranja(descriptor, anillo[i % 3], bytesEscritura)) correcto = false;
+                    });
+                }
+                progreso.avanzar(progreso.escritas);
+            }
+        });
+
+        for (size_t i = 0; i < numFranjas; ++i) {
+            progreso.esperar(progreso.leidas, i + 1);
+            tiempos.filtrado += medirMs([&] { filtrarFranja(anillo[i % 3]); });
+            progreso.avanzar(progreso.filtradas);
+        }
+        lector.join();
+        escritor.join();
+        return correcto;
+    }
+
+public:
+    ProcesadorFlujo(const NucleoSeparable& n, size_t filas) : nucleo(n), filasFranja(std::max<size_t>(filas, 1)) {}
+
+    // Procesa rutaEntrada y escribe el resultado en rutaSalida con el mismo formato;
+    // si formatoRaw no es nulo, la entrada se interpreta como raw planar con esa geometría
+    bool ejecutar(const std::string& rutaEntrada, const std::string& rutaSalida, const FormatoImagen* formatoRaw) {
+        ArchivoMapeado archivo(rutaEntrada);
+        if (!archivo.valido()) {
+            std::cerr << "No se pudo proyectar en memoria el archivo " << rutaEntrada << std::endl;
+            return false;
+        }
+        if (formatoRaw) {
+            formatoEntrada = *formatoRaw;
+            formatoEntrada.tipo = "raw";
+            formatoEntrada.desplazamiento = 0;
+            if (formatoEntrada.bytesDatos() > archivo.size()) {
+                std::cerr << "El archivo raw es más pequeño que la geometría indicada" << std::endl;
+                return false;
+            }
+        } else if (!leerCabeceraPNM(archivo, formatoEntrada)) {
+            std::cerr << "Cabecera PGM/PPM no válida o archivo truncado: " << rutaEntrada << std::endl;
+            return false;
+        }
+
+        formatoSalida = formatoEntrada;
+        std::string cabecera = formatoSalida.cabecera();
+        formatoSalida.desplazamiento = cabecera.size();
+        // Se abre sin O_TRUNC: truncar la entrada mientras está proyectada
+        // provocaría SIGBUS al leerla
+        int descriptor = open(rutaSalida.c_str(), O_CREAT | O_WRONLY, 0644);
+        if (descriptor < 0) {
+            std::cerr << "No se pudo crear el archivo " << rutaSalida << std::endl;
+            return false;
+        }
+        if (archivo.mismoArchivo(descriptor)) {
+            std::cerr << "La salida no puede ser el mismo archivo que la entrada: " << rutaSalida << std::endl;
+            close(descriptor);
+            return false;
+        }
+        if (ftruncate(descriptor, 0) != 0) {
+            std::cerr << "No se pudo truncar el archivo " << rutaSalida << std::endl;
+            close(descriptor);
+            return false;
+        }
+
+        auto inicio = std::chrono::high_resolution_clock::now();
+        bool correcto = pwrite(descriptor, cabecera.data(), cabecera.size(), 0) == static_cast<ssize_t>(cabecera.size());
+        if (correcto) {
+            correcto = formatoEntrada.bytesPorMuestra == 1 ? procesar<uint8_t>(archivo, descriptor)
+                                                           : procesar<uint16_t>(archivo, descriptor);
+        }
+        auto fin = std::chrono::high_resolution_clock::now();
+        close(descriptor);
+
+        double segundos = std::chrono::duration<double>(fin - inicio).count();
+        double megabytes = static_cast<double>(formatoEntrada.bytesDatos()) / 1e6;
+        struct rusage uso;
+        getrusage(RUSAGE_SELF, &uso);
+
+        std::cout << "Imagen: " << formatoEntrada.ancho << "x" << formatoEntrada.alto << " (" << formatoEntrada.tipo
+                  << ", " << formatoEntrada.canales << " canal(es), " << 8 * formatoEntrada.bytesPorMuestra
+                  << " bits)" << std::endl;
+        std::cout << "Filtro: " << nucleo.nombre << ", franjas de " << filasFranja << " filas" << std::endl;
+        std::cout << "Tiempo de ejecución: " << segundos * 1e3 << " ms (" << megabytes / segundos << " MB/s)" << std::endl;
+        // Si las etapas se solapan, su suma supera el tiempo total
+        const double sumaEtapas = tiempos.lectura + tiempos.filtrado + tiempos.escritura;
+        std::cout << "Etapas: lectura " << tiempos.lectura << " ms, filtrado " << tiempos.filtrado
+                  << " ms, escritura " << tiempos.escritura << " ms (suma " << sumaEtapas << " ms, "
+                  << sumaEtapas / (segundos * 1e3) << "x el tiempo total)" << std::endl;
+        std::cout << "Memoria residente máxima: " << uso.ru_maxrss / 1024.0 << " MB (archivo: " << megabytes << " MB)" << std::endl;
+        std::cout << "Resultado escrito: " << (correcto ? "Sí" : "No") << std::endl;
+        return correcto;
+    }
+};
+#endif
+
+#ifdef IMAGENES_POSIX
+// Genera una imagen PGM (1 canal) o PPM (3 canales) aleatoria de 8 bits escribiendo
+// bloque a bloque, para poder crear entradas mayores que la memoria disponible.
+// Cada bloque se genera en paralelo con su propia semilla derivada, así el
+// archivo depende solo de la semilla y no del número de hilos
+bool generarImagenPNM(const std::string& ruta, size_t ancho, size_t alto, size_t canales, uint64_t semilla) {
+    FormatoImagen formato;
+    formato.tipo = canales == 3 ? "P6" : "P5";
+    formato.ancho = ancho;
+    formato.alto = alto;
+    formato.canales = canales == 3 ? 3 : 1;
+    std::string cabecera = formato.cabecera();
+    formato.desplazamiento = cabecera.size();
+
+    int descriptor = open(ruta.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (descriptor < 0) return false;
+    bool correcto = pwrite(descriptor, cabecera.data(), cabecera.size(), 0) == static_cast<ssize_t>(cabecera.size());
+
+    const size_t filasBloque = 256;
+    VectorNuma<unsigned char> bloque(filasBloque * formato.bytesFila());
+    for (size_t i0 = 0; i0 < alto && correcto; i0 += filasBloque) {
+        size_t filas = std::min(filasBloque, alto - i0);
+        size_t bytes = filas * formato.bytesFila();
+        generarUniforme(Vista<unsigned char>(bloque.data(), bytes), 0, 255, semilla + i0 / filasBloque);
+        correcto = pwrite(descriptor, bloque.data(), bytes, static_cast<off_t>(formato.inicioFila(0, i0))) ==
+                   static_cast<ssize_t>(bytes);
+    }
+    close(descriptor);
+    return correcto;
+}
+#endif
+
+int main(int argc, char* argv[]) {
     const size_t ANCHO = 5000;
     const size_t ALTO = 5000;
-    ProcesadorImagenes procesador(ANCHO, ALTO);
-    procesador.ejecutar();
+    OpcionesMedicion opciones;
+    if (!extraerOpcionesMedicion(argc, argv, opciones)) return 1;
+#ifdef IMAGENES_POSIX
+    // Modo "flujo": filtra un PGM/PPM (o un raw planar si se indica su geometría)
+    // por franjas, sin cargar la imagen completa en memoria
+    //   flujo <entrada> <salida> [k] [filas_franja] [ancho alto canales bytes_por_muestra]
+    if (argc >= 4 && std::string(argv[1]) == "flujo") {
+        int k = argc > 4 ? std::atoi(argv[4]) : 3;
+        size_t filasFranja = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 256;
+        ProcesadorFlujo flujo(NucleoSeparable::caja(k), filasFranja);
+        if (argc <= 6) return flujo.ejecutar(argv[2], argv[3], nullptr) ? 0 : 1;
+        // La geometría raw va completa o no va
+        FormatoImagen raw;
+        if (argc == 10) {
+            raw.ancho = std::strtoull(argv[6], nullptr, 10);
+            raw.alto = std::strtoull(argv[7], nullptr, 10);
+            raw.canales = std::strtoull(argv[8], nullptr, 10);
+            raw.bytesPorMuestra = std::strtoull(argv[9], nullptr, 10);
+        }
+        if (argc != 10 || raw.ancho == 0 || raw.alto == 0 || raw.canales == 0 ||
+            (raw.bytesPorMuestra != 1 && raw.bytesPorMuestra != 2)) {
+            std::cerr << "Uso: " << argv[0] << " flujo <entrada> <salida> [k] [filas_franja]"
+                      << " [ancho alto canales bytes_por_muestra]" << std::endl;
+            std::cerr << "  ancho, alto y canales > 0; bytes_por_muestra 1 o 2" << std::endl;
+            return 1;
+        }
+        return flujo.ejecutar(argv[2], argv[3], &raw) ? 0 : 1;
+    }
+    // Modo "generar": crea un PGM/PPM aleatorio de 8 bits
+    //   generar <salida> <ancho> <alto> [canales]
+    if (argc >= 5 && std::string(argv[1]) == "generar") {
+        size_t canales = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 1;
+        return generarImagenPNM(argv[2], std::strtoull(argv[3], nullptr, 10),
+                                std::strtoull(argv[4], nullptr, 10), canales, opciones.semilla) ? 0 : 1;
+    }
+#endif
+    // Modo "precision": filtros con píxeles int, uint16_t y uint8_t
+    if (argc > 1 && std::string(argv[1]) == "precision") {
+        return compararPrecision(ANCHO, ALTO, opciones) ? 0 : 1;
+    }
+    // Los valores van de 0 a 255: un byte por píxel
+    ProcesadorImagenes<uint8_t> procesador(ANCHO, ALTO, opciones.semilla);
+    // Modo "disposicion": compara vector<vector<int>> con Matriz2D
+    if (argc > 1 && std::string(argv[1]) == "disposicion") {
+        procesador.compararDisposiciones();
+    } else if (argc > 1 && std::string(argv[1]) == "separable") {
+        // Modo "separable": recorre el motor de filtros con varios núcleos y tipos de píxel
+        procesador.compararFiltrosSeparables();
+    } else if (argc > 1 && std::string(argv[1]) == "tuberia") {
+        // Modo "tuberia": compara la tubería de filtros fusionada con la ejecución etapa por etapa
+        procesador.compararTuberia();
+    } else {
+        return procesador.ejecutar(opciones) ? 0 : 1;
+    }
     return 0;
 }
\ No newline at end of file
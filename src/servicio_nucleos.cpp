@@ -0,0 +1,590 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <omp.h>
+#include "medicion.h"
+#include "matriz2d.h"
+#include "nucleos/busqueda.h"
+#include "nucleos/generacion.h"
+#include "nucleos/imagenes.h"
+#include "nucleos/matrices.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define SERVICIO_POSIX 1
+#endif
+
+// Servicio persistente: construye una vez los datos de los ejemplos (el array de
+// la búsqueda con su índice, los operandos de la multiplicación y la imagen) y
+// atiende peticiones línea a línea por la entrada estándar o por un socket Unix.
+// Todas las regiones paralelas se abren desde el hilo despachador, así el equipo
+// de OpenMP se crea una sola vez y se reutiliza en todas las peticiones; las
+// peticiones pequeñas que llegan juntas se agrupan en un único lanzamiento paralelo
+
+using Reloj = std::chrono::steady_clock;
+
+// Clases de petición del protocolo (una línea por petición, una por respuesta)
+enum class ClasePeticion { Buscar, Contar, Ordenar, Filtrar, Producto, Multiplicar, Estadisticas, Apagar, Error };
+const size_t NUM_CLASES = 9;
+
+struct OrdenProtocolo {
+    const char* nombre;
+    ClasePeticion clase;
+    size_t minimoArgumentos, maximoArgumentos;
+};
+
+// Órdenes reconocidas y número de argumentos enteros que admite cada una
+const OrdenProtocolo ORDENES[] = {
+    {"buscar", ClasePeticion::Buscar, 1, 1},             // buscar <valor>
+    {"contar", ClasePeticion::Contar, 1, 1},             // contar <valor>
+    {"ordenar", ClasePeticion::Ordenar, 1, 1 << 20},     // ordenar <v1> <v2> ...
+    {"filtrar", ClasePeticion::Filtrar, 4, 5},           // filtrar <fila> <columna> <alto> <ancho> [k]
+    {"producto", ClasePeticion::Producto, 2, 2},         // producto <fila> <columna>
+    {"multiplicar", ClasePeticion::Multiplicar, 0, 0},
+    {"estadisticas", ClasePeticion::Estadisticas, 0, 0},
+    {"apagar", ClasePeticion::Apagar, 0, 0},
+};
+
+inline const char* nombreClase(ClasePeticion clase) {
+    for (const OrdenProtocolo& orden : ORDENES) {
+        if (orden.clase == clase) return orden.nombre;
+    }
+    return "error";
+}
+
+// Canal por el que llega una petición y se devuelve su respuesta: la salida
+// estándar o una conexión del socket. Solo escribe el despachador, que responde
+// las peticiones de cada canal en su orden de llegada; la conexión se cierra
+// cuando se han respondido todas sus peticiones y el lector la ha abandonado
+class Canal {
+private:
+    int descriptor;  // -1: salida estándar
+
+public:
+    explicit Canal(int d) : descriptor(d) {}
+    Canal(const Canal&) = delete;
+    Canal& operator=(const Canal&) = delete;
+
+    ~Canal() {
+#ifdef SERVICIO_POSIX
+        if (descriptor >= 0) close(descriptor);
+#endif
+    }
+
+    void responder(const std::string& texto) {
+        if (descriptor < 0) {
+            std::cout << texto << '\n' << std::flush;
+            return;
+        }
+#ifdef SERVICIO_POSIX
+        const std::string linea = texto + '\n';
+        size_t escrito = 0;
+        while (escrito < linea.size()) {
+            ssize_t n = write(descriptor, linea.data() + escrito, linea.size() - escrito);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;  // El cliente se ha ido: se descarta la respuesta
+            escrito += static_cast<size_t>(n);
+        }
+#endif
+    }
+};
+
+struct Peticion {
+    ClasePeticion clase = ClasePeticion::Error;
+    std::vector<long long> argumentos;
+    std::shared_ptr<Canal> canal;
+    Reloj::time_point llegada;
+    std::string respuesta;
+};
+
+// Latencias (desde la llegada hasta la respuesta) y tiempo de cómputo de una clase
+struct EstadisticasClase {
+    std::vector<double> latencias;  // Microsegundos
+    size_t lotes = 0;
+    double segundosComputo = 0.0;
+};
+
+// Interpreta una línea del protocolo. Las órdenes desconocidas o con argumentos
+// no válidos quedan como ClasePeticion::Error con la respuesta ya escrita
+inline Peticion interpretarLinea(const std::string& linea) {
+    Peticion peticion;
+    std::istringstream entrada(linea);
+    std::string nombre, palabra;
+    entrada >> nombre;
+    const OrdenProtocolo* orden = nullptr;
+    for (const OrdenProtocolo& candidata : ORDENES) {
+        if (nombre == candidata.nombre) orden = &candidata;
+    }
+    if (!orden) {
+        peticion.respuesta = "error orden desconocida: " + nombre;
+        return peticion;
+    }
+    while (entrada >> palabra) {
+        char* fin = nullptr;
+        errno = 0;
+        long long valor = std::strtoll(palabra.c_str(), &fin, 10);
+        if (*fin != '\0' || errno == ERANGE) {
+            peticion.respuesta = "error argumento no válido: " + palabra;
+            return peticion;
+        }
+        peticion.argumentos.push_back(valor);
+    }
+    if (peticion.argumentos.size() < orden->minimoArgumentos ||
+        peticion.argumentos.size() > orden->maximoArgumentos) {
+        peticion.respuesta = std::string("error número de argumentos no válido para ") + orden->nombre;
+        return peticion;
+    }
+    // Los valores buscados se comparan con el array de int
+    if (orden->clase == ClasePeticion::Buscar || orden->clase == ClasePeticion::Contar) {
+        const long long valor = peticion.argumentos[0];
+        if (valor < std::numeric_limits<int>::min() || valor > std::numeric_limits<int>::max()) {
+            peticion.respuesta = "error valor fuera del rango de int";
+            return peticion;
+        }
+    }
+    peticion.clase = orden->clase;
+    return peticion;
+}
+
+class ServicioNucleos {
+private:
+    // Datos residentes
+    VectorNuma<int> array;   // Sin inicializar: la primera escritura es la del generador
+    IndiceEytzinger indice;
+    Matriz2D<double> matrizA, matrizB, resultado;
+    Matriz2D<uint8_t> imagen;
+
+    // Cola de peticiones pendientes, compartida entre los lectores y el despachador
+    std::mutex mutexCola;
+    std::condition_variable hayPeticiones;
+    std::deque<Peticion> cola;
+    bool terminado = false;
+
+    // Agrupación: el despachador espera hasta 'ventana' desde la llegada de la
+    // primera petición pendiente, o hasta reunir 'loteMaximo' peticiones
+    std::chrono::microseconds ventana;
+    size_t loteMaximo;
+
+    EstadisticasClase estadisticas[NUM_CLASES];
+    Reloj::time_point inicio;
+
+    // Búsquedas: los grupos de GRUPO_INTERCALADO consultas se reparten entre los
+    // hilos y dentro de cada grupo las búsquedas en el índice se intercalan
+    void atenderBuscar(const std::vector<Peticion*>& lote) {
+        const size_t n = lote.size();
+        std::vector<int> objetivos(n), resultados(n);
+        for (size_t q = 0; q < n; ++q) objetivos[q] = static_cast<int>(lote[q]->argumentos[0]);
+        const size_t numGrupos = (n + GRUPO_INTERCALADO - 1) / GRUPO_INTERCALADO;
+        // Justificación: Las consultas son independientes y de coste similar; un
+        // único grupo no compensa despertar al equipo
+        #pragma omp parallel for schedule(static) if(numGrupos > 1)
+        for (size_t grupo = 0; grupo < numGrupos; ++grupo) {
+            const size_t primera = grupo * GRUPO_INTERCALADO;
+            indice.buscarGrupo(objetivos.data() + primera, std::min(GRUPO_INTERCALADO, n - primera),
+                               resultados.data() + primera);
+        }
+        for (size_t q = 0; q < n; ++q) lote[q]->respuesta = std::to_string(resultados[q]);
+    }
+
+    // Conteos: todos los valores del lote se cuentan en una sola pasada por el array
+    void atenderContar(const std::vector<Peticion*>& lote) {
+        const size_t n = lote.size();
+        std::vector<int> objetivos(n);
+        std::vector<size_t> cuentas(n);
+        for (size_t q = 0; q < n; ++q) objetivos[q] = static_cast<int>(lote[q]->argumentos[0]);
+        contarVarios(vista(array), objetivos, cuentas);
+        for (size_t q = 0; q < n; ++q) lote[q]->respuesta = std::to_string(cuentas[q]);
+    }
+
+    // Ordenaciones pequeñas: cada una es secuencial y el lote se reparte entre los hilos
+    void atenderOrdenar(const std::vector<Peticion*>& lote) {
+        const size_t n = lote.size();
+        // Justificación: Los tamaños varían de una petición a otra; schedule(dynamic)
+        // equilibra la carga
+        #pragma omp parallel for schedule(dynamic) if(n > 1)
+        for (size_t q = 0; q < n; ++q) {
+            std::vector<long long>& valores = lote[q]->argumentos;
+            std::sort(valores.begin(), valores.end());
+            std::string texto;
+            for (size_t i = 0; i < valores.size(); ++i) {
+                if (i > 0) texto += ' ';
+                texto += std::to_string(valores[i]);
+            }
+            lote[q]->respuesta = std::move(texto);
+        }
+    }
+
+    // Tiles del filtro de caja k x k: cada uno se filtra sobre la sub-imagen que
+    // forma con su halo y se responde la suma de sus píxeles filtrados. Los tiles
+    // pueden solaparse, así que cada hilo escribe en su propio buffer
+    void atenderFiltrar(const std::vector<Peticion*>& lote) {
+        const size_t n = lote.size();
+        const size_t alto = imagen.filas(), ancho = imagen.columnas();
+        // Justificación: Los tiles tienen tamaños distintos; schedule(dynamic) equilibra la carga
+        #pragma omp parallel if(n > 1)
+        {
+            std::vector<uint32_t> sumas, prefijo;
+            std::vector<uint8_t> buffer;
+            #pragma omp for schedule(dynamic)
+            for (size_t q = 0; q < n; ++q) {
+                const std::vector<long long>& a = lote[q]->argumentos;
+                const int k = a.size() > 4 ? static_cast<int>(std::min<long long>(a[4], 2 * RADIO_MAXIMO + 1)) : 3;
+                if (a[0] < 0 || a[1] < 0 || a[2] <= 0 || a[3] <= 0 || k <= 0 ||
+                    static_cast<size_t>(a[0]) >= alto || static_cast<size_t>(a[1]) >= ancho ||
+                    static_cast<size_t>(a[2]) > alto - static_cast<size_t>(a[0]) ||
+                    static_cast<size_t>(a[3]) > ancho - static_cast<size_t>(a[1])) {
+                    lote[q]->respuesta = "error tile fuera de la imagen";
+                    continue;
+                }
+                const size_t fila = a[0], columna = a[1], filasTile = a[2], columnasTile = a[3];
+                const size_t radio = static_cast<size_t>(NucleoSeparable::caja(k).radio);
+                const size_t fa = fila > radio ? fila - radio : 0;
+                const size_t fb = std::min(fila + filasTile + radio, alto);
+                const size_t ca = columna > radio ? columna - radio : 0;
+                const size_t cb = std::min(columna + columnasTile + radio, ancho);
+                buffer.resize((fb - fa) * (cb - ca));
+                sumas.resize(cb - ca);
+                prefijo.resize(cb - ca + 1);
+                VistaTile<uint8_t> salida{buffer.data(), fb - fa, cb - ca, cb - ca};
+                filtrarTileCaja<uint8_t>(imagen.tile(fa, ca, fb - fa, cb - ca), salida, fila - fa,
+                                         fila - fa + filasTile, columna - ca, columna - ca + columnasTile,
+                                         radio, sumas, prefijo);
+                uint64_t suma = 0;
+                for (size_t i = fila - fa; i < fila - fa + filasTile; ++i) {
+                    for (size_t j = columna - ca; j < columna - ca + columnasTile; ++j) {
+                        suma += salida[i][j];
+                    }
+                }
+                lote[q]->respuesta = std::to_string(suma);
+            }
+        }
+    }
+
+    // Elementos sueltos del producto A*B (fila de A por columna de B)
+    void atenderProducto(const std::vector<Peticion*>& lote) {
+        const size_t n = lote.size();
+        const size_t dimension = matrizA.filas();
+        // Justificación: Los elementos son independientes y de coste similar
+        #pragma omp parallel for schedule(static) if(n > 1)
+        for (size_t q = 0; q < n; ++q) {
+            const long long i = lote[q]->argumentos[0], j = lote[q]->argumentos[1];
+            if (i < 0 || j < 0 || static_cast<size_t>(i) >= dimension || static_cast<size_t>(j) >= dimension) {
+                lote[q]->respuesta = "error índice fuera de la matriz";
+                continue;
+            }
+            double suma = 0.0;
+            for (size_t k = 0; k < dimension; ++k) {
+                suma += matrizA[i][k] * matrizB[k][j];
+            }
+            std::ostringstream texto;
+            texto << std::setprecision(17) << suma;
+            lote[q]->respuesta = texto.str();
+        }
+    }
+
+    // Producto completo: los operandos no cambian, así que todas las peticiones
+    // del lote comparten una única multiplicación; se responde la suma de C
+    void atenderMultiplicar(const std::vector<Peticion*>& lote) {
+        multiplicarBloques<double>(matrizA.vista(), matrizB.vista(), resultado.vista());
+        double suma = 0.0;
+        // Justificación: Reducción por filas con el mismo reparto que el producto
+        #pragma omp parallel for reduction(+:suma) schedule(static)
+        for (size_t i = 0; i < resultado.filas(); ++i) {
+            for (size_t j = 0; j < resultado.columnas(); ++j) {
+                suma += resultado[i][j];
+            }
+        }
+        std::ostringstream texto;
+        texto << std::setprecision(17) << suma;
+        for (Peticion* peticion : lote) peticion->respuesta = texto.str();
+    }
+
+    // Atiende un lote extraído de la cola: agrupa las peticiones por clase, lanza
+    // un único núcleo paralelo por clase y responde en el orden de llegada
+    void atenderLote(std::vector<Peticion>& lote) {
+        std::vector<Peticion*> porClase[NUM_CLASES];
+        for (Peticion& peticion : lote) {
+            porClase[static_cast<size_t>(peticion.clase)].push_back(&peticion);
+        }
+        for (size_t c = 0; c < NUM_CLASES; ++c) {
+            const std::vector<Peticion*>& grupo = porClase[c];
+            if (grupo.empty()) continue;
+            auto t0 = Reloj::now();
+            switch (static_cast<ClasePeticion>(c)) {
+                case ClasePeticion::Buscar: atenderBuscar(grupo); break;
+                case ClasePeticion::Contar: atenderContar(grupo); break;
+                case ClasePeticion::Ordenar: atenderOrdenar(grupo); break;
+                case ClasePeticion::Filtrar: atenderFiltrar(grupo); break;
+                case ClasePeticion::Producto: atenderProducto(grupo); break;
+                case ClasePeticion::Multiplicar: atenderMultiplicar(grupo); break;
+                case ClasePeticion::Apagar:
+                    for (Peticion* peticion : grupo) peticion->respuesta = "ok";
+                    detener();
+                    break;
+                default: break;  // Estadísticas se responden al escribir; los errores ya traen respuesta
+            }
+            estadisticas[c].lotes += 1;
+            estadisticas[c].segundosComputo += std::chrono::duration<double>(Reloj::now() - t0).count();
+        }
+        for (Peticion& peticion : lote) {
+            if (peticion.clase == ClasePeticion::Estadisticas) peticion.respuesta = informe();
+            peticion.canal->responder(peticion.respuesta);
+            double latencia = std::chrono::duration<double, std::micro>(Reloj::now() - peticion.llegada).count();
+            estadisticas[static_cast<size_t>(peticion.clase)].latencias.push_back(latencia);
+        }
+    }
+
+public:
+    // Construye los datos residentes a partir de la semilla, con los mismos
+    // generadores que busqueda_paralela, multiplicacion_matrices y procesamiento_imagenes
+    ServicioNucleos(size_t elementos, size_t dimension, size_t ancho, size_t alto, uint64_t semilla,
+                    std::chrono::microseconds v, size_t l)
+        : array(elementos), matrizA(dimension, dimension), matrizB(dimension, dimension),
+          resultado(dimension, dimension, 0.0), imagen(alto, ancho), ventana(v), loteMaximo(l) {
+        auto t0 = Reloj::now();
+        generarUniforme(vista(array), 1, 100000000, semilla);
+        indice.construir(array);
+        generarUniforme(matrizA.vista(), 0.0, 1.0, semilla);
+        generarUniforme(matrizB.vista(), 0.0, 1.0, semilla + 1);
+        generarUniforme(imagen.vista(), 0, 255, semilla);
+        double segundos = std::chrono::duration<double>(Reloj::now() - t0).count();
+        std::cerr << "Datos residentes: array de " << elementos << " int con índice de Eytzinger, matrices "
+                  << dimension << "x" << dimension << ", imagen " << ancho << "x" << alto << " ("
+                  << segundos << " s, " << omp_get_max_threads() << " hilos)" << std::endl;
+        inicio = Reloj::now();
+    }
+
+    // Encola una línea recibida por canal. Devuelve false si el lector debe dejar
+    // de leer: el cliente cierra su canal ("salir"), pide apagar el servicio o
+    // el servicio ya se está deteniendo
+    bool recibir(std::string linea, const std::shared_ptr<Canal>& canal) {
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (linea.find_first_not_of(" \t") == std::string::npos) return true;
+        if (linea == "salir") return false;
+        Peticion peticion = interpretarLinea(linea);
+        const bool apagar = peticion.clase == ClasePeticion::Apagar;
+        peticion.canal = canal;
+        peticion.llegada = Reloj::now();
+        {
+            std::lock_guard<std::mutex> cerrojo(mutexCola);
+            if (terminado) return false;
+            cola.push_back(std::move(peticion));
+        }
+        hayPeticiones.notify_one();
+        return !apagar;
+    }
+
+    // Deja de aceptar peticiones; el despachador atiende las pendientes y termina
+    void detener() {
+        {
+            std::lock_guard<std::mutex> cerrojo(mutexCola);
+            terminado = true;
+        }
+        hayPeticiones.notify_all();
+    }
+
+    bool detenido() {
+        std::lock_guard<std::mutex> cerrojo(mutexCola);
+        return terminado;
+    }
+
+    // Bucle del despachador; debe ejecutarlo siempre el mismo hilo para que el
+    // runtime reutilice su equipo de hilos en cada región paralela
+    void despachar() {
+        std::unique_lock<std::mutex> cerrojo(mutexCola);
+        while (true) {
+            hayPeticiones.wait(cerrojo, [&] { return !cola.empty() || terminado; });
+            if (cola.empty()) break;
+            // Ventana de agrupación: da tiempo a que lleguen más peticiones
+            // pequeñas para lanzarlas juntas
+            const Reloj::time_point limite = cola.front().llegada + ventana;
+            hayPeticiones.wait_until(cerrojo, limite, [&] { return cola.size() >= loteMaximo || terminado; });
+            const size_t n = std::min(cola.size(), loteMaximo);
+            std::vector<Peticion> lote(std::make_move_iterator(cola.begin()),
+                                       std::make_move_iterator(cola.begin() + n));
+            cola.erase(cola.begin(), cola.begin() + n);
+            cerrojo.unlock();
+            atenderLote(lote);
+            cerrojo.lock();
+        }
+    }
+
+    // Tabla por clase de petición: número, lotes, tamaño medio del lote, latencia
+    // (mediana, p95 y máxima, en microsegundos) y rendimiento sobre el tiempo de cómputo
+    std::string informe() const {
+        std::ostringstream texto;
+        texto << std::fixed << std::setprecision(1);
+        texto << std::left << std::setw(14) << "clase" << std::right << std::setw(11) << "peticiones"
+              << std::setw(8) << "lotes" << std::setw(11) << "media/lote" << std::setw(13) << "mediana(us)"
+              << std::setw(11) << "p95(us)" << std::setw(11) << "max(us)" << std::setw(13) << "peticiones/s" << "\n";
+        for (size_t c = 0; c < NUM_CLASES; ++c) {
+            const EstadisticasClase& e = estadisticas[c];
+            if (e.latencias.empty()) continue;
+            EstadisticasTiempo t = calcularEstadisticas(e.latencias);
+            const double porSegundo = e.segundosComputo > 0.0 ? e.latencias.size() / e.segundosComputo : 0.0;
+            texto << std::left << std::setw(14) << nombreClase(static_cast<ClasePeticion>(c)) << std::right
+                  << std::setw(11) << e.latencias.size() << std::setw(8) << e.lotes << std::setw(11)
+                  << (e.lotes > 0 ? static_cast<double>(e.latencias.size()) / e.lotes : 0.0) << std::setw(13)
+                  << t.mediana << std::setw(11) << t.p95 << std::setw(11) << t.maximo << std::setw(13)
+                  << porSegundo << "\n";
+        }
+        texto << std::setprecision(3) << "tiempo en servicio: "
+              << std::chrono::duration<double>(Reloj::now() - inicio).count()
+              << " s\nfin";
+        return texto.str();
+    }
+};
+
+// Lee peticiones de la entrada estándar; al cerrarse (o con "salir") el servicio
+// termina después de responder las pendientes
+void leerEntradaEstandar(ServicioNucleos& servicio) {
+    auto canal = std::make_shared<Canal>(-1);
+    std::string linea;
+    while (std::getline(std::cin, linea)) {
+        if (!servicio.recibir(linea, canal)) break;
+    }
+    servicio.detener();
+}
+
+#ifdef SERVICIO_POSIX
+// Lee las peticiones de una conexión hasta que el cliente la cierra o envía "salir"
+void leerConexion(ServicioNucleos& servicio, int descriptor) {
+    auto canal = std::make_shared<Canal>(descriptor);
+    std::string pendiente;
+    char buffer[4096];
+    bool abierta = true;
+    while (abierta) {
+        ssize_t n = read(descriptor, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        pendiente.append(buffer, static_cast<size_t>(n));
+        size_t salto;
+        while (abierta && (salto = pendiente.find('\n')) != std::string::npos) {
+            abierta = servicio.recibir(pendiente.substr(0, salto), canal);
+            pendiente.erase(0, salto + 1);
+        }
+    }
+}
+
+// Acepta conexiones en el socket y lanza un lector por conexión hasta que se detiene el servicio
+void aceptarConexiones(ServicioNucleos& servicio, int servidor) {
+    while (true) {
+        int cliente = accept(servidor, nullptr, nullptr);
+        if (cliente < 0) {
+            if (errno == EINTR && !servicio.detenido()) continue;
+            break;
+        }
+        std::thread(leerConexion, std::ref(servicio), cliente).detach();
+    }
+}
+
+// Crea el socket de escucha en ruta; devuelve -1 (con el error en cerr) si no es posible
+int abrirSocket(const std::string& ruta) {
+    sockaddr_un direccion{};
+    if (ruta.size() >= sizeof(direccion.sun_path)) {
+        std::cerr << "Ruta de socket demasiado larga: " << ruta << std::endl;
+        return -1;
+    }
+    direccion.sun_family = AF_UNIX;
+    std::memcpy(direccion.sun_path, ruta.c_str(), ruta.size() + 1);
+    int servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor < 0) {
+        std::cerr << "No se puede crear el socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    unlink(ruta.c_str());
+    if (bind(servidor, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) < 0 || listen(servidor, 64) < 0) {
+        std::cerr << "No se puede escuchar en " << ruta << ": " << std::strerror(errno) << std::endl;
+        close(servidor);
+        return -1;
+    }
+    return servidor;
+}
+#endif
+
+int main(int argc, char* argv[]) {
+    OpcionesMedicion opciones;
+    if (!extraerOpcionesMedicion(argc, argv, opciones)) return 1;
+    // Tamaños por defecto: los de busqueda_paralela, multiplicacion_matrices y procesamiento_imagenes
+    size_t elementos = 100000000, dimension = 1000, ancho = 5000, alto = 5000;
+    long long ventanaUs = 200;
+    size_t loteMaximo = 4096;
+    std::string rutaSocket;
+    const char* uso = " [--socket ruta] [--ventana us] [--lote n] [--elementos n] [--dimension n]"
+                      " [--imagen ancho alto] [--semilla n]";
+    for (int i = 1; i < argc; ++i) {
+        std::string opcion = argv[i];
+        int valores = opcion == "--imagen" ? 2 : 1;
+        bool conocida = opcion == "--socket" || opcion == "--ventana" || opcion == "--lote" ||
+                        opcion == "--elementos" || opcion == "--dimension" || opcion == "--imagen";
+        if (!conocida || i + valores >= argc) {
+            std::cerr << "Uso: " << argv[0] << uso << std::endl;
+            return 1;
+        }
+        if (opcion == "--socket") rutaSocket = argv[++i];
+        else if (opcion == "--ventana") ventanaUs = std::atoll(argv[++i]);
+        else if (opcion == "--lote") loteMaximo = std::strtoull(argv[++i], nullptr, 10);
+        else if (opcion == "--elementos") elementos = std::strtoull(argv[++i], nullptr, 10);
+        else if (opcion == "--dimension") dimension = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            ancho = std::strtoull(argv[++i], nullptr, 10);
+            alto = std::strtoull(argv[++i], nullptr, 10);
+        }
+    }
+    if (elementos == 0 || elementos >= MAX_ELEMENTOS_INDICE || dimension == 0 || ancho == 0 || alto == 0 ||
+        loteMaximo == 0 || ventanaUs < 0) {
+        std::cerr << "Uso: " << argv[0] << uso << std::endl;
+        return 1;
+    }
+
+    ServicioNucleos servicio(elementos, dimension, ancho, alto, opciones.semilla,
+                             std::chrono::microseconds(ventanaUs), loteMaximo);
+
+    if (rutaSocket.empty()) {
+        std::thread lector(leerEntradaEstandar, std::ref(servicio));
+        servicio.despachar();
+        lector.join();
+    } else {
+#ifdef SERVICIO_POSIX
+        // Un cliente que cierra antes de leer su respuesta no debe terminar el servicio
+        std::signal(SIGPIPE, SIG_IGN);
+        int servidor = abrirSocket(rutaSocket);
+        if (servidor < 0) return 1;
+        std::cerr << "Escuchando en " << rutaSocket << std::endl;
+        std::thread aceptador(aceptarConexiones, std::ref(servicio), servidor);
+        servicio.despachar();
+        // shutdown desbloquea el accept pendiente
+        shutdown(servidor, SHUT_RDWR);
+        aceptador.join();
+        close(servidor);
+        unlink(rutaSocket.c_str());
+        // Los lectores de las conexiones que siguen abiertas están bloqueados en
+        // read y usan el servicio: se termina sin destruirlo
+        std::cerr << servicio.informe() << std::endl;
+        std::exit(0);
+#else
+        std::cerr << "--socket solo está disponible en sistemas POSIX" << std::endl;
+        return 1;
+#endif
+    }
+    std::cerr << servicio.informe() << std::endl;
+    return 0;
+}
@@ -1,19 +1,29 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
 #include <random>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <memory>
 #include <omp.h>
+#include "medicion.h"
+#include "nucleos/montecarlo.h"
 
 class SimuladorMonteCarlo {
 private:
     long long numPuntos;
+    uint64_t semilla;   // Semilla de la versión reproducible con Philox
     std::mt19937 gen;
     std::uniform_real_distribution<> dis;
 
 public:
     // Constructor: inicializa el generador de números aleatorios
-    SimuladorMonteCarlo(long long puntos) : numPuntos(puntos), gen(std::random_device{}()), dis(-1.0, 1.0) {}
+    SimuladorMonteCarlo(long long puntos, uint64_t s = 2024)
+        : numPuntos(puntos), semilla(s), gen(std::random_device{}()), dis(-1.0, 1.0) {}
 
     // Método secuencial para estimar Pi
     double simularSecuencial() {
@@ -65,26 +75,86 @@ public:
         return 4.0 * dentroCirculo / numPuntos;
     }
 
-    // Método para ejecutar y comparar las versiones secuencial y paralela
-    void ejecutar() {
-        std::cout << std::fixed << std::setprecision(10);
-
-        // Ejecución y medición del tiempo para la versión secuencial
-        auto inicio = std::chrono::high_resolution_clock::now();
-        double piSecuencial = simularSecuencial();
-        auto fin = std::chrono::high_resolution_clock::now();
-        auto duracionSecuencial = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
+    // Método paralelo con Philox: el núcleo de la biblioteca cuenta los puntos por
+    // bloques con subflujos independientes, así la estimación es idéntica bit a
+    // bit con cualquier número de hilos
+    double simularParaleloPhilox(uint64_t semilla, int numHilos) {
+        long long dentroCirculo = contarDentroCirculoPhilox(numPuntos, semilla, numHilos);
+        return 4.0 * dentroCirculo / numPuntos;
+    }
 
-        // Ejecución y medición del tiempo para la versión paralela
-        inicio = std::chrono::high_resolution_clock::now();
-        double piParalelo = simularParalelo();
-        fin = std::chrono::high_resolution_clock::now();
-        auto duracionParalelo = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio).count();
+    // Compara las técnicas de muestreo del integrador en dos integrales de valor
+    // conocido: muestras necesarias para alcanzar el error estándar objetivo
+    void compararMuestreos(double errorObjetivo) {
+        const long long MAX_EVALUACIONES = 500000000LL;
+        const char* nombres[] = {"simple         ", "antitético     ", "estratificado  ", "Sobol          "};
+        const MetodoMuestreo metodos[] = {MetodoMuestreo::Simple, MetodoMuestreo::Antitetico,
+                                          MetodoMuestreo::Estratificado, MetodoMuestreo::Sobol};
+
+        // Pi como cuatro veces el área del cuarto de círculo en [0,1]^2 (integrando
+        // discontinuo, 2-D). El círculo completo en [-1,1]^2 es simétrico bajo
+        // u -> 1-u y anularía la ventaja del muestreo antitético
+        const double minimo2[2] = {0.0, 0.0}, maximo2[2] = {1.0, 1.0};
+        IntegradorMonteCarlo<2> integrador2(minimo2, maximo2, semilla);
+        auto circulo = [](const double* x) { return x[0] * x[0] + x[1] * x[1] <= 1.0 ? 4.0 : 0.0; };
+
+        // Gaussiana en [0,1]^5: (sqrt(pi)/2 * erf(1))^5 (integrando suave, 5-D)
+        const double minimo5[5] = {0, 0, 0, 0, 0}, maximo5[5] = {1, 1, 1, 1, 1};
+        IntegradorMonteCarlo<5> integrador5(minimo5, maximo5, semilla);
+        auto gaussiana = [](const double* x) {
+            return std::exp(-(x[0] * x[0] + x[1] * x[1] + x[2] * x[2] + x[3] * x[3] + x[4] * x[4]));
+        };
+        const double valorGaussiana = std::pow(std::sqrt(M_PI) / 2.0 * std::erf(1.0), 5);
+
+        std::cout << "Error estándar objetivo: " << std::scientific << std::setprecision(2) << errorObjetivo << std::endl;
+        for (int integral = 0; integral < 2; ++integral) {
+            std::cout << std::endl << (integral == 0 ? "Pi (cuarto de círculo, 2-D):" : "Gaussiana en [0,1]^5:") << std::endl;
+            for (int m = 0; m < 4; ++m) {
+                auto inicio = std::chrono::high_resolution_clock::now();
+                ResultadoIntegracion r = integral == 0
+                    ? integrador2.integrar(circulo, metodos[m], errorObjetivo, MAX_EVALUACIONES)
+                    : integrador5.integrar(gaussiana, metodos[m], errorObjetivo, MAX_EVALUACIONES);
+                auto fin = std::chrono::high_resolution_clock::now();
+                double ms = std::chrono::duration<double, std::milli>(fin - inicio).count();
+                double exacto = integral == 0 ? M_PI : valorGaussiana;
+                std::cout << "  " << nombres[m] << std::fixed << std::setprecision(10) << r.estimacion
+                          << std::scientific << std::setprecision(2)
+                          << "  error estándar " << r.errorEstandar
+                          << "  error real " << std::abs(r.estimacion - exacto)
+                          << "  evaluaciones " << r.evaluaciones
+                          << std::fixed << std::setprecision(1) << "  " << ms << " ms"
+                          << (r.convergio ? "" : "  (sin converger)") << std::endl;
+            }
+        }
+    }
 
-        double piReal = M_PI;
+    // Mide las versiones secuencial, paralela (mt19937) y Philox con el arnés
+    // común; con --barrido añade el escalado fuerte y el débil (puntos
+    // proporcionales a los hilos, con Philox)
+    bool ejecutar(const OpcionesMedicion& opciones) {
+        double piSecuencial = 0.0, piParalelo = 0.0, piPhilox = 0.0;
+        const uint64_t s = semilla;
+        ArnesMedicion arnes("simulacion_montecarlo", opciones);
+        arnes.registrar("secuencial", numPuntos, [&] { piSecuencial = simularSecuencial(); });
+        arnes.registrarParalelo("paralelo mt19937", numPuntos, [&] { piParalelo = simularParalelo(); });
+        arnes.registrarParalelo("paralelo Philox", numPuntos,
+                                [&] { piPhilox = simularParaleloPhilox(s, omp_get_max_threads()); });
+        const long long porHilo = std::max<long long>(numPuntos / omp_get_max_threads(), 1);
+        arnes.registrarEscaladoDebil("paralelo Philox", porHilo, [porHilo, s](int hilos) {
+            auto simulador = std::make_shared<SimuladorMonteCarlo>(porHilo * hilos, s);
+            return [simulador, s, hilos] { simulador->simularParaleloPhilox(s, hilos); };
+        });
+
+        // Sin tráfico de memoria; x*x + y*y por punto (sin contar el generador)
+        for (const char* caso : {"secuencial", "paralelo mt19937", "paralelo Philox"}) {
+            arnes.asignarCarga(caso, 0.0, 3.0 * numPuntos);
+        }
 
-        // Impresión de resultados
         std::cout << "Número de puntos: " << numPuntos << std::endl;
+        bool escrito = arnes.ejecutar();
+
+        double piReal = M_PI;
+        std::cout << std::fixed << std::setprecision(10);
         std::cout << "Valor real de Pi: " << piReal << std::endl;
         std::cout << std::endl;
 
@@ -92,24 +162,57 @@ public:
         std::cout << "Pi estimado: " << piSecuencial << std::endl;
         std::cout << "Error absoluto: " << std::abs(piSecuencial - piReal) << std::endl;
         std::cout << "Error relativo: " << std::abs(piSecuencial - piReal) / piReal * 100 << "%" << std::endl;
-        std::cout << "Tiempo de ejecución: " << duracionSecuencial << " ms" << std::endl;
         std::cout << std::endl;
 
         std::cout << "Resultado paralelo:" << std::endl;
         std::cout << "Pi estimado: " << piParalelo << std::endl;
         std::cout << "Error absoluto: " << std::abs(piParalelo - piReal) << std::endl;
         std::cout << "Error relativo: " << std::abs(piParalelo - piReal) / piReal * 100 << "%" << std::endl;
-        std::cout << "Tiempo de ejecución: " << duracionParalelo << " ms" << std::endl;
         std::cout << std::endl;
 
-        // Cálculo y muestra de la aceleración obtenida con la versión paralela
-        std::cout << "Aceleración: " << static_cast<double>(duracionSecuencial) / duracionParalelo << "x" << std::endl;
+        // Versión reproducible con Philox: con todos los hilos y con uno solo
+        const int hilos = omp_get_max_threads();
+        double piPhiloxUnHilo = simularParaleloPhilox(semilla, 1);
+        double msPhilox = arnes.mediana("paralelo Philox");
+        double msParalelo = arnes.mediana("paralelo mt19937");
+        std::cout << "Resultado paralelo (Philox4x32-10, semilla " << semilla << "):" << std::endl;
+        std::cout << "Pi estimado: " << piPhilox << std::endl;
+        std::cout << "Error absoluto: " << std::abs(piPhilox - piReal) << std::endl;
+        std::cout << std::setprecision(1);
+        std::cout << "Rendimiento (mediana): " << cocienteTiempos(numPuntos / 1e6, msPhilox / 1e3) << " Mpuntos/s (mt19937: "
+                  << cocienteTiempos(numPuntos / 1e6, msParalelo / 1e3) << " Mpuntos/s)" << std::endl;
+        std::cout << "Idéntico con 1 y " << hilos << " hilos: " << (piPhilox == piPhiloxUnHilo ? "Sí" : "No") << std::endl;
+        std::cout << std::defaultfloat;
+        return escrito;
     }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     const long long NUM_PUNTOS = 1000000000;
-    SimuladorMonteCarlo simulador(NUM_PUNTOS);
-    simulador.ejecutar();
-    return 0;
+    OpcionesMedicion opciones;
+    if (!extraerOpcionesMedicion(argc, argv, opciones)) return 1;
+
+    // La semilla se toma de --semilla; el argumento posicional de versiones
+    // anteriores se admite como alias obsoleto y la sustituye, así el JSON
+    // registra siempre la semilla usada
+    auto semillaPosicional = [&](int indice) {
+        if (argc > indice) {
+            opciones.semilla = std::strtoull(argv[indice], nullptr, 10);
+            std::cerr << "Aviso: la semilla posicional está obsoleta; use --semilla " << opciones.semilla << std::endl;
+        }
+    };
+
+    // Modo "integrar": compara las técnicas de muestreo del integrador general
+    //   integrar [error_objetivo] [semilla]
+    if (argc > 1 && std::string(argv[1]) == "integrar") {
+        double errorObjetivo = argc > 2 ? std::strtod(argv[2], nullptr) : 1e-4;
+        semillaPosicional(3);
+        SimuladorMonteCarlo simulador(NUM_PUNTOS, opciones.semilla);
+        simulador.compararMuestreos(errorObjetivo);
+        return 0;
+    }
+
+    semillaPosicional(1);
+    SimuladorMonteCarlo simulador(NUM_PUNTOS, opciones.semilla);
+    return simulador.ejecutar(opciones) ? 0 : 1;
 }
\ No newline at end of file
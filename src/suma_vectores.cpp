@@ -1,27 +1,48 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <algorithm>
+#include <memory>
 #include <omp.h>
+#include "ajuste.h"
+#include "medicion.h"
+#include "nucleos/generacion.h"
+#include "nucleos/vectores.h"
 
+// Repeticiones de cada medición de ancho de banda; como en STREAM se toma la mejor
+const int REPETICIONES_ANCHO_BANDA = 5;
+
+// T es el tipo de elemento (double o float): con float cada kernel mueve la
+// mitad de bytes; las reducciones acumulan en double igualmente (AcumuladorDe)
+template <typename T>
 class SumadorVectores {
 private:
-    std::vector<double> vectorA;
-    std::vector<double> vectorB;
-    std::vector<double> resultado;
+    // Sin inicializar al reservar: la primera escritura es la del generador
+    // paralelo, así cada página queda en el nodo del hilo que la procesa
+    VectorNuma<T> vectorA;
+    VectorNuma<T> vectorB;
+    VectorNuma<T> resultado;
     size_t tamano;
 
-    // Inicializa un vector con valores aleatorios
-    void inicializarVector(std::vector<double>& vec) {
-        for (auto& elemento : vec) {
-            elemento = static_cast<double>(rand()) / RAND_MAX;
-        }
-    }
-
 public:
-    // Constructor: inicializa los vectores con un tamaño dado
-    SumadorVectores(size_t t) : tamano(t), vectorA(t), vectorB(t), resultado(t) {
-        inicializarVector(vectorA);
-        inicializarVector(vectorB);
+    // Constructor: genera a y b uniformes en [0, 1) a partir de la semilla
+    // (b con la siguiente, para que sean independientes). Con float los valores
+    // son los de double redondeados
+    SumadorVectores(size_t t, uint64_t semilla) : vectorA(t), vectorB(t), resultado(t), tamano(t) {
+        generarUniforme(vista(vectorA), 0.0, 1.0, semilla);
+        generarUniforme(vista(vectorB), 0.0, 1.0, semilla + 1);
+        // Justificación: Primera escritura del resultado con el mismo reparto
+        // estático que la suma paralela, antes de que la secuencial lo toque
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < tamano; ++i) {
+            resultado[i] = T(0);
+        }
     }
 
     // Realiza la suma de vectores de forma secuencial
@@ -31,50 +52,303 @@ public:
         }
     }
 
-    // Realiza la suma de vectores de forma paralela
-    void sumarParalelo() {
-        // Usamos #pragma omp parallel for para paralelizar el bucle
-        // Justificación: Cada iteración del bucle es independiente,
-        // lo que permite una paralelización sencilla y eficiente
-        #pragma omp parallel for
+    // Realiza la suma de vectores de forma paralela. Cada iteración es
+    // independiente; asignar reparte el bucle con parallel for y, como el
+    // resultado no cabe en caché, lo escribe con stores no temporales
+    void sumarParalelo(const ConfiguracionParalela& configuracion = ConfiguracionParalela()) {
+        AplicacionAjuste aplicacion(configuracion);
+        asignar(resultado, operando(vectorA) + operando(vectorB));
+    }
+
+    // Producto escalar a . b acumulado en AcumuladorDe<T> (double también con float)
+    AcumuladorDe<T> productoEscalar() const {
+        return productoPunto(vista(vectorA), vista(vectorB));
+    }
+
+    // Producto escalar acumulado en el propio T, para medir lo que se pierde al
+    // no ampliar el acumulador
+    T productoEscalarSinAmpliar() const {
+        const T* a = vectorA.data();
+        const T* b = vectorB.data();
+        T suma = 0;
+        // Justificación: Misma reducción paralela y vectorial que productoPunto,
+        // pero con las sumas parciales en T
+        #pragma omp parallel for simd reduction(+:suma) schedule(static)
         for (size_t i = 0; i < tamano; ++i) {
-            resultado[i] = vectorA[i] + vectorB[i];
+            suma += a[i] * b[i];
+        }
+        return suma;
+    }
+
+    Vista<const T> obtenerResultado() const { return vista(resultado); }
+
+    // Mide el ancho de banda sostenible con los cuatro bucles de STREAM (copia,
+    // escala, suma y tríada) escritos como bucles parallel for simples sobre
+    // vectores propios del mismo tamaño. Devuelve el mejor valor en GB/s
+    double medirPicoStream() {
+        std::vector<double> a(tamano), b(tamano), c(tamano);
+        // Justificación: Primera escritura en paralelo con el mismo reparto
+        // estático que los bucles medidos (páginas en el nodo de cada hilo)
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < tamano; ++i) {
+            a[i] = 1.0;
+            b[i] = 2.0;
+            c[i] = 0.0;
+        }
+
+        const double s = 3.0;
+        const double bytes2 = 2.0 * sizeof(double) * tamano;
+        const double bytes3 = 3.0 * sizeof(double) * tamano;
+        double pico = 0.0;
+        std::cout << "Pico STREAM (mejor de " << REPETICIONES_ANCHO_BANDA << "):" << std::endl;
+        auto medir = [&](const char* nombre, double bytes, auto bucle) {
+            double mejor = medirMejor(bucle);
+            double gbs = bytes / mejor / 1e9;
+            pico = std::max(pico, gbs);
+            std::cout << "  " << std::left << std::setw(8) << nombre << std::right
+                      << std::fixed << std::setprecision(2) << gbs << " GB/s" << std::endl;
+        };
+        // Justificación (los cuatro bucles): iteraciones independientes con
+        // reparto estático, como en STREAM
+        medir("copia", bytes2, [&] {
+            #pragma omp parallel for schedule(static)
+            for (size_t i = 0; i < tamano; ++i) c[i] = a[i];
+        });
+        medir("escala", bytes2, [&] {
+            #pragma omp parallel for schedule(static)
+            for (size_t i = 0; i < tamano; ++i) b[i] = s * c[i];
+        });
+        medir("suma", bytes3, [&] {
+            #pragma omp parallel for schedule(static)
+            for (size_t i = 0; i < tamano; ++i) c[i] = a[i] + b[i];
+        });
+        medir("triada", bytes3, [&] {
+            #pragma omp parallel for schedule(static)
+            for (size_t i = 0; i < tamano; ++i) a[i] = b[i] + s * c[i];
+        });
+        std::cout << std::defaultfloat;
+        return pico;
+    }
+
+    // Mejor tiempo en segundos de REPETICIONES_ANCHO_BANDA ejecuciones; preparar
+    // se llama sin medir antes de cada una (restaura las entradas de los kernels
+    // que escriben sobre ellas)
+    template <typename Funcion, typename Preparacion>
+    static double medirMejor(Funcion funcion, Preparacion preparar) {
+        double mejor = 0.0;
+        for (int r = 0; r < REPETICIONES_ANCHO_BANDA; ++r) {
+            preparar();
+            auto inicio = std::chrono::high_resolution_clock::now();
+            funcion();
+            auto fin = std::chrono::high_resolution_clock::now();
+            double segundos = std::chrono::duration<double>(fin - inicio).count();
+            if (r == 0 || segundos < mejor) mejor = segundos;
         }
+        return mejor;
+    }
+
+    template <typename Funcion>
+    static double medirMejor(Funcion funcion) {
+        return medirMejor(funcion, [] {});
+    }
+
+    // Ejecuta los kernels BLAS-1 sobre los vectores del sumador, comprueba cada
+    // resultado contra la fórmula elemento a elemento y compara el ancho de banda
+    // obtenido (bytes leídos + escritos por el kernel) con el pico STREAM medido.
+    // Los stores no temporales no pagan read-for-ownership, así que un kernel
+    // puede superar el pico de los bucles STREAM, que usan stores normales
+    void ejecutarBlas() {
+        double pico = medirPicoStream();
+        std::cout << "Kernels (mejor de " << REPETICIONES_ANCHO_BANDA << ", "
+                  << "stores no temporales a partir de " << UMBRAL_STREAMING_BYTES / sizeof(T) << " elementos):" << std::endl;
+
+        const T alfa = T(0.5), beta = T(1.5), gamma = T(0.25);
+        const double bytesVector = static_cast<double>(sizeof(T) * tamano);
+        const VectorNuma<T>& a = vectorA;
+        const VectorNuma<T>& b = vectorB;
+        std::vector<T> y(tamano);
+        bool todoCorrecto = true;
+
+        auto informar = [&](const char* nombre, double vectoresMovidos, double segundos, bool correcto) {
+            double gbs = vectoresMovidos * bytesVector / segundos / 1e9;
+            todoCorrecto = todoCorrecto && correcto;
+            std::cout << "  " << std::left << std::setw(28) << nombre << std::right
+                      << std::fixed << std::setprecision(3) << std::setw(10) << segundos * 1e3 << " ms  "
+                      << std::setprecision(2) << std::setw(7) << gbs << " GB/s  "
+                      << std::setprecision(1) << std::setw(6) << 100.0 * gbs / pico << "% del pico  "
+                      << (correcto ? "correcto" : "INCORRECTO") << std::endl;
+        };
+        // Solo difieren por la contracción en FMA: unos pocos ulp de T
+        auto cercano = [](T obtenido, T esperado) {
+            const T tolerancia = 4096 * std::numeric_limits<T>::epsilon();
+            return std::abs(obtenido - esperado) <= tolerancia * std::max(T(1), std::abs(esperado));
+        };
+        auto comprobar = [&](const std::vector<T>& v, auto esperado) {
+            bool correcto = true;
+            for (size_t i = 0; i < tamano && correcto; ++i) correcto = cercano(v[i], esperado(i));
+            return correcto;
+        };
+        auto restaurarY = [&] { std::copy(b.begin(), b.end(), y.begin()); };
+
+        double segundos = medirMejor([&] { sumarParalelo(); });
+        informar("suma     c = a + b", 3, segundos, verificarResultado());
+
+        // Lee y escribe y: se restaura antes de cada repetición para comprobar una
+        // sola aplicación. Sin stores no temporales porque la expresión lee y
+        segundos = medirMejor([&] { axpy(alfa, vista(a), vista(y)); }, restaurarY);
+        informar("axpy     y = alfa*a + y", 3, segundos,
+                 comprobar(y, [&](size_t i) { return alfa * a[i] + b[i]; }));
+
+        segundos = medirMejor([&] { escalar(alfa, vista(y)); }, restaurarY);
+        informar("escala   y = alfa*y", 2, segundos, comprobar(y, [&](size_t i) { return alfa * b[i]; }));
+
+        segundos = medirMejor([&] { triada(vista(y), vista(a), alfa, vista(b)); });
+        informar("triada   y = a + alfa*b", 3, segundos,
+                 comprobar(y, [&](size_t i) { return a[i] + alfa * b[i]; }));
+
+        // Expresión fusionada: una sola pasada, sin temporales para alfa*a ni beta*b
+        segundos = medirMejor([&] { asignar(y, alfa * operando(a) + beta * operando(b) + gamma); });
+        informar("fusion   y = alfa*a+beta*b+c", 3, segundos,
+                 comprobar(y, [&](size_t i) { return alfa * a[i] + beta * b[i] + gamma; }));
+
+        // Las reducciones solo leen
+        double punto = 0.0;
+        segundos = medirMejor([&] { punto = productoEscalar(); });
+        double puntoReferencia = 0.0;
+        for (size_t i = 0; i < tamano; ++i) puntoReferencia += a[i] * b[i];
+        informar("punto    a . b", 2, segundos,
+                 std::abs(punto - puntoReferencia) <= 1e-9 * std::abs(puntoReferencia));
+
+        T valorNorma = 0;
+        segundos = medirMejor([&] { valorNorma = norma(vista(a)); });
+        double normaReferencia = 0.0;
+        for (size_t i = 0; i < tamano; ++i) normaReferencia += a[i] * a[i];
+        normaReferencia = std::sqrt(normaReferencia);
+        informar("norma    ||a||", 2, segundos, std::abs(valorNorma - normaReferencia) <= 1e-9 * normaReferencia);
+
+        std::cout << std::defaultfloat;
+        std::cout << "Resultados correctos: " << (todoCorrecto ? "Sí" : "No") << std::endl;
     }
 
     // Verifica si el resultado de la suma paralela es correcto
     bool verificarResultado() {
-        std::vector<double> resultadoSecuencial(tamano);
+        std::vector<T> resultadoSecuencial(tamano);
         for (size_t i = 0; i < tamano; ++i) {
             resultadoSecuencial[i] = vectorA[i] + vectorB[i];
         }
         //std::cout << "suma secuencial = " << resultadoSecuencial << " | " << resultado << " = suma paralela" << std::endl;
-        return resultadoSecuencial == resultado;
+        return std::equal(resultadoSecuencial.begin(), resultadoSecuencial.end(), resultado.begin());
     }
 
-    // Ejecuta y mide el tiempo de las versiones secuencial y paralela
-    void ejecutar() {
-        auto inicio = std::chrono::high_resolution_clock::now();
-        sumarSecuencial();
-        auto fin = std::chrono::high_resolution_clock::now();
-        auto duracionSecuencial = std::chrono::duration_cast<std::chrono::microseconds>(fin - inicio).count();
-
-        inicio = std::chrono::high_resolution_clock::now();
-        sumarParalelo();
-        fin = std::chrono::high_resolution_clock::now();
-        auto duracionParalelo = std::chrono::duration_cast<std::chrono::microseconds>(fin - inicio).count();
-
+    // Mide las versiones secuencial y paralela con el arnés común; con --barrido
+    // añade el escalado fuerte y el débil (vector proporcional a los hilos)
+    bool ejecutar(const OpcionesMedicion& opciones) {
         std::cout << "Tamaño del vector: " << tamano << std::endl;
-        std::cout << "Tiempo de ejecución (secuencial): " << duracionSecuencial << " microsegundos" << std::endl;
-        std::cout << "Tiempo de ejecución (paralelo): " << duracionParalelo << " microsegundos" << std::endl;
-        std::cout << "Aceleración: " << static_cast<double>(duracionSecuencial) / duracionParalelo << "x" << std::endl;
+        // La suma satura el ancho de banda de memoria antes de usar todos los
+        // hilos: el ajuste busca cuántos usar (asignar reparte con schedule(static))
+        AjustadorParalelo ajustador("suma_vectores", opciones);
+        const ConfiguracionParalela ajustada = ajustador.configurar(
+            "paralelo", tamano, EspacioAjuste::soloHilos(),
+            [&](const ConfiguracionParalela& configuracion) { sumarParalelo(configuracion); });
+        ArnesMedicion arnes("suma_vectores", opciones);
+        arnes.registrar("secuencial", tamano, [&] { sumarSecuencial(); });
+        arnes.registrarParalelo("paralelo", tamano, [&] { sumarParalelo(); });
+        if (!ajustada.porDefecto()) {
+            arnes.registrarParalelo("paralelo ajustado", tamano, [&] { sumarParalelo(ajustada); });
+        }
+        const size_t porHilo = std::max<size_t>(tamano / omp_get_max_threads(), 1);
+        const uint64_t semilla = opciones.semilla;
+        arnes.registrarEscaladoDebil("paralelo", porHilo, [porHilo, semilla](int hilos) {
+            auto sumador = std::make_shared<SumadorVectores>(porHilo * hilos, semilla);
+            return [sumador] { sumador->sumarParalelo(); };
+        });
+        // Lee a y b y escribe c: tres elementos y una suma por elemento
+        const double bytes = 3.0 * sizeof(T) * tamano;
+        arnes.asignarCarga("secuencial", bytes, static_cast<double>(tamano));
+        arnes.asignarCarga("paralelo", bytes, static_cast<double>(tamano));
+        arnes.asignarCarga("paralelo ajustado", bytes, static_cast<double>(tamano));
+        bool escrito = arnes.ejecutar();
         std::cout << "Resultado correcto: " << (verificarResultado() ? "Sí" : "No") << std::endl;
+        return escrito;
     }
 };
 
-int main() {
+// Modo "precision": suma y producto escalar con double y con float sobre los
+// mismos datos (los de float son los de double redondeados), y el error de
+// cada variante de float respecto a double. La suma está limitada por memoria,
+// así que con float debería acercarse a la mitad de tiempo; el producto
+// escalar acumulado en float pierde precisión al crecer la suma parcial
+bool ejecutarPrecision(size_t tamano, const OpcionesMedicion& opciones) {
+    SumadorVectores<double> doble(tamano, opciones.semilla);
+    SumadorVectores<float> simple(tamano, opciones.semilla);
+    double puntoDoble = 0.0, puntoSimple = 0.0;
+    float puntoSinAmpliar = 0.0f;
+
+    std::cout << "Tamaño del vector: " << tamano << std::endl;
+    ArnesMedicion arnes("suma_vectores_precision", opciones);
+    arnes.registrarParalelo("suma double", tamano, [&] { doble.sumarParalelo(); });
+    arnes.registrarParalelo("suma float", tamano, [&] { simple.sumarParalelo(); });
+    arnes.registrarParalelo("punto double", tamano, [&] { puntoDoble = doble.productoEscalar(); });
+    arnes.registrarParalelo("punto float (acum. double)", tamano, [&] { puntoSimple = simple.productoEscalar(); });
+    arnes.registrarParalelo("punto float (acum. float)", tamano,
+                            [&] { puntoSinAmpliar = simple.productoEscalarSinAmpliar(); });
+    arnes.asignarCarga("suma double", 3.0 * sizeof(double) * tamano, static_cast<double>(tamano));
+    arnes.asignarCarga("suma float", 3.0 * sizeof(float) * tamano, static_cast<double>(tamano));
+    arnes.asignarCarga("punto double", 2.0 * sizeof(double) * tamano, 2.0 * tamano);
+    arnes.asignarCarga("punto float (acum. double)", 2.0 * sizeof(float) * tamano, 2.0 * tamano);
+    arnes.asignarCarga("punto float (acum. float)", 2.0 * sizeof(float) * tamano, 2.0 * tamano);
+    bool escrito = arnes.ejecutar();
+
+    // Error relativo máximo de la suma en float respecto a la de double
+    Vista<const double> sumaDoble = doble.obtenerResultado();
+    Vista<const float> sumaSimple = simple.obtenerResultado();
+    double errorSuma = 0.0;
+    for (size_t i = 0; i < tamano; ++i) {
+        if (sumaDoble[i] != 0.0) errorSuma = std::max(errorSuma, std::abs(sumaSimple[i] - sumaDoble[i]) / sumaDoble[i]);
+    }
+    auto errorPunto = [&](double valor) { return std::abs(valor - puntoDoble) / std::abs(puntoDoble); };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Aceleración de float respecto a double:" << std::endl;
+    std::cout << "  suma:                      "
+              << cocienteTiempos(arnes.mediana("suma double"), arnes.mediana("suma float")) << "x" << std::endl;
+    std::cout << "  punto (acum. double):      "
+              << cocienteTiempos(arnes.mediana("punto double"), arnes.mediana("punto float (acum. double)")) << "x"
+              << std::endl;
+    std::cout << "  punto (acum. float):       "
+              << cocienteTiempos(arnes.mediana("punto double"), arnes.mediana("punto float (acum. float)")) << "x"
+              << std::endl;
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "Error relativo respecto a double (épsilon de float: "
+              << std::numeric_limits<float>::epsilon() << "):" << std::endl;
+    std::cout << "  suma (máximo por elemento): " << errorSuma << std::endl;
+    std::cout << "  punto (acum. double):       " << errorPunto(puntoSimple) << std::endl;
+    std::cout << "  punto (acum. float):        " << errorPunto(puntoSinAmpliar) << std::endl;
+    std::cout << std::defaultfloat;
+    return escrito;
+}
+
+int main(int argc, char* argv[]) {
     const size_t TAMANO_VECTOR = 10000000;
-    SumadorVectores sumador(TAMANO_VECTOR);
-    sumador.ejecutar();
+
+    OpcionesMedicion opciones;
+    if (!extraerOpcionesMedicion(argc, argv, opciones)) return 1;
+    std::string modo = argc > 1 ? argv[1] : "";
+    if (!modo.empty() && modo != "blas" && modo != "precision") {
+        std::cerr << "Uso: " << argv[0] << " [blas|precision] [--calentamiento N] [--repeticiones N] [--barrido] "
+                  << "[--json archivo] [--csv archivo] [--semilla N]" << std::endl;
+        return 1;
+    }
+
+    if (modo == "precision") {
+        return ejecutarPrecision(TAMANO_VECTOR, opciones) ? 0 : 1;
+    }
+
+    SumadorVectores<double> sumador(TAMANO_VECTOR, opciones.semilla);
+    if (modo == "blas") {
+        sumador.ejecutarBlas();
+    } else {
+        return sumador.ejecutar(opciones) ? 0 : 1;
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,411 @@
+// Herramienta OMPT de trazado: biblioteca compartida que el runtime de OpenMP
+// carga con OMP_TOOL_LIBRARIES. Registra por hilo las regiones paralelas, las
+// tareas (creación, planificación y finalización), las esperas en barreras,
+// taskwait y taskgroup, y los bucles y fragmentos repartidos. Al terminar el
+// programa escribe la traza en formato Chrome (chrome://tracing o Perfetto) y un
+// resumen con el tiempo ocioso por hilo, los recuentos de tareas y la
+// distribución de su granularidad.
+//
+// Variables de entorno:
+//   TRAZA_OMPT_ARCHIVO   archivo de salida (por defecto traza_ompt.json)
+//   TRAZA_OMPT_EVENTOS   capacidad del buffer circular de cada hilo (por defecto 262144)
+//
+// Requiere un runtime con OMPT (LLVM libomp o Intel); libgomp no lo implementa.
+
+#if __has_include(<omp-tools.h>)
+#include <omp-tools.h>
+#else
+#error "traza_ompt necesita omp-tools.h (runtime de OpenMP de LLVM o Intel)"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace {
+
+// Tipos de evento guardados en los buffers. Los pares inicio/fin se emparejan al
+// exportar; los fragmentos de bucle y las creaciones de tareas son instantáneos
+enum TipoEvento : uint32_t {
+    EVENTO_PARALELO_INICIO,
+    EVENTO_PARALELO_FIN,
+    EVENTO_IMPLICITA_INICIO,
+    EVENTO_IMPLICITA_FIN,
+    EVENTO_TAREA_CREADA,
+    EVENTO_TAREA_INICIO,
+    EVENTO_TAREA_FIN,
+    EVENTO_ESPERA_INICIO,
+    EVENTO_ESPERA_FIN,
+    EVENTO_BUCLE_INICIO,
+    EVENTO_BUCLE_FIN,
+    EVENTO_FRAGMENTO
+};
+
+struct Evento {
+    uint64_t tiempo;   // ns desde la inicialización de la herramienta
+    uint64_t dato;     // id de tarea o región, primera iteración del fragmento...
+    uint32_t tipo;
+    uint32_t extra;    // tipo de espera o de bucle, estado de la tarea...
+};
+
+// Cubetas log2 de la duración exclusiva de las tareas: [0] < 1 µs, [i] en
+// [2^(i-1), 2^i) µs
+const int CUBETAS_GRANULARIDAD = 24;
+
+// Estado de un hilo. Solo lo escribe su propio hilo; el registro global es una
+// lista enlazada en la que se inserta con compare_exchange y que solo se recorre
+// en la finalización, cuando los hilos del runtime ya no generan eventos
+struct BufferHilo {
+    uint32_t indice = 0;
+    uint64_t escritos = 0;
+    std::vector<Evento> eventos;
+    BufferHilo* siguiente = nullptr;
+
+    // Estadísticas calculadas en línea: no dependen de que el buffer circular
+    // conserve todos los eventos
+    uint64_t tareasCreadas = 0;
+    uint64_t tareasEjecutadas = 0;
+    uint64_t fragmentos = 0;
+    uint64_t tiempoTareas = 0;          // ns ejecutando tareas explícitas
+    uint64_t tiempoEspera = 0;          // ns en barreras, taskwait y taskgroup
+    uint64_t tiempoTareasEnEspera = 0;  // ns de tareas ejecutadas dentro de una espera
+    uint64_t inicioEspera = 0;
+    int nivelEspera = 0;
+    uint64_t granularidad[CUBETAS_GRANULARIDAD] = {};
+    uint64_t siguienteTarea = 0;
+
+    void registrar(TipoEvento tipo, uint64_t tiempo, uint64_t dato, uint32_t extra) {
+        eventos[escritos % eventos.size()] = Evento{tiempo, dato, static_cast<uint32_t>(tipo), extra};
+        ++escritos;
+    }
+};
+
+// Datos que viajan con cada tarea explícita en su ompt_data_t
+struct DatosTarea {
+    uint64_t id;
+    uint64_t inicioTramo;   // inicio del tramo de ejecución actual
+    uint64_t acumulado;     // tiempo exclusivo de los tramos anteriores
+};
+
+std::atomic<BufferHilo*> listaBuffers{nullptr};
+std::atomic<uint32_t> siguienteIndice{0};
+size_t capacidadBuffer = 1 << 18;
+std::chrono::steady_clock::time_point origen;
+thread_local BufferHilo* bufferLocal = nullptr;
+
+ompt_set_callback_t establecerCallback = nullptr;
+
+uint64_t ahora() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - origen).count());
+}
+
+BufferHilo* buffer() {
+    if (bufferLocal) return bufferLocal;
+    BufferHilo* b = new BufferHilo();
+    b->indice = siguienteIndice.fetch_add(1, std::memory_order_relaxed);
+    b->eventos.resize(capacidadBuffer);
+    BufferHilo* cabeza = listaBuffers.load(std::memory_order_relaxed);
+    do {
+        b->siguiente = cabeza;
+    } while (!listaBuffers.compare_exchange_weak(cabeza, b, std::memory_order_release, std::memory_order_relaxed));
+    bufferLocal = b;
+    return b;
+}
+
+int cubetaGranularidad(uint64_t ns) {
+    uint64_t us = ns / 1000;
+    int cubeta = 0;
+    while (us > 0 && cubeta < CUBETAS_GRANULARIDAD - 1) {
+        us >>= 1;
+        ++cubeta;
+    }
+    return cubeta;
+}
+
+// Cierra el tramo de ejecución de una tarea en el hilo actual
+void cerrarTramo(BufferHilo* b, DatosTarea* tarea, uint64_t t, bool completada, uint32_t estado) {
+    uint64_t tramo = t - tarea->inicioTramo;
+    tarea->acumulado += tramo;
+    b->tiempoTareas += tramo;
+    if (b->nivelEspera > 0) b->tiempoTareasEnEspera += tramo;
+    b->registrar(EVENTO_TAREA_FIN, t, tarea->id, estado);
+    if (completada) {
+        ++b->tareasEjecutadas;
+        ++b->granularidad[cubetaGranularidad(tarea->acumulado)];
+        delete tarea;
+    }
+}
+
+// ---- Callbacks OMPT ----
+
+void alIniciarHilo(ompt_thread_t, ompt_data_t* datosHilo) {
+    datosHilo->ptr = buffer();
+}
+
+void alIniciarParalelo(ompt_data_t*, const ompt_frame_t*, ompt_data_t* datosRegion,
+                       unsigned int hilosPedidos, int, const void*) {
+    static std::atomic<uint64_t> siguienteRegion{1};
+    datosRegion->value = siguienteRegion.fetch_add(1, std::memory_order_relaxed);
+    buffer()->registrar(EVENTO_PARALELO_INICIO, ahora(), datosRegion->value, hilosPedidos);
+}
+
+void alTerminarParalelo(ompt_data_t* datosRegion, ompt_data_t*, int, const void*) {
+    buffer()->registrar(EVENTO_PARALELO_FIN, ahora(), datosRegion->value, 0);
+}
+
+void alTareaImplicita(ompt_scope_endpoint_t extremo, ompt_data_t*, ompt_data_t*,
+                      unsigned int hilosReales, unsigned int indice, int) {
+    BufferHilo* b = buffer();
+    b->registrar(extremo == ompt_scope_begin ? EVENTO_IMPLICITA_INICIO : EVENTO_IMPLICITA_FIN,
+                 ahora(), indice, hilosReales);
+}
+
+void alCrearTarea(ompt_data_t*, const ompt_frame_t*, ompt_data_t* datosTarea, int banderas, int, const void*) {
+    datosTarea->ptr = nullptr;
+    if (!(banderas & ompt_task_explicit)) return;
+    BufferHilo* b = buffer();
+    // Identificador único sin contención: índice de hilo en los 24 bits altos
+    uint64_t id = (static_cast<uint64_t>(b->indice) << 40) | ++b->siguienteTarea;
+    datosTarea->ptr = new DatosTarea{id, 0, 0};
+    ++b->tareasCreadas;
+    b->registrar(EVENTO_TAREA_CREADA, ahora(), id, 0);
+}
+
+void alPlanificarTarea(ompt_data_t* anterior, ompt_task_status_t estado, ompt_data_t* siguiente) {
+    BufferHilo* b = buffer();
+    uint64_t t = ahora();
+    if (anterior && anterior->ptr) {
+        bool completada = estado == ompt_task_complete || estado == ompt_task_cancel ||
+                          estado == ompt_task_late_fulfill;
+        DatosTarea* tarea = static_cast<DatosTarea*>(anterior->ptr);
+        if (completada) anterior->ptr = nullptr;
+        cerrarTramo(b, tarea, t, completada, static_cast<uint32_t>(estado));
+    }
+    if (siguiente && siguiente->ptr) {
+        DatosTarea* tarea = static_cast<DatosTarea*>(siguiente->ptr);
+        tarea->inicioTramo = t;
+        b->registrar(EVENTO_TAREA_INICIO, t, tarea->id, 0);
+    }
+}
+
+void alEsperar(ompt_sync_region_t tipo, ompt_scope_endpoint_t extremo, ompt_data_t*, ompt_data_t*, const void*) {
+    BufferHilo* b = buffer();
+    uint64_t t = ahora();
+    if (extremo == ompt_scope_begin) {
+        if (b->nivelEspera++ == 0) b->inicioEspera = t;
+        b->registrar(EVENTO_ESPERA_INICIO, t, 0, static_cast<uint32_t>(tipo));
+    } else {
+        if (b->nivelEspera > 0 && --b->nivelEspera == 0) b->tiempoEspera += t - b->inicioEspera;
+        b->registrar(EVENTO_ESPERA_FIN, t, 0, static_cast<uint32_t>(tipo));
+    }
+}
+
+void alRepartir(ompt_work_t tipo, ompt_scope_endpoint_t extremo, ompt_data_t*, ompt_data_t*,
+                uint64_t iteraciones, const void*) {
+    buffer()->registrar(extremo == ompt_scope_begin ? EVENTO_BUCLE_INICIO : EVENTO_BUCLE_FIN,
+                        ahora(), iteraciones, static_cast<uint32_t>(tipo));
+}
+
+void alDespachar(ompt_data_t*, ompt_data_t*, ompt_dispatch_t tipo, ompt_data_t instancia) {
+    BufferHilo* b = buffer();
+    ++b->fragmentos;
+    b->registrar(EVENTO_FRAGMENTO, ahora(), instancia.value, static_cast<uint32_t>(tipo));
+}
+
+// ---- Exportación ----
+
+const char* nombreEspera(uint32_t tipo) {
+    switch (tipo) {
+        case ompt_sync_region_taskwait: return "taskwait";
+        case ompt_sync_region_taskgroup: return "taskgroup";
+        case ompt_sync_region_reduction: return "reducción";
+        default: return "barrera";
+    }
+}
+
+const char* nombreBucle(uint32_t tipo) {
+    switch (tipo) {
+        case ompt_work_loop: return "bucle";
+        case ompt_work_sections: return "sections";
+        case ompt_work_single_executor: return "single";
+        case ompt_work_single_other: return "single (espera)";
+        case ompt_work_taskloop: return "taskloop";
+        default: return "reparto";
+    }
+}
+
+// Evento completo de Chrome ("X"): inicio y duración en microsegundos
+void escribirCompleto(FILE* f, bool& primero, uint32_t hilo, const char* nombre, const char* categoria,
+                      uint64_t inicio, uint64_t fin, uint64_t id) {
+    std::fprintf(f, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32
+                    ",\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"id\":%" PRIu64 "}}",
+                 primero ? "" : ",", nombre, categoria, hilo, inicio / 1e3, (fin - inicio) / 1e3, id);
+    primero = false;
+}
+
+// Empareja los inicios y fines de un hilo y los escribe como eventos completos.
+// Las tareas se emparejan por id (una tarea suspendida en un taskwait puede
+// ceder el hilo a otras antes de volver); el resto, como pila por tipo. Si el
+// buffer circular se desbordó, los fines sin inicio se descartan
+void exportarHilo(FILE* f, bool& primero, const BufferHilo& b) {
+    const size_t capacidad = b.eventos.size();
+    const uint64_t desde = b.escritos > capacidad ? b.escritos - capacidad : 0;
+    std::vector<Evento> pilaParalelo, pilaImplicita, pilaEspera, pilaBucle;
+    std::map<uint64_t, uint64_t> tareasAbiertas;
+
+    auto cerrar = [&](std::vector<Evento>& pila, const Evento& fin, const char* nombre, const char* categoria) {
+        if (pila.empty()) return;
+        Evento inicio = pila.back();
+        pila.pop_back();
+        escribirCompleto(f, primero, b.indice, nombre, categoria, inicio.tiempo, fin.tiempo, inicio.dato);
+    };
+
+    for (uint64_t i = desde; i < b.escritos; ++i) {
+        const Evento& e = b.eventos[i % capacidad];
+        switch (e.tipo) {
+            case EVENTO_PARALELO_INICIO: pilaParalelo.push_back(e); break;
+            case EVENTO_PARALELO_FIN: cerrar(pilaParalelo, e, "región paralela", "paralelo"); break;
+            case EVENTO_IMPLICITA_INICIO: pilaImplicita.push_back(e); break;
+            case EVENTO_IMPLICITA_FIN: cerrar(pilaImplicita, e, "tarea implícita", "paralelo"); break;
+            case EVENTO_ESPERA_INICIO: pilaEspera.push_back(e); break;
+            case EVENTO_ESPERA_FIN: cerrar(pilaEspera, e, nombreEspera(e.extra), "espera"); break;
+            case EVENTO_BUCLE_INICIO: pilaBucle.push_back(e); break;
+            case EVENTO_BUCLE_FIN:
+                if (!pilaBucle.empty()) cerrar(pilaBucle, e, nombreBucle(pilaBucle.back().extra), "reparto");
+                break;
+            case EVENTO_TAREA_INICIO: tareasAbiertas[e.dato] = e.tiempo; break;
+            case EVENTO_TAREA_FIN: {
+                auto it = tareasAbiertas.find(e.dato);
+                if (it != tareasAbiertas.end()) {
+                    escribirCompleto(f, primero, b.indice, "tarea", "tarea", it->second, e.tiempo, e.dato);
+                    tareasAbiertas.erase(it);
+                }
+                break;
+            }
+            case EVENTO_TAREA_CREADA:
+            case EVENTO_FRAGMENTO:
+                std::fprintf(f, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%" PRIu32
+                                ",\"ts\":%.3f,\"args\":{\"%s\":%" PRIu64 "}}",
+                             primero ? "" : ",", e.tipo == EVENTO_TAREA_CREADA ? "crear tarea" : "fragmento",
+                             e.tipo == EVENTO_TAREA_CREADA ? "tarea" : "reparto", b.indice, e.tiempo / 1e3,
+                             e.tipo == EVENTO_TAREA_CREADA ? "id" : "iteracion", e.dato);
+                primero = false;
+                break;
+        }
+    }
+}
+
+void imprimirResumen(const std::vector<const BufferHilo*>& hilos, uint64_t duracion) {
+    uint64_t creadas = 0, ejecutadas = 0, descartados = 0;
+    uint64_t granularidad[CUBETAS_GRANULARIDAD] = {};
+    std::fprintf(stderr, "Resumen de la traza OMPT (%zu hilos, %.3f ms):\n", hilos.size(), duracion / 1e6);
+    std::fprintf(stderr, "  %5s %10s %10s %12s %12s %9s\n", "hilo", "tareas", "fragmentos",
+                 "tareas ms", "ocioso ms", "ocioso %");
+    for (const BufferHilo* b : hilos) {
+        // Tiempo ocioso: esperas en barreras, taskwait y taskgroup menos el tiempo
+        // que el hilo pasó ejecutando tareas dentro de ellas
+        uint64_t ocioso = b->tiempoEspera > b->tiempoTareasEnEspera ? b->tiempoEspera - b->tiempoTareasEnEspera : 0;
+        std::fprintf(stderr, "  %5" PRIu32 " %10" PRIu64 " %10" PRIu64 " %12.3f %12.3f %8.1f%%\n",
+                     b->indice, b->tareasEjecutadas, b->fragmentos, b->tiempoTareas / 1e6, ocioso / 1e6,
+                     duracion > 0 ? 100.0 * ocioso / duracion : 0.0);
+        creadas += b->tareasCreadas;
+        ejecutadas += b->tareasEjecutadas;
+        if (b->escritos > b->eventos.size()) descartados += b->escritos - b->eventos.size();
+        for (int i = 0; i < CUBETAS_GRANULARIDAD; ++i) granularidad[i] += b->granularidad[i];
+    }
+    std::fprintf(stderr, "  Tareas creadas: %" PRIu64 ", ejecutadas: %" PRIu64 "\n", creadas, ejecutadas);
+    if (ejecutadas > 0) {
+        std::fprintf(stderr, "  Granularidad de las tareas (tiempo exclusivo):\n");
+        for (int i = 0; i < CUBETAS_GRANULARIDAD; ++i) {
+            if (granularidad[i] == 0) continue;
+            char etiqueta[32];
+            if (i == 0) {
+                std::snprintf(etiqueta, sizeof(etiqueta), "< 1");
+            } else {
+                std::snprintf(etiqueta, sizeof(etiqueta), "%" PRIu64 "-%" PRIu64,
+                              uint64_t(1) << (i - 1), uint64_t(1) << i);
+            }
+            std::fprintf(stderr, "    %15s us: %10" PRIu64 " (%5.1f%%)\n", etiqueta, granularidad[i],
+                         100.0 * granularidad[i] / ejecutadas);
+        }
+    }
+    if (descartados > 0) {
+        std::fprintf(stderr, "  Eventos sobrescritos en los buffers circulares: %" PRIu64
+                             " (aumente TRAZA_OMPT_EVENTOS)\n", descartados);
+    }
+}
+
+// ---- Inicialización y finalización ----
+
+template <typename Callback>
+void registrarCallback(ompt_callbacks_t evento, Callback funcion) {
+    // Los callbacks que el runtime no implementa (p. ej. dispatch en versiones
+    // antiguas) simplemente no se reciben
+    establecerCallback(evento, reinterpret_cast<ompt_callback_t>(funcion));
+}
+
+int inicializar(ompt_function_lookup_t buscar, int, ompt_data_t*) {
+    origen = std::chrono::steady_clock::now();
+    if (const char* eventos = std::getenv("TRAZA_OMPT_EVENTOS")) {
+        unsigned long long valor = std::strtoull(eventos, nullptr, 10);
+        if (valor > 0) capacidadBuffer = static_cast<size_t>(valor);
+    }
+    establecerCallback = reinterpret_cast<ompt_set_callback_t>(buscar("ompt_set_callback"));
+    if (!establecerCallback) return 0;
+
+    registrarCallback(ompt_callback_thread_begin, &alIniciarHilo);
+    registrarCallback(ompt_callback_parallel_begin, &alIniciarParalelo);
+    registrarCallback(ompt_callback_parallel_end, &alTerminarParalelo);
+    registrarCallback(ompt_callback_implicit_task, &alTareaImplicita);
+    registrarCallback(ompt_callback_task_create, &alCrearTarea);
+    registrarCallback(ompt_callback_task_schedule, &alPlanificarTarea);
+    registrarCallback(ompt_callback_sync_region_wait, &alEsperar);
+    registrarCallback(ompt_callback_work, &alRepartir);
+    registrarCallback(ompt_callback_dispatch, &alDespachar);
+    buffer();
+    return 1;  // distinto de 0: la herramienta queda activa
+}
+
+void finalizar(ompt_data_t*) {
+    uint64_t duracion = ahora();
+    std::vector<const BufferHilo*> hilos;
+    for (BufferHilo* b = listaBuffers.load(std::memory_order_acquire); b; b = b->siguiente) hilos.push_back(b);
+    std::vector<const BufferHilo*> ordenados(hilos.size());
+    for (const BufferHilo* b : hilos) ordenados[b->indice] = b;
+
+    const char* ruta = std::getenv("TRAZA_OMPT_ARCHIVO");
+    if (!ruta) ruta = "traza_ompt.json";
+    FILE* f = std::fopen(ruta, "w");
+    if (!f) {
+        std::fprintf(stderr, "traza_ompt: no se pudo abrir %s: %s\n", ruta, std::strerror(errno));
+    } else {
+        std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        bool primero = true;
+        for (const BufferHilo* b : ordenados) {
+            std::fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu32
+                            ",\"args\":{\"name\":\"hilo %" PRIu32 "\"}}", primero ? "" : ",", b->indice, b->indice);
+            primero = false;
+            exportarHilo(f, primero, *b);
+        }
+        std::fprintf(f, "\n]}\n");
+        std::fclose(f);
+        std::fprintf(stderr, "traza_ompt: traza escrita en %s\n", ruta);
+    }
+    imprimirResumen(ordenados, duracion);
+}
+
+}  // namespace
+
+// Punto de entrada que busca el runtime al cargar la herramienta
+extern "C" ompt_start_tool_result_t* ompt_start_tool(unsigned int, const char*) {
+    static ompt_start_tool_result_t resultado = {&inicializar, &finalizar, {0}};
+    return &resultado;
+}